@@ -0,0 +1,93 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  DeferredActions.hpp
+ *  @brief Queue of population changes requested by organisms running on worker threads.
+ *  @note Status: ALPHA
+ *
+ *  While organisms are executed in parallel (e.g., by SchedulerProbabilistic in "parallel"
+ *  mode), nothing may change the population.  Each worker thread activates its own
+ *  DeferredActions object; instructions that would otherwise act on the population (births,
+ *  etc.) should check GetActive() and, if it is set, Add() a function to carry out that action
+ *  once the time slice is over.  The scheduler then runs all queued actions on a single thread,
+ *  in a deterministic order.
+ *
+ *  Instructions that need random numbers should use GetRandom(), which gives each organism its
+ *  own stream during a time slice so that results do not depend on how organisms are divided
+ *  among threads.
+ */
+
+#ifndef MABE_DEFERRED_ACTIONS_HPP
+#define MABE_DEFERRED_ACTIONS_HPP
+
+#include <cstdint>
+#include <functional>
+
+#include "emp/base/Ptr.hpp"
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+
+#include "Organism.hpp"
+
+namespace mabe {
+
+  class DeferredActions {
+  public:
+    using action_fun_t = std::function<void(Organism &)>;
+
+    struct Action {
+      size_t org_pos;     ///< Position of the organism that requested this action.
+      action_fun_t fun;   ///< Action to run (given that organism) once the time slice is over.
+    };
+
+  private:
+    emp::vector<Action> actions;           ///< Actions queued during the current time slice.
+    size_t cur_pos = 0;                    ///< Position of the organism currently running.
+    uint64_t slice_seed = 0;               ///< Seed for the current time slice.
+    emp::Random random;                    ///< Random number stream for the current organism.
+    size_t random_pos = emp::MAX_SIZE_T;   ///< Position that random is currently seeded for.
+
+    static inline thread_local emp::Ptr<DeferredActions> active = nullptr;
+
+  public:
+    /// Get the actions object for the current thread (nullptr if actions should happen now).
+    static emp::Ptr<DeferredActions> GetActive() { return active; }
+
+    /// Get the random number generator that the current thread should use.
+    static emp::Random & GetRandom(emp::Random & main_random) {
+      if (!active) return main_random;
+      if (active->random_pos != active->cur_pos) {
+        // Mix the slice seed and position into a positive seed (non-positive seeds use time).
+        uint64_t seed = active->slice_seed ^ (active->cur_pos * 0x9e3779b97f4a7c15);
+        seed ^= seed >> 31;
+        active->random.ResetSeed(static_cast<int>(seed % 2000000000) + 1);
+        active->random_pos = active->cur_pos;
+      }
+      return active->random;
+    }
+
+    /// Begin a new time slice on the current thread.
+    void Start(uint64_t _seed) {
+      actions.resize(0);
+      slice_seed = _seed;
+      random_pos = emp::MAX_SIZE_T;
+      active = this;
+    }
+
+    /// End the time slice; actions now happen immediately on this thread again.
+    void Stop() { active = nullptr; }
+
+    /// Identify the organism about to be run.
+    void SetOrgPos(size_t pos) { cur_pos = pos; }
+
+    /// Queue an action on behalf of the organism currently running.
+    void Add(action_fun_t fun) { actions.push_back(Action{cur_pos, std::move(fun)}); }
+
+    emp::vector<Action> & GetActions() { return actions; }
+  };
+
+}
+
+#endif
@@ -5,27 +5,214 @@
  *
  *  @file  EvalModule.hpp
  *  @brief A module base class to simplify the creation of evaluation modules.
+ *
+ *  Evaluation modules that always produce the same results for the same inputs can declare
+ *  themselves deterministic by overriding IsDeterministic().  They are then given a
+ *  "cache_size" config option and can hold EvalCache members to reuse results for organisms
+ *  with identical inputs (e.g., clones in low-mutation runs).  Each cache is a bounded,
+ *  least-recently-used table keyed by a hash of the input trait; the full input is stored as
+ *  well, so a hash collision simply counts as a miss.  Config settings that results depend on
+ *  are not part of the key; modules should pass them to CheckCacheConfig() before evaluating,
+ *  which clears the caches whenever one of them is changed.
+ *
+ *  Only cache when scoring an organism costs clearly more than hashing, comparing, and copying
+ *  its input (e.g., NK, Packing, Sudoku).  Evaluators that make a single cheap pass over the
+ *  input (e.g., RoyalRoad, Diagnostics) are left uncached.
  */
 
 #ifndef MABE_EVAL_MODULE_H
 #define MABE_EVAL_MODULE_H
 
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <span>
+#include <unordered_map>
+
 #include "emp/base/notify.hpp"
+#include "emp/base/Ptr.hpp"
+#include "emp/base/vector.hpp"
+#include "emp/bits/BitVector.hpp"
 
 #include "MABE.hpp"
 #include "Module.hpp"
 
 namespace mabe {
 
+  class EvalModuleBase;
+
+  /// Hash and compare evaluation inputs; specialized for each type of input trait supported.
+  template <typename INPUT_T> struct EvalInputKey;
+
+  template <> struct EvalInputKey<emp::BitVector> {
+    using view_t = const emp::BitVector &;
+    static size_t Hash(view_t bits) { return std::hash<emp::BitVector>()(bits); }
+    static bool Equal(const emp::BitVector & stored, view_t bits) { return stored == bits; }
+    static emp::BitVector Copy(view_t bits) { return bits; }
+  };
+
+  template <typename T> struct EvalInputKey<emp::vector<T>> {
+    using view_t = std::span<const T>;
+    static size_t Hash(view_t vals) {
+      size_t hash = vals.size();
+      for (const T & val : vals) {
+        hash ^= std::hash<T>()(val) + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+      }
+      return hash;
+    }
+    static bool Equal(const emp::vector<T> & stored, view_t vals) {
+      return std::equal(stored.begin(), stored.end(), vals.begin(), vals.end());
+    }
+    static emp::vector<T> Copy(view_t vals) { return emp::vector<T>(vals.begin(), vals.end()); }
+  };
+
+  /// Type-independent interface so that an EvalModule can manage all of its caches.
+  class EvalCacheBase {
+  protected:
+    emp::Ptr<EvalModuleBase> mod_ptr;
+    size_t hits = 0;
+    size_t misses = 0;
+
+  public:
+    EvalCacheBase(emp::Ptr<EvalModuleBase> _mod_ptr);
+    EvalCacheBase(const EvalCacheBase &) = delete;
+    virtual ~EvalCacheBase() { }
+
+    size_t GetHits() const { return hits; }
+    size_t GetMisses() const { return misses; }
+
+    virtual size_t GetSize() const = 0;
+    virtual void Clear() = 0;
+  };
+
+  /// Non-templated base for all evaluation modules.
+  class EvalModuleBase : public Module {
+  protected:
+    size_t cache_size = 0;                        ///< Max results for each cache (0 = off)
+    emp::vector<emp::Ptr<EvalCacheBase>> caches;  ///< All caches used by this module.
+    emp::String cache_config;                     ///< Config values that cached results used.
+
+    /// Clear all caches if any of the provided config values have changed since the last call.
+    /// Modules whose results depend on config settings that can be changed during a run should
+    /// call this (with those settings) at the start of each evaluation.
+    template <typename... Ts>
+    void CheckCacheConfig(const Ts &... config_vals) {
+      emp::String cur_config;
+      ((cur_config += emp::MakeString(config_vals, ';')), ...);
+      if (cur_config != cache_config) {
+        ClearEvalCache();
+        cache_config = cur_config;
+      }
+    }
+
+    void SetupConfig_Internal() override {
+      Module::SetupConfig_Internal();
+      if (IsDeterministic()) {
+        LinkVar(cache_size, "cache_size",
+                "Max evaluation results to keep for reuse on identical inputs (0 = no caching)");
+      }
+    }
+
+  public:
+    EvalModuleBase(mabe::MABE & control, emp::String name, emp::String desc)
+      : Module(control, name, desc)
+    {
+      SetEvaluateMod(true);
+    }
+
+    /// Will this module always produce the same results for the same inputs?
+    virtual bool IsDeterministic() const { return false; }
+
+    bool UseEvalCache() const { return cache_size > 0 && IsDeterministic(); }
+    size_t GetCacheSize() const { return cache_size; }
+
+    void AddEvalCache(emp::Ptr<EvalCacheBase> cache_ptr) { caches.push_back(cache_ptr); }
+
+    /// Remove all cached results (e.g., because the fitness landscape has changed).
+    void ClearEvalCache() { for (auto cache_ptr : caches) cache_ptr->Clear(); }
+
+    size_t GetCacheHits() const {
+      size_t total = 0;
+      for (auto cache_ptr : caches) total += cache_ptr->GetHits();
+      return total;
+    }
+
+    size_t GetCacheMisses() const {
+      size_t total = 0;
+      for (auto cache_ptr : caches) total += cache_ptr->GetMisses();
+      return total;
+    }
+  };
+
+  inline EvalCacheBase::EvalCacheBase(emp::Ptr<EvalModuleBase> _mod_ptr) : mod_ptr(_mod_ptr) {
+    mod_ptr->AddEvalCache(this);
+  }
+
+  /// A bounded, least-recently-used cache of evaluation results for a deterministic module.
+  /// Declare as a module member, e.g.: EvalCache<emp::BitVector, double> cache{this};
+  template <typename INPUT_T, typename RESULT_T>
+  class EvalCache : public EvalCacheBase {
+  private:
+    using key_t = EvalInputKey<INPUT_T>;
+    using view_t = typename key_t::view_t;
+
+    struct Entry {
+      size_t hash;
+      INPUT_T input;
+      RESULT_T result;
+    };
+    using entry_it_t = typename std::list<Entry>::iterator;
+
+    std::list<Entry> entries;                       ///< Most recently used at front.
+    std::unordered_map<size_t, entry_it_t> index;   ///< Lookup of entries by input hash.
+    RESULT_T scratch;                               ///< Result holder when caching is off.
+
+  public:
+    EvalCache(emp::Ptr<EvalModuleBase> _mod_ptr) : EvalCacheBase(_mod_ptr) { }
+
+    size_t GetSize() const override { return entries.size(); }
+    void Clear() override { entries.clear(); index.clear(); }
+
+    /// Return the result for the given input, only running calc_fun if it is not cached.
+    /// The returned reference is valid until the next call to Get() or Clear().
+    template <typename FUN_T>
+    const RESULT_T & Get(view_t input, FUN_T && calc_fun) {
+      if (!mod_ptr->UseEvalCache()) {
+        scratch = calc_fun();
+        return scratch;
+      }
+
+      const size_t hash = key_t::Hash(input);
+      auto it = index.find(hash);
+      if (it != index.end()) {
+        if (key_t::Equal(it->second->input, input)) {
+          ++hits;
+          entries.splice(entries.begin(), entries, it->second);  // Mark as most recent.
+          return it->second->result;
+        }
+        entries.erase(it->second);    // Hash collision; replace the old entry.
+        index.erase(it);
+      }
+
+      ++misses;
+      entries.push_front(Entry{hash, key_t::Copy(input), calc_fun()});
+      index[hash] = entries.begin();
+      while (entries.size() > mod_ptr->GetCacheSize()) {
+        index.erase(entries.back().hash);
+        entries.pop_back();
+      }
+      return entries.front().result;
+    }
+  };
+
   template <typename DERIVED_T>
-  class EvalModule : public Module {
+  class EvalModule : public EvalModuleBase {
   public:
     EvalModule(mabe::MABE & control,
                emp::String name,
                emp::String desc)
-      : Module(control, name, desc)
+      : EvalModuleBase(control, name, desc)
     {
-      SetEvaluateMod(true);
     }
     ~EvalModule() { }
 
@@ -35,8 +222,14 @@ namespace mabe {
                              [](DERIVED_T & mod, Collection list) { return mod.Evaluate(list); },
                              "Evaluate all orgs in the OrgList.");
       info.AddMemberFunction("RESET",
-                             [](DERIVED_T & mod) { return mod.Reset(); },
+                             [](DERIVED_T & mod) { mod.ClearEvalCache(); return mod.Reset(); },
                              "Regenerate the landscape with current config values.");
+      info.AddMemberFunction("CACHE_HITS",
+                             [](DERIVED_T & mod) { return mod.GetCacheHits(); },
+                             "Number of evaluations answered from the results cache.");
+      info.AddMemberFunction("CACHE_MISSES",
+                             [](DERIVED_T & mod) { return mod.GetCacheMisses(); },
+                             "Number of evaluations that could not use the results cache.");
     }
 
     /// Run this evaluator on the provided collection.
@@ -51,7 +244,7 @@ namespace mabe {
     /// If a string is provided to Evaluate, convert it to a Collection.
     double Evaluate(const emp::String & in) { return Evaluate( control.ToCollection(in) ); }
 
-    /// Re-randomize all of the entries.
+    /// Re-randomize all of the entries.  Any cached results are invalid afterward.
     virtual double Reset() { emp::notify::Message("Module '", name, "' cannot be reset."); return 0.0;  }
   };
 
@@ -10,12 +10,18 @@
 #ifndef MABE_GENOME_HPP
 #define MABE_GENOME_HPP
 
+#include <algorithm>
 #include <limits>
+#include <span>
+#include <type_traits>
 
 #include "emp/base/error.hpp"
+#include "emp/base/notify.hpp"
 #include "emp/math/Random.hpp"
 #include "emp/meta/TypeID.hpp"
 
+#include "GenomeIO.hpp"
+
 namespace mabe {
 
   // Interface class for all genome types.
@@ -49,9 +55,9 @@ namespace mabe {
     virtual emp::String ToString() const { return "[unknown]"; }
     virtual void FromString(emp::String & in) { emp_error("Cannot read genome from string."); }
 
-    // Potentially more compressed or structured formats for saving/loading genomes.
-    // TODO:
-    // Archive & Serialize(Archive & archive) = 0;
+    // Compact binary format for saving/loading genomes (see GenomeIO.hpp).
+    virtual void Serialize(std::ostream & /*os*/) const { emp_error("Cannot write genome as binary."); }
+    virtual bool Deserialize(std::istream & /*is*/) { emp_error("Cannot read genome from binary."); return false; }
 
     // Genome accessors for individual values…
     virtual int ReadInt(size_t index) const = 0;
@@ -59,7 +65,6 @@ namespace mabe {
     virtual std::byte ReadByte(size_t index) const = 0;
     virtual bool ReadBit(size_t index) const = 0;
 
-    // NEED MULTI-READ AND MULTI-WRITE.
     // NEED READS AND WRITES THAT ARE RESTRICTED TO A RANGE
     // EXAMPLE:
     virtual int ReadInt(size_t index, int min, int max) const = 0;
@@ -70,13 +75,34 @@ namespace mabe {
     virtual void WriteBit(size_t index, bool value) =  0;
 
     // Genome accessors for multiple values…
-    // TODO:
-    //  emp::span<int> ReadInts(size_t start_index, size_t end_index) =  0;
-    //  emp::span<double> ReadDoubles(size_t start_index, size_t end_index) =  0;
-    //  emp::span<std::byte> ReadBytes(size_t start_index, size_t end_index) =  0;
-    //  emp::BitVector ReadBits(size_t start_index, size_t end_index) =  0;
-    //
-    // + Multi-writes!!
+    // Each fills (or writes from) the whole span, starting at start_index; all positions in
+    // the range must be valid.  Derived genomes should override these with bulk copies; the
+    // defaults fall back to one accessor call per value.
+    virtual void ReadInts(size_t start_index, std::span<int> out) const {
+      for (size_t i = 0; i < out.size(); i++) out[i] = ReadInt(start_index + i);
+    }
+    virtual void ReadDoubles(size_t start_index, std::span<double> out) const {
+      for (size_t i = 0; i < out.size(); i++) out[i] = ReadDouble(start_index + i);
+    }
+    virtual void ReadBytes(size_t start_index, std::span<std::byte> out) const {
+      for (size_t i = 0; i < out.size(); i++) out[i] = ReadByte(start_index + i);
+    }
+    virtual void ReadBits(size_t start_index, std::span<bool> out) const {
+      for (size_t i = 0; i < out.size(); i++) out[i] = ReadBit(start_index + i);
+    }
+
+    virtual void WriteInts(size_t start_index, std::span<const int> values) {
+      for (size_t i = 0; i < values.size(); i++) WriteInt(start_index + i, values[i]);
+    }
+    virtual void WriteDoubles(size_t start_index, std::span<const double> values) {
+      for (size_t i = 0; i < values.size(); i++) WriteDouble(start_index + i, values[i]);
+    }
+    virtual void WriteBytes(size_t start_index, std::span<const std::byte> values) {
+      for (size_t i = 0; i < values.size(); i++) WriteByte(start_index + i, values[i]);
+    }
+    virtual void WriteBits(size_t start_index, std::span<const bool> values) {
+      for (size_t i = 0; i < values.size(); i++) WriteBit(start_index + i, values[i]);
+    }
 
     class Head {
     protected:
@@ -91,6 +117,58 @@ namespace mabe {
 
       unsigned int state = NORMAL;
 
+      // Number of positions from the current one (inclusive) that can be handled in a single
+      // bulk call before reaching an end of the genome in the current direction.
+      size_t SegmentSize(size_t max_count) const {
+        const size_t avail = (direction > 0) ? genome->GetSize() - pos : pos + 1;
+        return std::min(max_count, avail);
+      }
+
+      // Read into the whole span with one genome call per contiguous segment; the position is
+      // validated (and wrapped, for circular genomes) once per segment rather than per value.
+      // Positions past an end of a non-circular genome read as zero.
+      template <typename T, typename READ_FUN>
+      size_t ReadSpan(std::span<T> out, READ_FUN && read_fun) {
+        size_t done = 0;
+        while (done < out.size() && IsValid()) {
+          const size_t seg_size = SegmentSize(out.size() - done);
+          if (direction > 0) read_fun(pos, out.subspan(done, seg_size));
+          else {
+            read_fun(pos + 1 - seg_size, out.subspan(done, seg_size));
+            std::reverse(out.begin() + done, out.begin() + done + seg_size);
+          }
+          done += seg_size;
+          Advance(seg_size);
+        }
+        const size_t num_read = done;
+        if (done < out.size()) {
+          std::fill(out.begin() + done, out.end(), T{});
+          Advance(out.size() - done);
+        }
+        return num_read;
+      }
+
+      // Write the whole span with one genome call per contiguous segment; values that would
+      // land past an end of a non-circular genome are dropped.
+      template <typename T, typename WRITE_FUN>
+      Head & WriteSpan(std::span<const T> values, WRITE_FUN && write_fun) {
+        size_t done = 0;
+        while (done < values.size() && IsValid()) {
+          const size_t seg_size = SegmentSize(values.size() - done);
+          if (direction > 0) write_fun(pos, values.subspan(done, seg_size));
+          else {
+            // Positions run backward, so write the reversed values one at a time.
+            for (size_t i = 0; i < seg_size; i++) {
+              write_fun(pos - i, values.subspan(done + i, 1));
+            }
+          }
+          done += seg_size;
+          Advance(seg_size);
+        }
+        if (done < values.size()) Advance(values.size() - done);
+        return *this;
+      }
+
     public:
       Head(Genome & in_genome, size_t in_pos=0, int in_dir=1)
         : genome(&in_genome), pos(in_pos), direction(in_dir) { }
@@ -125,7 +203,34 @@ namespace mabe {
       Head & WriteByte(std::byte value) { if (IsValid()) genome->WriteByte(pos, value); return Advance(); }
       Head & WriteBit(bool value) { if (IsValid()) genome->WriteBit(pos, value); return Advance(); }
 
-      // NEED MULTI-READ AND MULTI-WRITE.
+      // Multi-reads fill the provided span, moving the head past all of it; each returns the
+      // number of values read from valid positions.  Multi-writes move the head the same way.
+      size_t ReadInts(std::span<int> out) {
+        return ReadSpan(out, [this](size_t start, std::span<int> seg){ genome->ReadInts(start, seg); });
+      }
+      size_t ReadDoubles(std::span<double> out) {
+        return ReadSpan(out, [this](size_t start, std::span<double> seg){ genome->ReadDoubles(start, seg); });
+      }
+      size_t ReadBytes(std::span<std::byte> out) {
+        return ReadSpan(out, [this](size_t start, std::span<std::byte> seg){ genome->ReadBytes(start, seg); });
+      }
+      size_t ReadBits(std::span<bool> out) {
+        return ReadSpan(out, [this](size_t start, std::span<bool> seg){ genome->ReadBits(start, seg); });
+      }
+
+      Head & WriteInts(std::span<const int> values) {
+        return WriteSpan(values, [this](size_t start, std::span<const int> seg){ genome->WriteInts(start, seg); });
+      }
+      Head & WriteDoubles(std::span<const double> values) {
+        return WriteSpan(values, [this](size_t start, std::span<const double> seg){ genome->WriteDoubles(start, seg); });
+      }
+      Head & WriteBytes(std::span<const std::byte> values) {
+        return WriteSpan(values, [this](size_t start, std::span<const std::byte> seg){ genome->WriteBytes(start, seg); });
+      }
+      Head & WriteBits(std::span<const bool> values) {
+        return WriteSpan(values, [this](size_t start, std::span<const bool> seg){ genome->WriteBits(start, seg); });
+      }
+
       // NEED READS AND WRITES THAT ARE RESTRICTED TO A RANGE
       // EXAMPLE OF RANGED-READ:
       int ReadInt(int min, int max) {
@@ -163,6 +268,22 @@ namespace mabe {
 
     double alphabet_size = 4.0;
 
+    // Convert a run of loci into the requested output type.
+    template <typename T>
+    void CopyLoci(size_t start_index, std::span<T> out) const {
+      emp_assert(start_index + out.size() <= data.size(), start_index, out.size(), data.size());
+      std::transform(data.begin() + start_index, data.begin() + start_index + out.size(),
+                     out.begin(), [](locus_t value){ return static_cast<T>(value); });
+    }
+
+    // Convert a run of values into loci.
+    template <typename T>
+    void SetLoci(size_t start_index, std::span<const T> values) {
+      emp_assert(start_index + values.size() <= data.size(), start_index, values.size(), data.size());
+      std::transform(values.begin(), values.end(), data.begin() + start_index,
+                     [](T value){ return static_cast<locus_t>(value); });
+    }
+
   public:
     TypedGenome() { }
     TypedGenome(this_t &) = default;
@@ -194,9 +315,23 @@ namespace mabe {
     emp::String ToString() const override { return "[unknown]"; }
     void FromString(emp::String in) override { emp_error("Cannot read genome from string."); }
 
-    // Potentially more compressed or structured formats for saving/loading genomes.
-    // TODO:
-    // Archive & Serialize(Archive & archive) = 0;
+    // Binary format is the number of loci followed by the raw loci.
+    void Serialize(std::ostream & os) const override {
+      static_assert(std::is_trivially_copyable_v<locus_t>, "Binary genomes require raw loci.");
+      WriteBinary<uint64_t>(os, data.size());
+      WriteBinarySpan(os, std::span<const locus_t>(data));
+    }
+    bool Deserialize(std::istream & is) override {
+      uint64_t size = 0;
+      if (!ReadBinary(is, size)) return false;
+      if (size < min_size || size > max_size || !CheckBinaryCount(is, size, sizeof(locus_t))) {
+        emp::notify::Error("Genome has invalid size ", size, " (allowed range is ", min_size,
+                           " to ", max_size, ", or too large for its input).");
+        return false;
+      }
+      data.resize(size);
+      return ReadBinarySpan(is, std::span<locus_t>(data));
+    }
 
     // Genome accessors for individual values…
     int ReadInt(size_t index) const override { return static_cast<int>(data[index]); }
@@ -208,7 +343,30 @@ namespace mabe {
     void WriteDouble(size_t index, double value) { data[index] = static_cast<locus_t>(value); }
     void WriteByte(size_t index, std::byte value) { data[index] = static_cast<locus_t>(value); }
     void WriteBit(size_t index, bool value) { data[index] = static_cast<locus_t>(value); }
- 
+
+    // Genome accessors for multiple values…
+    void ReadInts(size_t start_index, std::span<int> out) const override { CopyLoci(start_index, out); }
+    void ReadDoubles(size_t start_index, std::span<double> out) const override { CopyLoci(start_index, out); }
+    void ReadBytes(size_t start_index, std::span<std::byte> out) const override { CopyLoci(start_index, out); }
+    void ReadBits(size_t start_index, std::span<bool> out) const override { CopyLoci(start_index, out); }
+
+    void WriteInts(size_t start_index, std::span<const int> values) override { SetLoci(start_index, values); }
+    void WriteDoubles(size_t start_index, std::span<const double> values) override { SetLoci(start_index, values); }
+    void WriteBytes(size_t start_index, std::span<const std::byte> values) override { SetLoci(start_index, values); }
+    void WriteBits(size_t start_index, std::span<const bool> values) override { SetLoci(start_index, values); }
+
+    // Direct (non-virtual) views of the loci, for code that knows the genome type.
+    std::span<const locus_t> GetLoci(size_t start_index, size_t count) const {
+      emp_assert(start_index + count <= data.size(), start_index, count, data.size());
+      return std::span<const locus_t>(data.data() + start_index, count);
+    }
+    std::span<locus_t> GetLoci(size_t start_index, size_t count) {
+      emp_assert(start_index + count <= data.size(), start_index, count, data.size());
+      return std::span<locus_t>(data.data() + start_index, count);
+    }
+    std::span<const locus_t> GetLoci() const { return GetLoci(0, data.size()); }
+    std::span<locus_t> GetLoci() { return GetLoci(0, data.size()); }
+
   };
 
   template <>
@@ -0,0 +1,130 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  GenomeIO.hpp
+ *  @brief Tools for reading and writing genomes in a compact binary format.
+ *  @note Status: ALPHA
+ *
+ *  Genome files start with a versioned header (see GenomeFileHeader) naming the organism type,
+ *  followed by the number of genomes and then each genome as written by
+ *  OrgType::WriteGenome().  Values are stored in native byte order, so files are meant for
+ *  moving genomes between runs on the same kind of machine (e.g., for analysis or seeding).
+ */
+
+#ifndef MABE_GENOME_IO_HPP
+#define MABE_GENOME_IO_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <type_traits>
+
+#include "emp/base/notify.hpp"
+#include "emp/tools/String.hpp"
+
+namespace mabe {
+
+  /// Write a single trivially-copyable value.
+  template <typename T>
+  void WriteBinary(std::ostream & os, const T & value) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only raw values can be written as binary.");
+    os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  /// Read a single trivially-copyable value; return whether the read succeeded.
+  template <typename T>
+  bool ReadBinary(std::istream & is, T & value) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only raw values can be read as binary.");
+    is.read(reinterpret_cast<char *>(&value), sizeof(T));
+    return is.good();
+  }
+
+  /// Write a run of values in a single call (the count is NOT included).
+  template <typename T>
+  void WriteBinarySpan(std::ostream & os, std::span<const T> values) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only raw values can be written as binary.");
+    os.write(reinterpret_cast<const char *>(values.data()), (std::streamsize) values.size_bytes());
+  }
+
+  /// Fill a run of values in a single call; return whether the read succeeded.
+  template <typename T>
+  bool ReadBinarySpan(std::istream & is, std::span<T> values) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only raw values can be read as binary.");
+    is.read(reinterpret_cast<char *>(values.data()), (std::streamsize) values.size_bytes());
+    return is.good();
+  }
+
+  /// Can a count read from a stream be trusted?  Returns false if the stream does not hold
+  /// enough bytes for count items of item_bytes each, so that a corrupt or hostile count is
+  /// caught before it is used to size a container.  Streams that cannot report their size
+  /// (e.g., pipes) are given the benefit of the doubt.
+  inline bool CheckBinaryCount(std::istream & is, uint64_t count, uint64_t item_bytes) {
+    const std::streampos cur_pos = is.tellg();
+    if (cur_pos == std::streampos(-1)) return true;
+    is.seekg(0, std::ios::end);
+    const std::streampos end_pos = is.tellg();
+    is.seekg(cur_pos);
+    if (end_pos == std::streampos(-1) || end_pos < cur_pos) return true;
+    const uint64_t remaining = (uint64_t) (end_pos - cur_pos);
+    return count <= remaining / item_bytes;
+  }
+
+  /// Write a string, preceded by its length.
+  inline void WriteBinaryString(std::ostream & os, const emp::String & str) {
+    WriteBinary<uint32_t>(os, (uint32_t) str.size());
+    os.write(str.data(), (std::streamsize) str.size());
+  }
+
+  /// Read a string written by WriteBinaryString(); return whether the read succeeded.
+  inline bool ReadBinaryString(std::istream & is, emp::String & str) {
+    uint32_t size = 0;
+    if (!ReadBinary(is, size) || !CheckBinaryCount(is, size, 1)) return false;
+    str.resize(size);
+    is.read(str.data(), (std::streamsize) size);
+    return is.good();
+  }
+
+  /// Header placed at the start of every binary genome file.
+  struct GenomeFileHeader {
+    static constexpr char MAGIC[8] = {'M','A','B','E','G','E','N','S'};
+    static constexpr uint32_t CUR_VERSION = 1;
+
+    uint32_t version = CUR_VERSION;  ///< Format version of the file.
+    emp::String org_type;            ///< Name of the organism manager that produced the genomes.
+    uint64_t num_genomes = 0;        ///< Number of genomes that follow the header.
+
+    void Write(std::ostream & os) const {
+      os.write(MAGIC, sizeof(MAGIC));
+      WriteBinary(os, version);
+      WriteBinaryString(os, org_type);
+      WriteBinary(os, num_genomes);
+    }
+
+    /// Read the header, reporting an error and returning false if it is not usable.
+    bool Read(std::istream & is, const emp::String & filename) {
+      char magic[sizeof(MAGIC)];
+      is.read(magic, sizeof(magic));
+      if (!is.good() || !std::equal(magic, magic + sizeof(magic), MAGIC)) {
+        emp::notify::Error("File '", filename, "' is not a MABE genome file.");
+        return false;
+      }
+      if (!ReadBinary(is, version) || version == 0 || version > CUR_VERSION) {
+        emp::notify::Error("Genome file '", filename, "' has unsupported version ", version,
+                           " (current version is ", CUR_VERSION, ").");
+        return false;
+      }
+      if (!ReadBinaryString(is, org_type) || !ReadBinary(is, num_genomes)) {
+        emp::notify::Error("Genome file '", filename, "' has an incomplete header.");
+        return false;
+      }
+      return true;
+    }
+  };
+
+}
+
+#endif
@@ -16,6 +16,7 @@
 #ifndef MABE_MABE_HPP
 #define MABE_MABE_HPP
 
+#include <fstream>
 #include <limits>
 #include <sstream>
 
@@ -37,6 +38,7 @@
 #include "Batch.hpp"
 #include "Collection.hpp"
 #include "data_collect.hpp"
+#include "GenomeIO.hpp"
 #include "MABEBase.hpp"
 #include "MABEScript.hpp"
 #include "ModuleBase.hpp"
@@ -203,6 +205,14 @@ namespace mabe {
                              const emp::String & type_name, 
                              size_t copy_count=1);
 
+    /// Write the genomes of all living organisms in a population to a binary genome file (see
+    /// GenomeIO.hpp); all must be of the same type.  Returns the number of genomes saved.
+    size_t SaveGenomes(Population & pop, const emp::String & filename);
+
+    /// Build organisms from each genome in a binary genome file and inject them into a
+    /// population.  Returns the positions the organisms were placed.
+    Collection LoadGenomes(Population & pop, const emp::String & filename);
+
     /// Inject a copy of the provided organism at a specified position.
     void InjectAt(const Organism & org, OrgPosition pos) {
       emp_assert(pos.IsValid());
@@ -291,6 +301,9 @@ namespace mabe {
       return emp::FindEval(modules, [mod_name](const auto & m){ return m->GetName() == mod_name; });
     }
 
+    /// Get the number of modules currently in use.
+    size_t GetNumModules() const { return modules.size(); }
+
     /// Get a reference to a module with the specified ID.
     const ModuleBase & GetModule(int id) const { return *modules[(size_t) id]; }
     ModuleBase & GetModule(int id) { return *modules[(size_t) id]; }
@@ -612,6 +625,20 @@ namespace mabe {
     pop_type.AddMemberFunction("INJECT", inject_fun,
       "Inject organisms into population.  Args: org_name, org_count; Return: OrgList of injected orgs.");
 
+    // 'SAVE_GENOMES' and 'LOAD_GENOMES' move whole populations of genomes to and from binary files.
+    std::function<size_t(Population &, const emp::String &)> save_genomes_fun =
+      [this](Population & pop, const emp::String & filename) {
+        return SaveGenomes(pop, filename);
+      };
+    pop_type.AddMemberFunction("SAVE_GENOMES", save_genomes_fun,
+      "Save genomes of all living orgs to a binary file.  Args: filename; Return: number saved.");
+    std::function<Collection(Population &, const emp::String &)> load_genomes_fun =
+      [this](Population & pop, const emp::String & filename) {
+        return LoadGenomes(pop, filename);
+      };
+    pop_type.AddMemberFunction("LOAD_GENOMES", load_genomes_fun,
+      "Inject orgs built from a binary genome file.  Args: filename; Return: OrgList of injected orgs.");
+
     // Setup all known modules as available types in the config file.
     for (auto & [type_name,mod] : GetModuleMap()) {
       auto mod_init_fun = [this,mod=&mod](const emp::String & name) -> emp::Ptr<emplode::EmplodeType> {
@@ -762,6 +789,76 @@ namespace mabe {
     return Inject(pop, type_name, copy_count); // Inject the organisms.
   }
 
+  size_t MABE::SaveGenomes(Population & pop, const emp::String & filename) {
+    // All genomes in a file share one organism type; find it and count the genomes.
+    GenomeFileHeader header;
+    for (size_t pos = 0; pos < pop.GetSize(); pos++) {
+      const Organism & org = pop[pos];
+      if (org.IsEmpty()) continue;
+      const emp::String & type_name = org.GetTypeName();
+      if (header.num_genomes == 0) header.org_type = type_name;
+      else if (type_name != header.org_type) {
+        emp::notify::Error("Cannot save genomes from population '", pop.GetName(),
+                           "'; it contains both '", header.org_type, "' and '", type_name, "' orgs.");
+        return 0;
+      }
+      header.num_genomes++;
+    }
+
+    std::ofstream file(filename.str(), std::ios::binary);
+    if (!file) {
+      emp::notify::Error("Unable to open genome file '", filename, "' for writing.");
+      return 0;
+    }
+    header.Write(file);
+
+    size_t num_saved = 0;
+    for (size_t pos = 0; pos < pop.GetSize(); pos++) {
+      const Organism & org = pop[pos];
+      if (org.IsEmpty()) continue;
+      if (!org.WriteGenome(file)) {
+        emp::notify::Error("Failed to write genome ", num_saved, " of type '", header.org_type,
+                           "' to '", filename, "'; binary genomes may not be supported.");
+        break;
+      }
+      num_saved++;
+    }
+    Verbose("Saved ", num_saved, " genomes from population ", pop.GetID(), " to '", filename, "'.");
+    return num_saved;
+  }
+
+  Collection MABE::LoadGenomes(Population & pop, const emp::String & filename) {
+    Collection placement_set;
+    std::ifstream file(filename.str(), std::ios::binary);
+    if (!file) {
+      emp::notify::Error("Unable to open genome file '", filename, "' for reading.");
+      return placement_set;
+    }
+
+    GenomeFileHeader header;
+    if (!header.Read(file, filename)) return placement_set;
+    if (GetModuleID(header.org_type) == -1) {
+      emp::notify::Error("Genome file '", filename, "' has genomes of unknown organism type '",
+                         header.org_type, "'.");
+      return placement_set;
+    }
+
+    Verbose("Loading ", header.num_genomes, " genomes of type '", header.org_type,
+            "' into population ", pop.GetID());
+    auto & org_manager = GetModule(header.org_type);
+    for (size_t i = 0; i < header.num_genomes; i++) {
+      auto org_ptr = org_manager.Make<Organism>();
+      if (!org_ptr->ReadGenome(file)) {
+        org_ptr.Delete();
+        emp::notify::Error("Failed to read genome ", i, " of ", header.num_genomes,
+                           " from '", filename, "'.");
+        break;
+      }
+      placement_set.Insert(InjectInstance(pop, org_ptr));
+    }
+    return placement_set;
+  }
+
   /// Give birth to one or more offspring; return position of last placed.
   /// Triggers 'before repro' signal on parent (once) and 'offspring ready' on each offspring.
   /// Regular signal triggers occur in AddOrgAt.
@@ -53,11 +53,17 @@ namespace mabe {
     /// Build a function to scan a data map, run a provided equation on its entries,
     /// and return the result.
     auto BuildTraitEquation(const emp::DataLayout & data_layout, emp::String equation) {
-      auto pp_equ = Preprocess(equation, true);
-      auto dm_fun = dm_parser.BuildMathFunction(data_layout, pp_equ.result, pp_equ.values);
+      auto dm_fun = BuildDataMapEquation(data_layout, equation);
       return [dm_fun](const Organism & org){ return dm_fun(org.GetDataMap()); };
     }
 
+    /// Build a function to run a provided equation directly on a data map (with the
+    /// provided layout) and return the result.
+    auto BuildDataMapEquation(const emp::DataLayout & data_layout, emp::String equation) {
+      auto pp_equ = Preprocess(equation, true);
+      return dm_parser.BuildMathFunction(data_layout, pp_equ.result, pp_equ.values);
+    }
+
     /// Scan an equation and return the names of all traits it is using.
     const std::set<emp::String> & GetEquationTraits(const emp::String & equation) {
       return dm_parser.GetNamesUsed(equation);
@@ -123,6 +123,7 @@ namespace mabe {
 
     void SetupDataMap(emp::DataMap & in_dm) override {
       obj_prototype->SetDataMap(in_dm);
+      obj_prototype->SetupDataMap(in_dm);
     }
 
     void SetupConfig() override {
@@ -0,0 +1,107 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  MutationSites.hpp
+ *  @brief Tools for choosing which genome sites should mutate.
+ *  @note Status: BETA
+ *
+ *  All functions here call a provided function on each chosen site, in the order chosen,
+ *  so any random draws made while mutating a site stay interleaved with site selection.  None of
+ *  them rely on state shared between threads, so they are safe to use from multiple threads
+ *  (each with its own random number generator).
+ *
+ *  ForEachMutationSite() treats every site independently, jumping from one mutated site to the
+ *  next with a geometrically distributed skip, so the cost scales with the number of mutations
+ *  rather than with genome length.
+ *
+ *  ForEachDistinctSite() picks an exact number of distinct sites (e.g., from a binomial draw).
+ *  Small counts are drawn uniformly and re-drawn if they repeat, with chosen sites tracked on
+ *  the stack; larger counts use Floyd's algorithm, which takes exactly one draw per site chosen,
+ *  with chosen sites tracked in a per-thread bit vector that is reused from call to call.
+ */
+
+#ifndef MABE_MUTATION_SITES_HPP
+#define MABE_MUTATION_SITES_HPP
+
+#include <array>
+#include <cmath>
+
+#include "emp/base/assert.hpp"
+#include "emp/bits/BitVector.hpp"
+#include "emp/math/Random.hpp"
+
+namespace mabe {
+
+  /// Call mut_fun(pos) for each site in [0, num_sites) that mutates, where each site mutates
+  /// independently with probability mut_prob.
+  /// @return The number of sites mutated.
+  template <typename FUN_T>
+  size_t ForEachMutationSite(emp::Random & random, size_t num_sites, double mut_prob,
+                             FUN_T && mut_fun) {
+    if (mut_prob <= 0.0 || num_sites == 0) return 0;
+    if (mut_prob >= 1.0) {
+      for (size_t pos = 0; pos < num_sites; ++pos) mut_fun(pos);
+      return num_sites;
+    }
+
+    // Number of unmutated sites before the next mutation is geometric: floor(ln(U) / ln(1-p)).
+    const double log_keep = std::log1p(-mut_prob);
+    size_t num_muts = 0;
+    double pos = -1.0;
+    while (true) {
+      const double skip = std::floor(std::log(1.0 - random.GetDouble()) / log_keep);
+      pos += skip + 1.0;
+      if (pos >= static_cast<double>(num_sites)) break;
+      mut_fun(static_cast<size_t>(pos));
+      ++num_muts;
+    }
+    return num_muts;
+  }
+
+  /// Call mut_fun(pos) for exactly num_muts distinct sites in [0, num_sites).  If num_muts is
+  /// at least num_sites, every site is mutated.
+  /// @return The number of sites mutated.
+  template <typename FUN_T>
+  size_t ForEachDistinctSite(emp::Random & random, size_t num_sites, size_t num_muts,
+                             FUN_T && mut_fun) {
+    constexpr size_t MAX_TRACKED = 32;  // Largest count to track on the stack.
+
+    if (num_muts == 0 || num_sites == 0) return 0;
+    if (num_muts >= num_sites) {
+      for (size_t pos = 0; pos < num_sites; ++pos) mut_fun(pos);
+      return num_sites;
+    }
+
+    // Few mutations in a larger genome: draw positions directly, re-drawing any repeats.
+    if (num_muts <= MAX_TRACKED && num_muts * 2 <= num_sites) {
+      std::array<size_t, MAX_TRACKED> chosen;
+      for (size_t i = 0; i < num_muts; ++i) {
+        const size_t pos = random.GetUInt(num_sites);
+        bool repeat = false;
+        for (size_t j = 0; j < i; ++j) repeat |= (chosen[j] == pos);
+        if (repeat) { --i; continue; }  // Duplicate position; try again.
+        chosen[i] = pos;
+        mut_fun(pos);
+      }
+      return num_muts;
+    }
+
+    // Otherwise use Floyd's algorithm: at each step choose from one more site than before; if
+    // the site drawn was already chosen, the newly added site is chosen instead.
+    thread_local emp::BitVector chosen;   // All zeros between calls.
+    chosen.Resize(num_sites);
+    for (size_t max_pos = num_sites - num_muts; max_pos < num_sites; ++max_pos) {
+      size_t pos = random.GetUInt(max_pos + 1);
+      if (chosen.Has(pos)) pos = max_pos;
+      chosen.Set(pos);
+      mut_fun(pos);
+    }
+    chosen.Clear();
+    return num_muts;
+  }
+
+}
+
+#endif
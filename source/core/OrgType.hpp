@@ -15,16 +15,29 @@
 #ifndef MABE_ORG_TYPE_HPP
 #define MABE_ORG_TYPE_HPP
 
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <span>
+
 #include "ModuleBase.hpp"
 
 namespace mabe {
 
   class Module;
 
+  /// A read-only view of an organism's bits packed into 64-bit words, for evaluators that can
+  /// work on them directly.  Bit 0 is the low bit of words[0]; any bits past num_bits are zero.
+  struct BitWords {
+    std::span<const uint64_t> words;     ///< Packed bits (empty if not available).
+    size_t num_bits = 0;                 ///< Number of bits in use.
+    size_t trait_id = emp::MAX_SIZE_T;   ///< Trait that these bits are the value of.
+  };
+
   // A class type managed by a ManagerModule.
   class OrgType {
   protected:
-    ModuleBase & manager;    ///< Manager for the specific organism type
+    ModuleBase & manager;       ///< Manager for the specific organism type
 
   public:
     OrgType(ModuleBase & _man) : manager(_man) { ; }
@@ -34,6 +47,9 @@ namespace mabe {
     Module & GetManager() { return (Module&) manager; }
     const Module & GetManager() const { return (Module&) manager; }
 
+    /// Get the name of this organism's type (i.e., the name of its manager).
+    const emp::String & GetTypeName() const { return manager.GetName(); }
+
     /// The class below is a placeholder for storing any manager-specific data that the organisms
     /// should have access to.  A derived organism class should derive it's managed data from this
     /// one (mabe::OrgType::ManagerData) such that it inherits the common variables.
@@ -109,6 +125,14 @@ namespace mabe {
       return os;
     }
 
+    /// Write this organism's genome in a compact binary form (see GenomeIO.hpp).
+    /// @return false if binary genomes are not supported for this organism type.
+    virtual bool WriteGenome(std::ostream & /*os*/) const { return false; }
+
+    /// Replace this organism's genome with one produced by WriteGenome().
+    /// @return false if the genome could not be read (or binary genomes are not supported).
+    virtual bool ReadGenome(std::istream & /*is*/) { return false; }
+
     /// Completely randomize a new organism (typically for initialization)
     virtual void Randomize(emp::Random & /*random*/) {
       emp_assert(false, "Randomize() must be overridden before it can be called.");
@@ -120,6 +144,20 @@ namespace mabe {
     /// Run the organism to generate an output in the pre-configured data_map entries.
     virtual void GenerateOutput() { ; }
 
+    /// Run the organism on a whole batch of test cases, producing one output per case.
+    /// Inputs are column-major: all of the cases for the first input, then all for the second, etc.
+    /// @return false if batches are not supported; callers should then set inputs and call
+    /// GenerateOutput() one case at a time.  Only override this if the results always match
+    /// that per-case path (i.e., the organism reads one scalar trait per input and writes a
+    /// single scalar output).
+    virtual bool GenerateOutputBatch(std::span<const double> /*inputs*/,
+                                     size_t /*num_inputs*/,
+                                     std::span<double> /*outputs*/) { return false; }
+
+    /// Organisms that store their output bits as packed words can expose them here; evaluators
+    /// must check that trait_id matches the trait they would otherwise read.
+    virtual BitWords GetBitWords() const { return BitWords{}; }
+
     /// Run the organisms a single time step; only implemented for continuous execution organisms.
     virtual bool ProcessStep() { return false; }
  
@@ -136,6 +174,9 @@ namespace mabe {
 
     /// Setup organism-specific traits.
     virtual void SetupModule() { ; }
+
+    /// Setup anything that depends on the final trait layout (e.g., look up trait IDs).
+    virtual void SetupDataMap(const emp::DataMap & /*dm*/) { ; }
   };
 
 }
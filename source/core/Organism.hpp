@@ -27,6 +27,10 @@
 #ifndef MABE_ORGANISM_H
 #define MABE_ORGANISM_H
 
+#include <array>
+#include <type_traits>
+#include <utility>
+
 #include "emp/base/assert.hpp"
 #include "emp/base/vector.hpp"
 #include "emp/data/AnnotatedType.hpp"
@@ -41,6 +45,48 @@ namespace mabe {
   class Organism : public OrgType, public emp::AnnotatedType {
   private:
     emp::Ptr<Population> pop_ptr = nullptr;
+
+    static constexpr size_t MAX_STALE_TRAITS = 4;
+
+    /// IDs of traits whose stored values are out of date; each will be recalculated by
+    /// UpdateStaleTrait() the next time it is read.  Kept inline so copies never allocate.
+    mutable std::array<size_t, MAX_STALE_TRAITS> stale_ids;
+    mutable size_t num_stale = 0;
+
+    /// Find where the given trait ID is in stale_ids; num_stale if absent.
+    size_t FindStale(size_t trait_id) const {
+      for (size_t pos = 0; pos < num_stale; ++pos) {
+        if (stale_ids[pos] == trait_id) return pos;
+      }
+      return num_stale;
+    }
+
+    /// Stop tracking the stale trait at the given position in stale_ids.
+    void RemoveStale(size_t pos) const { stale_ids[pos] = stale_ids[--num_stale]; }
+
+    /// If the given trait is stale, bring it up to date.
+    void RefreshTrait(size_t trait_id) const {
+      const size_t pos = FindStale(trait_id);
+      if (pos == num_stale) return;
+      RemoveStale(pos);  // Remove first, so UpdateStaleTrait() can read the trait itself.
+      const_cast<Organism *>(this)->UpdateStaleTrait(trait_id);
+    }
+
+  protected:
+    /// Indicate that a trait should only be calculated when it is next read (e.g., a trait that
+    /// is expensive to build, but rarely used).
+    void MarkTraitStale(size_t trait_id) {
+      if (FindStale(trait_id) < num_stale) return;  // Already stale.
+      if (num_stale == MAX_STALE_TRAITS) {          // No room; update one trait right away.
+        const size_t update_id = stale_ids[0];
+        RefreshTrait(update_id);
+      }
+      stale_ids[num_stale++] = trait_id;
+    }
+
+    /// Recalculate a trait previously marked with MarkTraitStale(); override if used.
+    virtual void UpdateStaleTrait(size_t /*trait_id*/) { ; }
+
   public:
     Organism(ModuleBase & _man) : OrgType(_man) { ; }
     virtual ~Organism() {
@@ -96,6 +142,51 @@ namespace mabe {
 
 
 
+    // -- Trait access; make sure any stale trait is updated before it is read or replaced. --
+    // Names are resolved to an ID once, and only while some trait is actually stale.
+
+    template <typename T, typename KEY_T, typename... EXTRA_Ts>
+    decltype(auto) GetTrait(const KEY_T & key, EXTRA_Ts &&... extras) {
+      if constexpr (!std::is_integral_v<KEY_T>) {
+        if (num_stale > 0) {
+          return GetTrait<T>(GetDataMap().GetID(key), std::forward<EXTRA_Ts>(extras)...);
+        }
+      } else RefreshTrait(key);
+      return emp::AnnotatedType::GetTrait<T>(key, std::forward<EXTRA_Ts>(extras)...);
+    }
+
+    template <typename T, typename KEY_T, typename... EXTRA_Ts>
+    decltype(auto) GetTrait(const KEY_T & key, EXTRA_Ts &&... extras) const {
+      if constexpr (!std::is_integral_v<KEY_T>) {
+        if (num_stale > 0) {
+          return GetTrait<T>(GetDataMap().GetID(key), std::forward<EXTRA_Ts>(extras)...);
+        }
+      } else RefreshTrait(key);
+      return emp::AnnotatedType::GetTrait<T>(key, std::forward<EXTRA_Ts>(extras)...);
+    }
+
+    template <typename KEY_T, typename... EXTRA_Ts>
+    emp::String GetTraitAsString(const KEY_T & key, EXTRA_Ts &&... extras) const {
+      if constexpr (!std::is_integral_v<KEY_T>) {
+        if (num_stale > 0) {
+          return GetTraitAsString(GetDataMap().GetID(key), std::forward<EXTRA_Ts>(extras)...);
+        }
+      } else RefreshTrait(key);
+      return emp::AnnotatedType::GetTraitAsString(key, std::forward<EXTRA_Ts>(extras)...);
+    }
+
+    /// Setting a trait replaces any stale value, so it must not be recalculated later.
+    template <typename T, typename KEY_T>
+    decltype(auto) SetTrait(const KEY_T & key, const T & value) {
+      if constexpr (!std::is_integral_v<KEY_T>) {
+        if (num_stale > 0) return SetTrait<T>(GetDataMap().GetID(key), value);
+      } else {
+        const size_t pos = FindStale(key);
+        if (pos < num_stale) RemoveStale(pos);
+      }
+      return emp::AnnotatedType::SetTrait<T>(key, value);
+    }
+
     // -- Also deal with some deprecated functionality... --
 
     [[deprecated("Use OrgType::HasTrait() instead of OrgType::HasVar()")]]
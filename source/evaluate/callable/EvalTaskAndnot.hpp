@@ -28,9 +28,9 @@ namespace mabe {
 
     ~EvalTaskAndnot() { }
 
-    /// Check if passed output is equal to input_a ANDNOT input_b or input_b ANDNOT input_a 
-    bool CheckTwoArg(const data_t& output, const data_t& input_a, const data_t& input_b){
-      return (output == (input_a & ~input_b)) || (output == (input_b & ~input_a));
+    /// Calculate the correct output: input_a AND NOT input_b (checked in both orders)
+    data_t CalcTwoArg(const data_t& input_a, const data_t& input_b) const {
+      return input_a & ~input_b;
     }
   };
 
@@ -10,15 +10,105 @@
 #ifndef MABE_EVAL_TASK_BASE_H
 #define MABE_EVAL_TASK_BASE_H
 
+#include <unordered_map>
+
 #include "../../core/MABE.hpp"
 #include "../../core/Module.hpp"
 #include "../../orgs/VirtualCPUOrg.hpp"
 
 namespace mabe {
 
+  /// \brief Table of correct outputs for an organism's current inputs.
+  ///
+  /// A single table is shared by all logic tasks that read the same input trait.  Each correct
+  /// output value maps to a bitmask of the tasks that it satisfies, so checking an output against
+  /// every task requires only a single hash lookup.  The table is rebuilt only when the
+  /// organism's inputs change.
+  template <typename DATA_T>
+  class TaskAnswerTable {
+  public:
+    using mask_t = uint64_t;
+    static constexpr size_t MAX_TASKS = 64;
+
+  private:
+    emp::vector<DATA_T> inputs;                  ///< Inputs this table was built for.
+    std::unordered_map<DATA_T, mask_t> answers;  ///< Correct outputs -> tasks they satisfy.
+    bool is_built = false;                       ///< Has this table been built yet?
+    bool has_last = false;                       ///< Is there a cached lookup?
+    DATA_T last_output = DATA_T();               ///< Output from the most recent lookup...
+    mask_t last_mask = 0;                        ///< ...and the tasks it satisfied.
+
+  public:
+    TaskAnswerTable() = default;
+    TaskAnswerTable(const TaskAnswerTable &) { ; } // Ignore copy; rebuild for new inputs.
+    TaskAnswerTable & operator=(const TaskAnswerTable &) { Clear(); return *this; }
+
+    void Clear() {
+      inputs.resize(0);
+      answers.clear();
+      is_built = false;
+      has_last = false;
+    }
+
+    /// Was this table built for exactly the provided inputs?
+    bool IsBuiltFor(const emp::vector<DATA_T> & in_inputs) const {
+      return is_built && inputs == in_inputs;
+    }
+
+    /// Start a new table for the provided inputs; answers should be added after.
+    void Rebuild(const emp::vector<DATA_T> & in_inputs) {
+      Clear();
+      inputs = in_inputs;
+      is_built = true;
+    }
+
+    void AddAnswer(DATA_T output, mask_t task_bit) { answers[output] |= task_bit; }
+
+    /// Determine which tasks the provided output satisfies.  Tasks sharing this table
+    /// tend to look up the same (latest) output back-to-back, so cache the last result.
+    mask_t Lookup(DATA_T output) {
+      if (!has_last || output != last_output) {
+        auto it = answers.find(output);
+        last_mask = (it == answers.end()) ? 0 : it->second;
+        last_output = output;
+        has_last = true;
+      }
+      return last_mask;
+    }
+  };
+
+  /// \brief Non-templated base for logic tasks so that tasks can find each other and share
+  /// answer tables.
+  class EvalTaskInterface : public Module {
+  public:
+    using org_t = VirtualCPUOrg;
+    using data_t = org_t::data_t;
+    using answer_table_t = TaskAnswerTable<data_t>;
+    using mask_t = answer_table_t::mask_t;
+
+  protected:
+    emp::String inputs_trait = "input";   ///< Name of trait for organism's inputs  (required)
+
+  public:
+    EvalTaskInterface(mabe::MABE & _control, const emp::String & _name, const emp::String & _desc)
+      : Module(_control, _name, _desc) { ; }
+
+    const emp::String & GetInputsTrait() const { return inputs_trait; }
+
+    /// Name of the answer-table trait shared by all tasks reading the same inputs.
+    emp::String GetAnswersTrait() const { return inputs_trait + "_task_answers"; }
+
+    /// Add all outputs that would satisfy this task for the provided inputs to the table.
+    virtual void AddAnswers(const emp::vector<data_t> & inputs, answer_table_t & table,
+                            mask_t task_bit) const = 0;
+  };
+
   /// \brief Generic base class for evaluating an organism on a binary logic task. 
+  ///
+  /// Derived classes provide CalcOneArg(input) or CalcTwoArg(input_a, input_b), returning the
+  /// correct output for the given input(s).
   template <typename DERIVED, size_t NUM_ARGS>
-  class EvalTaskBase : public Module {
+  class EvalTaskBase : public EvalTaskInterface {
   public:
     using derived_t = DERIVED;
     using org_t = VirtualCPUOrg;
@@ -32,7 +122,6 @@ namespace mabe {
     };
 
   protected:
-    emp::String inputs_trait = "input";   ///< Name of trait for organism's inputs  (required)
     emp::String outputs_trait = "output"; ///< Name of trait for organism's outputs (required)
     emp::String fitness_trait = "merit";  ///< Name of trait for organism's fitness (required)
     int pop_id = 0;                       ///< ID of the population to be evaluated
@@ -42,12 +131,84 @@ namespace mabe {
     double reward_value = 1;          ///< Magnitude of the reward bestowed for completion of the task 
     RewardType reward_type = ADD; /// How do we apply the reward to the organism's merit?
 
+    // Trait IDs, resolved in SetupDataMap (before any organism can run an IO instruction).
+    size_t inputs_id = emp::MAX_SIZE_T;
+    size_t outputs_id = emp::MAX_SIZE_T;
+    size_t fitness_id = emp::MAX_SIZE_T;
+    size_t performed_id = emp::MAX_SIZE_T;
+    size_t answers_id = emp::MAX_SIZE_T;
+    bool use_answers = false;         ///< Is a shared answer table available?
+
+    /// All tasks that share an answer table with this one (in module order) and this
+    /// task's bit in that table.
+    emp::vector<emp::Ptr<const EvalTaskInterface>> task_group;
+    mask_t task_bit = 0;
+
+    derived_t & Derived() { return static_cast<derived_t &>(*this); }
+    const derived_t & Derived() const { return static_cast<const derived_t &>(*this); }
+
+    /// Collect all tasks that read the same inputs trait; each gets a bit in the shared table.
+    void SetupTaskGroup() {
+      task_group.resize(0);
+      for (size_t mod_id = 0; mod_id < control.GetNumModules(); ++mod_id) {
+        auto task_ptr = dynamic_cast<const EvalTaskInterface *>(&control.GetModule((int) mod_id));
+        if (task_ptr && task_ptr->GetInputsTrait() == inputs_trait) task_group.push_back(task_ptr);
+      }
+      // Make sure this task is included (e.g., if it was not created through the controller).
+      if (!emp::Has(task_group, emp::Ptr<const EvalTaskInterface>(this))) task_group.push_back(this);
+
+      if (task_group.size() > answer_table_t::MAX_TASKS) {
+        emp::notify::Error("At most ", answer_table_t::MAX_TASKS, " tasks can share the inputs trait '",
+                           inputs_trait, "'; found ", task_group.size(), ".");
+      }
+      const size_t group_pos = emp::FindValue(task_group, emp::Ptr<const EvalTaskInterface>(this));
+      task_bit = mask_t{1} << group_pos;
+    }
+
+    /// Look up all trait IDs in the organism DataMap.
+    void SetupTraitIDs(const emp::DataMap & dm) {
+      inputs_id = dm.GetID(inputs_trait);
+      outputs_id = dm.GetID(outputs_trait);
+      fitness_id = dm.GetID(fitness_trait);
+      performed_id = dm.GetID(performed_trait);
+      use_answers = dm.HasName(GetAnswersTrait());
+      if (use_answers) answers_id = dm.GetID(GetAnswersTrait());
+    }
+
+    /// Make sure the organism's answer table matches its current inputs.
+    answer_table_t & GetAnswerTable(Organism & hw, const emp::vector<data_t> & input_vec) {
+      answer_table_t & table = hw.GetTrait<answer_table_t>(answers_id);
+      if (!table.IsBuiltFor(input_vec)) {
+        table.Rebuild(input_vec);
+        for (size_t i = 0; i < task_group.size(); ++i) {
+          task_group[i]->AddAnswers(input_vec, table, mask_t{1} << i);
+        }
+      }
+      return table;
+    }
+
+    /// Give the organism the reward for this task.
+    void ApplyReward(Organism & hw) {
+      double & fitness = hw.GetTrait<double>(fitness_id);
+      switch(reward_type){
+        case ADD:
+          fitness = fitness + reward_value;
+          break;
+        case MULT:
+          fitness = fitness * reward_value;
+          break;
+        case POW: // new = old * (2 ^ power)
+          fitness = fitness * std::pow(2.0, reward_value);
+          break;
+      }
+    }
+
   public:
     EvalTaskBase(mabe::MABE & _control,
                  emp::String _mod_name="EvalTaskBase",
                  emp::String _task_name = "unnamed",
                  emp::String _desc="Evaluate organism on BASE logic task")
-      : Module(_control, _mod_name, _desc)
+      : EvalTaskInterface(_control, _mod_name, _desc)
       , task_name(_task_name)
       , performed_trait(_task_name + "_performed"){;}
 
@@ -74,115 +235,97 @@ namespace mabe {
       );
     }
   
-    /** Determine if output is the result of applying the given function to input
-        To be overridden by derived class. */
-    virtual bool CheckOneArg(const data_t& /*output*/, const data_t& /*input*/){
-      emp_error("Derived EvalTask class did not define CheckOneArg");
-      return false;
-    }; 
+    /// Determine if output is the result of applying the task's function to input.
+    bool CheckOneArg(const data_t& output, const data_t& input) const {
+      return output == Derived().CalcOneArg(input);
+    }
 
-    /** Determine if input_a OP input_b = output (with OP depending on the derived class)
-        To be overridden by derived class. */
-    virtual bool CheckTwoArg(const data_t& /*output*/, const data_t& /*input_a*/, 
-        const data_t& /*input_b*/){ 
-      emp_error("Derived EvalTask class did not define CheckOneArg");
-      return false;
+    /// Determine if input_a OP input_b = output (with OP depending on the derived class);
+    /// inputs may be used in either order.
+    bool CheckTwoArg(const data_t& output, const data_t& input_a, const data_t& input_b) const {
+      return output == Derived().CalcTwoArg(input_a, input_b) ||
+             output == Derived().CalcTwoArg(input_b, input_a);
     }
 
-    /// Evaluate an organism on the given logic task (assuming only one argument is needed)
-    bool EvaluateOneArg(Organism& hw){
-      bool& task_performed = hw.GetTrait<bool>(performed_trait);
-      if(!task_performed){ // Only do check if org hasn't already performed the task
-        emp::vector<data_t>& input_vec = hw.GetTrait<emp::vector<data_t>>(inputs_trait);
-        emp::vector<data_t>& output_vec = hw.GetTrait<emp::vector<data_t>>(outputs_trait);
-        double original_fitness = hw.GetTrait<double>(fitness_trait);
-        if(input_vec.size() > 0 && output_vec.size() > 0){
-          data_t& output = *output_vec.rbegin(); // Check latest output
-          for(data_t input : input_vec){ // Must check against all inputs
-            if( CheckOneArg(output, input) ){ // Unary check
-              switch(reward_type){
-                case ADD:
-                  hw.SetTrait<double>(fitness_trait, original_fitness + reward_value);
-                  break;
-                case MULT:
-                  hw.SetTrait<double>(fitness_trait, original_fitness * reward_value);
-                  break;
-                case POW: // new = old * (2 ^ power)
-                  hw.SetTrait<double>(fitness_trait, 
-                      original_fitness * std::pow(2.0, reward_value));
-                  break;
-              }
+    /// Add the correct output for each input (or each pair of inputs) to an answer table.
+    void AddAnswers(const emp::vector<data_t> & inputs, answer_table_t & table,
+                    mask_t bit) const override {
+      if constexpr (NUM_ARGS == 1) {
+        for (data_t input : inputs) table.AddAnswer(Derived().CalcOneArg(input), bit);
+      }
+      else if constexpr (NUM_ARGS == 2) {
+        if (inputs.size() < 2) return;
+        for(size_t idx_a = 0; idx_a < inputs.size() - 1; idx_a++){
+          for(size_t idx_b = idx_a + 1; idx_b < inputs.size(); idx_b++){
+            table.AddAnswer(Derived().CalcTwoArg(inputs[idx_a], inputs[idx_b]), bit);
+            table.AddAnswer(Derived().CalcTwoArg(inputs[idx_b], inputs[idx_a]), bit);
+          }
+        }
+      }
+    }
+
+    /// Evaluate an organism on the given logic task, using the shared answer table if
+    /// available and otherwise checking against all inputs (or pairs of inputs).
+    bool EvaluateOrg(Organism& hw){
+      bool& task_performed = hw.GetTrait<bool>(performed_id);
+      if (task_performed) return true; // Only do check if org hasn't already performed the task
+
+      emp::vector<data_t>& input_vec = hw.GetTrait<emp::vector<data_t>>(inputs_id);
+      emp::vector<data_t>& output_vec = hw.GetTrait<emp::vector<data_t>>(outputs_id);
+      if (input_vec.size() < NUM_ARGS || output_vec.size() == 0) return false;
+      const data_t output = output_vec.back(); // Check latest output
+
+      if (use_answers) {
+        task_performed = (GetAnswerTable(hw, input_vec).Lookup(output) & task_bit) != 0;
+      }
+      else if constexpr (NUM_ARGS == 1) {
+        for (data_t input : input_vec) { // Must check against all inputs
+          if (CheckOneArg(output, input)) { task_performed = true; break; }
+        }
+      }
+      else {
+        // Must check all possible pairs of input values
+        for(size_t idx_a = 0; idx_a < input_vec.size() - 1 && !task_performed; idx_a++){
+          for(size_t idx_b = idx_a + 1; idx_b < input_vec.size(); idx_b++){
+            if (CheckTwoArg(output, input_vec[idx_a], input_vec[idx_b])) {
               task_performed = true;
-              return true;
+              break;
             }
           }
         }
       }
+
+      if (task_performed) ApplyReward(hw);
       return task_performed;
+    }
+
+    /// Evaluate an organism on the given logic task (assuming only one argument is needed)
+    bool EvaluateOneArg(Organism& hw){
+      static_assert(NUM_ARGS == 1);
+      return EvaluateOrg(hw);
     } 
 
     /// Evaluate an organism on the given logic task (assuming two arguments are needed)
     bool EvaluateTwoArg(Organism& hw){
-      bool& task_performed = hw.GetTrait<bool>(performed_trait);
-      if(!task_performed){ // Only do check if org hasn't already performed the task
-        emp::vector<data_t>& input_vec = hw.GetTrait<emp::vector<data_t>>(inputs_trait);
-        emp::vector<data_t>& output_vec = hw.GetTrait<emp::vector<data_t>>(outputs_trait);
-        double original_fitness = hw.GetTrait<double>(fitness_trait);
-        if(input_vec.size() > 1 && output_vec.size() > 0){
-          data_t& output = *output_vec.rbegin(); // Fetch latest output
-          // Must check all possible pairs of input values
-          for(size_t idx_a = 0; idx_a < input_vec.size() - 1; idx_a++){
-            for(size_t idx_b = idx_a + 1; idx_b < input_vec.size(); idx_b++){
-              if( CheckTwoArg(output, input_vec[idx_a], input_vec[idx_b]) ){ // Binary check
-                switch(reward_type){
-                  case ADD:
-                    hw.SetTrait<double>(fitness_trait, original_fitness + reward_value);
-                    break;
-                  case MULT:
-                    hw.SetTrait<double>(fitness_trait, original_fitness * reward_value);
-                    break;
-                  case POW: // new = old * (2 ^ power)
-                    hw.SetTrait<double>(fitness_trait, 
-                        original_fitness * std::pow(2.0, reward_value));
-                    break;
-                }
-                task_performed = true;
-                return true;
-              }
-            }
-          }
-        }
-      }
-      return task_performed;
+      static_assert(NUM_ARGS == 2);
+      return EvaluateOrg(hw);
     }
 
     /// Evaluate all organisms in the collection
     double EvaluateCollection(Collection & orgs) {
-      if constexpr (NUM_ARGS == 1){
-        for (Organism & org : orgs) EvaluateOneArg(org);
-      }
-      else if constexpr(NUM_ARGS == 2){
-        for (Organism & org : orgs) EvaluateTwoArg(org);
-      }
+      for (Organism & org : orgs) EvaluateOrg(org);
       return 0;
     }
 
+    /// Run after each IO instruction to check for this task.
+    void Inst_IO(org_t& hw, const org_t::inst_t& /*inst*/){ EvaluateOrg(hw); }
+
     /// Registers the evaluation function in the ActionMap so it can be used by organisms
     void SetupFunc(){
+      static_assert(NUM_ARGS == 1 || NUM_ARGS == 2,
+                    "EvalTaskBase can currently only handle tasks with one or two arguments");
       ActionMap& action_map = control.GetActionMap(pop_id);
-      // Create a function that checks either a unary or binary function 
-      inst_func_t func_task;
-      if constexpr(NUM_ARGS == 1){ // Unary function
-        func_task = [this](org_t& hw, const org_t::inst_t& /*inst*/){ EvaluateOneArg(hw); };
-      }
-      else if constexpr (NUM_ARGS == 2){ // Binary function
-        func_task = [this](org_t& hw, const org_t::inst_t& /*inst*/){ EvaluateTwoArg(hw); };
-      }
-      else{ 
-        emp_error("EvalTaskBase can currently only handle tasks with one or two arguments");
-      }
-      // Add function to action map (can either be unary or binary at this point)
-      action_map.AddFunc<void, org_t&, const org_t::inst_t&>("IO", func_task);
+      org_t::AddInstFunc<&EvalTaskBase::Inst_IO>(action_map, "IO", this);
     }
 
     // Setup member functions associated with this class.
@@ -200,14 +343,23 @@ namespace mabe {
       AddRequiredTrait<emp::vector<data_t>>(outputs_trait);
       AddRequiredTrait<double>(fitness_trait);
       AddOwnedTrait<bool>(performed_trait, "Was the task performed?", false);
+      AddSharedTrait<answer_table_t>(GetAnswersTrait(),
+                                     "Correct outputs for each logic task given current inputs.",
+                                     answer_table_t());
       SetupFunc();
     }
 
+    /// Once the DataMap is final, look up trait IDs and determine which tasks share an answer
+    /// table.  Both are fixed from here on, so organisms may run IO on multiple threads.
+    void SetupDataMap(emp::DataMap & dm) override {
+      SetupTraitIDs(dm);
+      SetupTaskGroup();
+    }
+
     /// When a new organism is placed, set "task performed" trait to false
     void OnPlacement(OrgPosition placement_pos) override{
-      Population & pop = placement_pos.Pop();
-      size_t org_idx = placement_pos.Pos();
-      pop[org_idx].SetTrait<bool>(performed_trait, false);
+      Organism & org = placement_pos.Pop()[placement_pos.Pos()];
+      org.SetTrait<bool>(performed_id, false);
     }
   };
 
@@ -29,9 +29,9 @@ namespace mabe {
 
     ~EvalTaskEqu() { }
     
-    /// Check if the passed output is equal to input_a EQU input_b  
-    bool CheckTwoArg(const data_t& output, const data_t& input_a, const data_t& input_b){
-      return output == ((input_a & input_b) | ~(input_a | input_b));
+    /// Calculate the correct output: bitwise EQU of the two inputs
+    data_t CalcTwoArg(const data_t& input_a, const data_t& input_b) const {
+      return (input_a & input_b) | ~(input_a | input_b);
     }
   };
 
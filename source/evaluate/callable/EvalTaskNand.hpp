@@ -22,9 +22,9 @@ namespace mabe {
                 emp::String desc="Evaluate organism on NAND logic task")
       : EvalTaskBase(control, name, "nand", desc){;}
 
-    /// Check if the passed output is equal to input_a NAND input_b  
-    bool CheckTwoArg(const data_t& output, const data_t& input_a, const data_t& input_b){
-      return output == ~(input_a & input_b);
+    /// Calculate the correct output: bitwise NAND of the two inputs
+    data_t CalcTwoArg(const data_t& input_a, const data_t& input_b) const {
+      return ~(input_a & input_b);
     }
   };
     
@@ -22,9 +22,9 @@ namespace mabe {
                 emp::String desc="Evaluate organism on NOT logic task")
       : EvalTaskBase(control, name, "not", desc){;}
 
-    /// Check if the passed output is bitwise NOT of the passed input  
-    bool CheckOneArg(const data_t& output, const data_t& input){
-      return output == ~input;
+    /// Calculate the correct output: bitwise NOT of the input
+    data_t CalcOneArg(const data_t& input) const {
+      return ~input;
     }
   };
     
@@ -25,9 +25,9 @@ namespace mabe {
 
     ~EvalTaskXor() { }
     
-    /// Check if the passed output is equal to input_a XOR input_b  
-    bool CheckTwoArg(const data_t& output, const data_t& input_a, const data_t& input_b){
-      return output == (input_a ^ input_b);
+    /// Calculate the correct output: bitwise XOR of the two inputs
+    data_t CalcTwoArg(const data_t& input_a, const data_t& input_b) const {
+      return input_a ^ input_b;
     }
   };
 
@@ -5,12 +5,29 @@
  *
  *  @file  EvalMancala.hpp
  *  @brief MABE Evaluation module that has organisms play Mancala.
+ *
+ *  Organisms can face random moves or each other.  Organism-vs-organism matches are laid out
+ *  by a match scheduler, either as a full round robin or as a set of random pairings where each
+ *  organism faces num_opponents others (with an odd number of organisms, the one left out of
+ *  each random pairing gets a random opponent).  The schedule is split into rounds in which no
+ *  organism appears twice, so the matches in a round can be played on separate threads, each
+ *  with its own pooled game state.  Results are written into per-match slots and then summed
+ *  into organism traits in schedule order, so trait values never depend on the thread count.
+ *
+ *  If cache_matches is on, results are remembered for each pair of organisms and reused for as
+ *  long as both organisms remain alive.  This assumes that organisms play deterministically.
  */
 
 #ifndef MABE_EVAL_MANCALA_HPP
 #define MABE_EVAL_MANCALA_HPP
 
+#include <map>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
 #include "emp/games/Mancala.hpp"
+#include "emp/math/random_utils.hpp"
 
 #include "../../core/MABE.hpp"
 #include "../../core/Module.hpp"
@@ -31,10 +48,59 @@ namespace mabe {
       RANDOM_MOVES,     // Opponent will always choose a random, legal move.
       AI,               // Opponent is a human-crafted AI.
       RANDOM_ORG,       // Opponent is a random organism from the population.
+      ROUND_ROBIN,      // Every organism plays every other organism.
       UNKNOWN
     };
 
     Opponent opponent_type;
+    size_t num_opponents = 1;   ///< For RANDOM_ORG, how many opponents should each organism face?
+    size_t num_threads = 1;     ///< Threads to use for org-vs-org matches (0 = all available)
+    bool cache_matches = false; ///< Reuse results for pairs of organisms that are unchanged?
+
+  public:
+    /// Both games between a pair of organisms, with results from each player's perspective.
+    struct Match {
+      size_t player0 = 0;       ///< Index of first player in the organisms being evaluated.
+      size_t player1 = 0;       ///< Index of second player.
+      size_t serial0 = 0;       ///< Serial number of the first player (for caching)
+      size_t serial1 = 0;       ///< Serial number of the second player (for caching)
+      bool cached = false;      ///< Were these results pulled from the cache?
+      size_t scores0 = 0, scores1 = 0, errors0 = 0, errors1 = 0;
+    };
+
+  private:
+    emp::vector<Match> schedule;        ///< All matches to be played this evaluation.
+    emp::vector<size_t> round_starts;   ///< Position in schedule where each round begins (+ end)
+    emp::vector<emp::Mancala> game_pool; ///< One reusable game state per worker thread.
+
+    /// Serial numbers identify organisms since their placement; pointers can be reused.
+    std::unordered_map<const Organism *, size_t> org_serials;
+    size_t next_serial = 0;
+    std::map<std::pair<size_t,size_t>, Match> match_cache;
+
+    size_t GetSerial(const Organism & org) {
+      auto it = org_serials.find(&org);
+      if (it != org_serials.end()) return it->second;
+      return org_serials[&org] = next_serial++;
+    }
+
+    /// Make sure there is a game state ready for each worker thread.
+    void PrepGamePool(size_t pool_size) {
+      if (game_pool.size() < pool_size) game_pool.resize(pool_size, emp::Mancala(true));
+    }
+
+    /// Load the board into an existing input vector from the current player's perspective,
+    /// rather than building a fresh vector for every move.
+    static void FillInput(emp::Mancala & game, emp::vector<double> & input) {
+      const auto & cur_side = game.GetCurSide();
+      const auto & other_side = game.GetOtherSide();
+      const size_t side_size = cur_side.size();
+      input.resize(side_size * 2);
+      for (size_t i = 0; i < side_size; i++) {
+        input[i] = (double) cur_side[i];
+        input[i+side_size] = (double) other_side[i];
+      }
+    }
 
   public:
     EvalMancala(mabe::MABE & control,
@@ -64,19 +130,35 @@ namespace mabe {
       LinkMenu(opponent_type, "opponent_type", "Which type of opponent should organisms face?",
                RANDOM_MOVES, "random", "Always choose a random, legal move.",
                AI, "ai", "Human supplied (but not very good) AI",
-               RANDOM_ORG, "random_org", "Pick another random organism from collection."
+               RANDOM_ORG, "random_org", "Pick another random organism from collection.",
+               ROUND_ROBIN, "round_robin", "Play against every other organism in collection."
       );
+      LinkVar(num_opponents, "num_opponents", "For random_org, how many opponents should each org face?");
+      LinkVar(num_threads, "num_threads", "Threads for org-vs-org matches (0 = all available)");
+      LinkVar(cache_matches, "cache_matches", "Reuse match results while both organisms are unchanged?");
+    }
+
+    void SetupModule() override {
+      if (num_threads == 0) num_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+      PrepGamePool(num_threads);
+    }
+
+    void OnPlacement(OrgPosition pos) override {
+      if (cache_matches) org_serials[pos.OrgPtr().Raw()] = next_serial++;
+    }
+    void BeforeDeath(OrgPosition pos) override {
+      if (cache_matches) org_serials.erase(pos.OrgPtr().Raw());
     }
 
     // Determine the next move of an organism.
     size_t EvalMove(emp::Mancala & game, Organism & org) {
       // Setup the hardware with proper inputs.
-      input_trait(org) = game.AsVectorInput(game.GetCurPlayer());
+      FillInput(game, input_trait(org));
 
       // Run the code.
       org.GenerateOutput();
 
-      emp::vector<double> results = output_trait(org);
+      const emp::vector<double> & results = output_trait(org);
 
       // Determine the chosen move.
       size_t best_move = 0;
@@ -131,7 +213,9 @@ namespace mabe {
     /// @param os Output stream for any extra ouput. (default=cout)
     Results EvalGame(const mancala_ai_t & player0, const mancala_ai_t & player1, bool cur_player=0,
                     bool verbose=false, std::ostream & os=std::cout) {
-      emp::Mancala game(cur_player==0);
+      PrepGamePool(1);
+      emp::Mancala & game = game_pool[0];
+      game = emp::Mancala(cur_player==0);
       size_t round = 0, errors = 0;
       while (game.IsDone() == false) {
         // Determine the current player and their move.
@@ -211,6 +295,170 @@ namespace mabe {
       return EvalGame(ToOrgFun(org), human_fun, start_player, true);
     }
 
+    /// Play a game between two organisms using a pooled game state, tracking errors for both.
+    /// Player results are added into the provided match.
+    void PlayMatchGame(emp::Mancala & game, Organism & org0, Organism & org1,
+                       bool cur_player, Match & match) {
+      game = emp::Mancala(cur_player==0);
+      while (game.IsDone() == false) {
+        size_t best_move = EvalMove(game, cur_player ? org1 : org0);
+        while (game.GetCurSide()[best_move] == 0) {  // Cannot make a move into an empty pit!
+          if (cur_player == 0) match.errors0++;
+          else match.errors1++;
+          if (++best_move > 5) best_move = 0;
+        }
+        bool go_again = game.DoMove(cur_player, best_move);
+        if (!go_again) cur_player = !cur_player;
+      }
+      match.scores0 += game.ScoreA();
+      match.scores1 += game.ScoreB();
+    }
+
+    /// Lay out the matches to play among num_orgs organisms, grouped into rounds where no
+    /// organism plays twice.
+    void BuildSchedule(size_t num_orgs) {
+      schedule.resize(0);
+      round_starts.resize(0);
+      if (num_orgs < 2) { round_starts.push_back(0); return; }
+
+      if (opponent_type == ROUND_ROBIN) {
+        // Circle method: the last slot stays fixed while the others rotate each round.  With an
+        // odd number of organisms, the extra slot is a bye.
+        const size_t num_slots = num_orgs + (num_orgs & 1);
+        const size_t num_rotate = num_slots - 1;
+        for (size_t round = 0; round < num_rotate; ++round) {
+          round_starts.push_back(schedule.size());
+          for (size_t i = 0; i < num_slots/2; ++i) {
+            size_t id0 = (i == 0) ? num_rotate : (round + i) % num_rotate;
+            size_t id1 = (round + num_rotate - i) % num_rotate;
+            if (id0 >= num_orgs || id1 >= num_orgs) continue;  // Bye.
+            schedule.push_back(Match{id0, id1});
+          }
+        }
+      } else {
+        // Each round is a random pairing of the organisms.
+        emp::vector<size_t> order(num_orgs);
+        for (size_t i = 0; i < num_orgs; ++i) order[i] = i;
+        for (size_t round = 0; round < num_opponents; ++round) {
+          round_starts.push_back(schedule.size());
+          emp::Shuffle(control.GetRandom(), order);
+          for (size_t i = 1; i < num_orgs; i += 2) {
+            schedule.push_back(Match{order[i-1], order[i]});
+          }
+          // With an odd number of organisms, the one left over faces a random other organism;
+          // that opponent is already playing this round, so the extra match gets its own round.
+          if (num_orgs & 1) {
+            const size_t leftover = order[num_orgs-1];
+            const size_t opponent = order[control.GetRandom().GetUInt(num_orgs-1)];
+            round_starts.push_back(schedule.size());
+            schedule.push_back(Match{leftover, opponent});
+          }
+        }
+      }
+      round_starts.push_back(schedule.size());
+    }
+
+    const emp::vector<Match> & GetSchedule() const { return schedule; }
+    const emp::vector<size_t> & GetRoundStarts() const { return round_starts; }
+
+    /// Play all of the matches in a single round, spreading them across the worker threads.
+    void PlayRound(const emp::vector<emp::Ptr<Organism>> & players, size_t start, size_t end) {
+      const size_t num_workers = std::min(num_threads, end - start);
+      PrepGamePool(num_workers);
+      auto run_worker = [this, &players, start, end, num_workers](size_t worker_id) {
+        emp::Mancala & game = game_pool[worker_id];
+        for (size_t match_id = start + worker_id; match_id < end; match_id += num_workers) {
+          Match & match = schedule[match_id];
+          if (match.cached) continue;
+          PlayMatchGame(game, *players[match.player0], *players[match.player1], 0, match);
+          PlayMatchGame(game, *players[match.player0], *players[match.player1], 1, match);
+        }
+      };
+
+      if (num_workers <= 1) { run_worker(0); return; }
+
+      emp::vector<std::thread> workers;
+      for (size_t worker_id = 1; worker_id < num_workers; ++worker_id) {
+        workers.emplace_back(run_worker, worker_id);
+      }
+      run_worker(0);
+      for (std::thread & worker : workers) worker.join();
+    }
+
+    /// Evaluate organisms by having them play against each other.
+    double EvaluateTournament(const Collection & alive_collect) {
+      emp::vector<emp::Ptr<Organism>> players;
+      for (Organism & org : alive_collect) players.push_back(&org);
+      return EvaluateTournament(players);
+    }
+
+    /// Evaluate a specific set of players against each other; return the highest fitness.
+    double EvaluateTournament(const emp::vector<emp::Ptr<Organism>> & players) {
+      BuildSchedule(players.size());
+
+      // Pull any results we already know from the cache.
+      if (cache_matches) {
+        for (Match & match : schedule) {
+          match.serial0 = GetSerial(*players[match.player0]);
+          match.serial1 = GetSerial(*players[match.player1]);
+          // Both games are played in each match, so a reversed pairing has the same results.
+          auto it = match_cache.find({match.serial0, match.serial1});
+          if (it != match_cache.end()) {
+            const Match & cached = it->second;
+            match.scores0 = cached.scores0;  match.scores1 = cached.scores1;
+            match.errors0 = cached.errors0;  match.errors1 = cached.errors1;
+            match.cached = true;
+          } else if ((it = match_cache.find({match.serial1, match.serial0})) != match_cache.end()) {
+            const Match & cached = it->second;
+            match.scores0 = cached.scores1;  match.scores1 = cached.scores0;
+            match.errors0 = cached.errors1;  match.errors1 = cached.errors0;
+            match.cached = true;
+          }
+        }
+      }
+
+      for (size_t round = 0; round + 1 < round_starts.size(); ++round) {
+        PlayRound(players, round_starts[round], round_starts[round+1]);
+      }
+
+      // Total up results in schedule order so that they are independent of thread count.
+      for (emp::Ptr<Organism> org_ptr : players) {
+        scoreA_trait(*org_ptr) = 0.0;
+        scoreB_trait(*org_ptr) = 0.0;
+        error_trait(*org_ptr) = 0.0;
+        fitness_trait(*org_ptr) = 0.0;
+      }
+      for (const Match & match : schedule) {
+        Results results0{match.scores0, match.scores1, match.errors0};
+        Results results1{match.scores1, match.scores0, match.errors1};
+        Organism & org0 = *players[match.player0];
+        Organism & org1 = *players[match.player1];
+        scoreA_trait(org0) += results0.scoreA;
+        scoreB_trait(org0) += results0.scoreB;
+        error_trait(org0) += results0.num_errors;
+        fitness_trait(org0) += results0.CalcFitness();
+        scoreA_trait(org1) += results1.scoreA;
+        scoreB_trait(org1) += results1.scoreB;
+        error_trait(org1) += results1.num_errors;
+        fitness_trait(org1) += results1.CalcFitness();
+      }
+
+      // Keep only the pairs seen this update; anything else involves an organism that is gone.
+      if (cache_matches) {
+        match_cache.clear();
+        for (const Match & match : schedule) {
+          match_cache[{match.serial0, match.serial1}] = match;
+        }
+      }
+
+      double max_fitness = 0.0;
+      for (size_t i = 0; i < players.size(); ++i) {
+        const double fitness = fitness_trait(*players[i]);
+        if (i == 0 || fitness > max_fitness) max_fitness = fitness;
+      }
+      return max_fitness;
+    }
+
     /// Trace the evaluation of an organism, sending output to a specified stream.
     void TraceEval(Organism & org, std::ostream & os) {
       EvalGame(org, control.GetRandom(), 0, true, os);
@@ -224,14 +472,17 @@ namespace mabe {
     }
 
     double Evaluate(const Collection & orgs) {
-      // Determine the type of competitions to perform.
-      // ==> @CAO: For the moment, just doing a random opponent!!
-
       // Loop through the living organisms in the target collection to evaluate each.
       mabe::Collection alive_collect( orgs.GetAlive() );
 
       control.Verbose(" - ", alive_collect.GetSize(), " organisms found.");
 
+      // Organisms playing each other go through the match scheduler.
+      // ==> @CAO: The AI opponent is not yet hooked up, so it falls back to random moves.
+      if (opponent_type == RANDOM_ORG || opponent_type == ROUND_ROBIN) {
+        return EvaluateTournament(alive_collect);
+      }
+
       size_t org_count = 0;
       double max_fitness = 0.0;
       for (Organism & org : alive_collect) {
@@ -25,17 +25,44 @@
 #include "../../orgs/VirtualCPUOrg.hpp"
 #include "../../tools/StateGrid.hpp"
 
+#include <algorithm>
+
 #include "emp/io/File.hpp"
 #include "emp/bits/BitVector.hpp"
 #include "emp/tools/String.hpp"
 
 namespace mabe {
 
+  /// \brief Tracks which tiles of a map have been visited.
+  ///
+  /// Each tile holds the epoch in which it was last visited, so clearing all marks only
+  /// requires advancing the epoch rather than touching every tile.
+  class VisitedTiles {
+  private:
+    emp::vector<uint32_t> stamps; ///< Epoch in which each tile was last visited.
+    uint32_t epoch = 1;           ///< Current epoch; tiles stamped with it are visited.
+
+  public:
+    size_t GetSize() const { return stamps.size(); }
+    bool operator[](size_t id) const { return stamps[id] == epoch; }
+
+    void Set(size_t id, bool value=true) { stamps[id] = value ? epoch : 0; }
+    void Resize(size_t new_size) { stamps.resize(new_size, 0); }
+
+    /// Mark all tiles as unvisited.
+    void Clear() {
+      if (++epoch == 0) {  // On wrap-around, old stamps could match again; wipe them.
+        std::fill(stamps.begin(), stamps.end(), 0);
+        epoch = 1;
+      }
+    }
+  };
+
   /// \brief State of a single organism's progress on the path following task
   struct PathFollowState{
     bool initialized;             ///< Flag indicating if this state has been initialized
     size_t cur_map_idx;           ///< Index of the map being traversed 
-    emp::BitVector visited_tiles; ///< A mask showing which tiles have been previously visited
+    VisitedTiles visited_tiles;   ///< Marks showing which tiles have been previously visited
     StateGridStatus status;  ///< Stores position, direction, and interfaces with grid 
     double raw_score;             /**< Number of unique valid tiles visited minus the number
                                        of steps taken off the path (not unique) */
@@ -71,9 +98,14 @@ namespace mabe {
     }
   };
 
+  /// \brief The cue an organism receives when sensing a tile
+  enum class PathCue : uint8_t { EMPTY=0, FORWARD, LEFT, RIGHT };
+
   /// \brief Information of a single path that was loaded from file
   struct PathData{
     StateGrid grid;  ///< The tile data of the path and surrounding emptiness 
+    emp::vector<PathCue> tile_cues;  ///< Flat (row-major) cue for each tile
+    emp::vector<int8_t> tile_scores; ///< Flat reward for first visit (+1 on path, -1 off)
     size_t start_x;       ///< X coordinate of starting position
     size_t start_y;       ///< Y coordinate of starting position
     int start_facing;     /**< Facing direction for new organisms. 
@@ -199,6 +231,23 @@ namespace mabe {
       if(!has_finish){
         emp_error("Error! Map does not have a finish tile! (character: X)");
       }
+      // Precompute flat cue and score arrays so lookups during evaluation are a single index
+      const size_t map_size = path_data.grid.GetSize();
+      path_data.tile_cues.resize(map_size);
+      path_data.tile_scores.resize(map_size);
+      for(size_t tile_idx = 0; tile_idx < map_size; ++tile_idx){
+        const int tile_id = path_data.grid.GetState(tile_idx);
+        path_data.tile_scores[tile_idx] = (tile_id == Tile::EMPTY) ? -1 : 1;
+        switch(tile_id){
+          case Tile::EMPTY: path_data.tile_cues[tile_idx] = PathCue::EMPTY; break;
+          case Tile::LEFT:  path_data.tile_cues[tile_idx] = PathCue::LEFT; break;
+          case Tile::RIGHT: path_data.tile_cues[tile_idx] = PathCue::RIGHT; break;
+          case Tile::FORWARD: case Tile::FINISH:
+          case Tile::START_UP: case Tile::START_DOWN: case Tile::START_LEFT: case Tile::START_RIGHT:
+            path_data.tile_cues[tile_idx] = PathCue::FORWARD; break;
+          default: path_data.tile_cues[tile_idx] = PathCue::EMPTY; break;
+        }
+      }
       std::cout << "Map #" << (path_data_vec.size() - 1) << " is " 
         << path_data.grid.GetWidth() << "x" << path_data.grid.GetHeight() << ", with " 
         << path_data.path_length << " path tiles!" << std::endl;
@@ -218,7 +267,7 @@ namespace mabe {
       if(reset_map) state.cur_map_idx = rand.GetUInt(path_data_vec.size());;
       emp_assert(path_data_vec.size() > state.cur_map_idx, "Cannot initialize state before loading the map!");
       state.visited_tiles.Resize(path_data_vec[state.cur_map_idx].grid.GetSize()); 
-      state.visited_tiles.Clear();
+      state.visited_tiles.Clear(); // O(1): just advances the epoch
       state.status.Set(
         path_data_vec[state.cur_map_idx].start_x,
         path_data_vec[state.cur_map_idx].start_y,
@@ -265,12 +314,12 @@ namespace mabe {
     /// On new tile of path: +1
     /// On previously-visited tile of path: 0
     double GetCurrentPosScore(const PathFollowState& state) const{
-      // If we're off the path, decrement score
-      int tile_id = state.status.Scan(GetCurPath(state).grid);
-      if(tile_id == Tile::EMPTY) return -1;
-      // On a new tile of the path, add score (forward, left, right, finish)
-      else if(!state.visited_tiles[ state.status.GetIndex(GetCurPath(state).grid) ]) return 1;
-      return 0; // Otherwise we've seen this tile of the path before, do nothing
+      const PathData& path = GetCurPath(state);
+      const size_t tile_idx = state.status.GetIndex(path.grid);
+      // Off the path is always -1; a path tile is +1 only if it is new to this organism
+      const int8_t score = path.tile_scores[tile_idx];
+      if(score > 0 && state.visited_tiles[tile_idx]) return 0;
+      return score;
     }
 
     /// Move the organism in the direction it is facing, then update and return score
@@ -301,37 +350,12 @@ namespace mabe {
     //  organism's first interaction with the path, so we may need to initialize it
     uint32_t Sense(PathFollowState& state) { 
       if(!state.initialized) InitializeState(state);
-      switch(state.status.Scan(GetCurPath(state).grid)){
-        case Tile::EMPTY:
-          return state.empty_cue;
-          break;
-        case Tile::LEFT:
-          return state.left_cue;
-          break;
-        case Tile::RIGHT:
-          return state.right_cue;
-          break;
-        case Tile::FORWARD:
-          return state.forward_cue;
-          break;
-        case Tile::START_UP:
-          return state.forward_cue;
-          break;
-        case Tile::START_DOWN:
-          return state.forward_cue;
-          break;
-        case Tile::START_LEFT:
-          return state.forward_cue;
-          break;
-        case Tile::START_RIGHT:
-          return state.forward_cue;
-          break;
-        case Tile::FINISH:
-          return state.forward_cue;
-          break;
-       default:
-          return state.empty_cue;
-          break;
+      const PathData& path = GetCurPath(state);
+      switch(path.tile_cues[state.status.GetIndex(path.grid)]){
+        case PathCue::FORWARD: return state.forward_cue;
+        case PathCue::LEFT:    return state.left_cue;
+        case PathCue::RIGHT:   return state.right_cue;
+        case PathCue::EMPTY:   return state.empty_cue;
       }
       return state.empty_cue;
     }
@@ -351,6 +375,13 @@ namespace mabe {
                                             task */
     int pop_id = 0;              /**< ID of the population to evaluate 
                                          (and provide instructions to) */
+    size_t state_id = emp::MAX_SIZE_T; ///< DataMap ID of state trait (set in SetupDataMap)
+    size_t score_id = emp::MAX_SIZE_T; ///< DataMap ID of score trait (set in SetupDataMap)
+
+    /// Fetch an organism's path follow state.
+    PathFollowState & GetState(VirtualCPUOrg & hw) {
+      return hw.GetTrait<PathFollowState>(state_id);
+    }
 
   public:
     EvalPathFollow(mabe::MABE & control,
@@ -385,6 +416,12 @@ namespace mabe {
       SetupInstructions();
     }
 
+    /// Look up trait IDs before any organism can run a path-following instruction.
+    void SetupDataMap(emp::DataMap & dm) override {
+      state_id = dm.GetID(state_trait);
+      score_id = dm.GetID(score_trait);
+    }
+
     /// Package path following actions (e.g., move, turn) into instructions and provide 
     /// them to the organisms via ActionMap
     void SetupInstructions(){
@@ -392,8 +429,8 @@ namespace mabe {
       { // Move
         inst_func_t func_move = 
           [this](VirtualCPUOrg& hw, const VirtualCPUOrg::inst_t& /*inst*/){
-            double score = evaluator.Move(hw.GetTrait<PathFollowState>(state_trait));
-            hw.SetTrait<double>(score_trait, score);
+            double score = evaluator.Move(GetState(hw));
+            hw.SetTrait<double>(score_id, score);
           };
         action_map.AddFunc<void, VirtualCPUOrg&, const VirtualCPUOrg::inst_t&>(
             "sg-move", func_move);
@@ -401,8 +438,8 @@ namespace mabe {
       { // Move backward
         inst_func_t func_move_back = 
           [this](VirtualCPUOrg& hw, const VirtualCPUOrg::inst_t& /*inst*/){
-            double score = evaluator.Move(hw.GetTrait<PathFollowState>(state_trait), -1);
-            hw.SetTrait<double>(score_trait, score);
+            double score = evaluator.Move(GetState(hw), -1);
+            hw.SetTrait<double>(score_id, score);
           };
         action_map.AddFunc<void, VirtualCPUOrg&, const VirtualCPUOrg::inst_t&>(
             "sg-move-back", func_move_back);
@@ -410,7 +447,7 @@ namespace mabe {
       { // Rotate right 
         inst_func_t func_rotate_right = 
           [this](VirtualCPUOrg& hw, const VirtualCPUOrg::inst_t& /*inst*/){
-            evaluator.RotateRight(hw.GetTrait<PathFollowState>(state_trait));
+            evaluator.RotateRight(GetState(hw));
           };
         action_map.AddFunc<void, VirtualCPUOrg&, const VirtualCPUOrg::inst_t&>(
             "sg-rotate-r", func_rotate_right);
@@ -418,7 +455,7 @@ namespace mabe {
       { // Rotate left 
         inst_func_t func_rotate_left = 
           [this](VirtualCPUOrg& hw, const VirtualCPUOrg::inst_t& /*inst*/){
-            evaluator.RotateLeft(hw.GetTrait<PathFollowState>(state_trait));
+            evaluator.RotateLeft(GetState(hw));
           };
         action_map.AddFunc<void, VirtualCPUOrg&, const VirtualCPUOrg::inst_t&>(
             "sg-rotate-l", func_rotate_left);
@@ -426,7 +463,7 @@ namespace mabe {
       { // Sense 
         inst_func_t func_sense = 
           [this](VirtualCPUOrg& hw, const VirtualCPUOrg::inst_t& inst){
-            uint32_t val = evaluator.Sense(hw.GetTrait<PathFollowState>(state_trait));
+            uint32_t val = evaluator.Sense(GetState(hw));
             size_t reg_idx = inst.nop_vec.empty() ? 1 : inst.nop_vec[0];
             hw.regs[reg_idx] = val;
           };
@@ -22,12 +22,11 @@
 #include "emp/games/SudokuAnalyzer.hpp"
 #include "emp/tools/String.hpp"
 
-#include "../../core/MABE.hpp"
-#include "../../core/Module.hpp"
+#include "../../core/EvalModule.hpp"
 
 namespace mabe {
 
-  class EvalSudoku : public Module {
+  class EvalSudoku : public EvalModule<EvalSudoku> {
   private:
     emp::SudokuAnalyzer analyzer;
 
@@ -45,22 +44,34 @@ namespace mabe {
 
     OwnedTrait<double> match_trait{this,      "puz_match",   "How well does this puzzle match a target?"};
 
+    /// All of the results from analyzing a single starting board.
+    struct BoardResults {
+      bool loaded = false;
+      double solvable = 0.0;
+      double length = 0.0;
+      double diverse = 0.0;
+      double empty = 0.0;
+      double match = 0.0;
+      double score = 0.0;
+      emp::vector<double> move_counts;
+    };
+    EvalCache<emp::vector<size_t>, BoardResults> board_cache{this};
 
   public:
     EvalSudoku(mabe::MABE & control,
                emp::String name="EvalSudoku",
                emp::String desc="Evaluate states for the qualities of the Sudoku game they produce.")
-      : Module(control, name, desc)
+      : EvalModule(control, name, desc)
     {
-      SetEvaluateMod(true);
     }
     ~EvalSudoku() { }
 
+    /// Analysis depends only on the starting board (and fixed target), so results can be cached.
+    bool IsDeterministic() const override { return true; }
+
     // Setup member functions associated with this class.
     static void InitType(emplode::TypeInfo & info) {
-      info.AddMemberFunction("EVAL",
-                             [](EvalSudoku & mod, Collection list) { return mod.Evaluate(list); },
-                             "Evaluate the scores for one or more Sudoku boards.");
+      EvalModule<EvalSudoku>::InitType(info);
       info.AddMemberFunction("PRINT",
                              [](EvalSudoku & mod, Collection list) { return mod.Print(list); },
                              "Print one or more Sudoku boards.");
@@ -91,7 +102,33 @@ namespace mabe {
       return count;
     }
 
-    double Evaluate(Collection orgs) {
+    /// Analyze a single starting board.
+    BoardResults AnalyzeBoard(std::span<size_t> genome) {
+      BoardResults results;
+      results.move_counts.resize(emp::SudokuAnalyzer::GetNumMoveTypes(), 0.0);
+
+      // If load fails, leave results at zero (illegal starting position!)
+      if (!analyzer.Load(genome)) return results;
+
+      auto profile = analyzer.CalcProfile();
+      bool solved = analyzer.IsSolved();
+
+      results.loaded = true;
+      results.solvable = solved;
+      results.length = profile.size();
+      results.diverse = profile.CountTypes();
+      results.empty = solved ? std::count(genome.begin(), genome.end(), 0) : 0.0;
+      results.match = static_cast<double>(TestTarget(analyzer.GetValues()));
+
+      for (size_t move_id = 0; move_id < emp::SudokuAnalyzer::GetNumMoveTypes(); ++move_id) {
+        results.move_counts[move_id] = solved ? profile.CountMoves(move_id) : 0.0;
+      }
+
+      results.score = profile.CalcScore() + (solved ? 1000.0 : 0) + TestTarget(analyzer.GetValues())*75.0 - TestTarget(genome)*25;
+      return results;
+    }
+
+    double EvaluateCollection(const Collection & orgs) override {
       emp_assert(control.GetNumPopulations() >= 1);
 
       // Evaluate each organism.
@@ -102,43 +139,25 @@ namespace mabe {
         // Make sure this organism has its genome ready for us to access.
         org.GenerateOutput();
 
-        // Load the Sudoku board.
-        std::span<size_t> genome = states_trait(org); // GetTrait<size_t>(SharedData().genome_name, SharedData().genome_size);
-        if (analyzer.Load(genome)) {
-          auto profile = analyzer.CalcProfile();
-          bool solved = analyzer.IsSolved();
-
-          // Set stats for this organism.
-          solve_trait(org) = solved;
-          length_trait(org) = profile.size();
-          diverse_trait(org) = profile.CountTypes();
-          empty_trait(org) = solved ? std::count(genome.begin(), genome.end(), 0) : 0.0;
-          match_trait(org) = static_cast<double>(TestTarget(analyzer.GetValues()));
-
-          for (size_t move_id = 0; move_id < emp::SudokuAnalyzer::GetNumMoveTypes(); ++move_id) {
-            count_trait(org)[move_id] = solved ? profile.CountMoves(move_id) : 0.0;
-          }
-
-          double score = profile.CalcScore() + (solved ? 1000.0 : 0) + TestTarget(analyzer.GetValues())*75.0 - TestTarget(genome)*25;
-          score_trait(org) = score;
-
-          if (score > max_score || !max_org) {
-            max_score = score;
-            max_org = &org;
-          }
+        // Analyze the Sudoku board (or reuse the analysis of an identical board).
+        std::span<size_t> genome = states_trait(org);
+        const BoardResults & results =
+          board_cache.Get(genome, [this,genome](){ return AnalyzeBoard(genome); });
+
+        // Set stats for this organism.
+        solve_trait(org) = results.solvable;
+        length_trait(org) = results.length;
+        diverse_trait(org) = results.diverse;
+        empty_trait(org) = results.empty;
+        match_trait(org) = results.match;
+        for (size_t move_id = 0; move_id < emp::SudokuAnalyzer::GetNumMoveTypes(); ++move_id) {
+          count_trait(org)[move_id] = results.move_counts[move_id];
         }
+        score_trait(org) = results.score;
 
-        // Otherwise, if load failed, indicate so in traits (illegal starting position!)
-        else {
-          solve_trait(org) = false;
-          length_trait(org) = 0.0;
-          diverse_trait(org) = 0.0;
-          empty_trait(org) = 0.0;
-          match_trait(org) = 0.0;
-          for (size_t move_id = 0; move_id < emp::SudokuAnalyzer::GetNumMoveTypes(); ++move_id) {
-            count_trait(org)[move_id] = 0.0;
-          }
-          score_trait(org) = 0.0;
+        if (results.loaded && (results.score > max_score || !max_org)) {
+          max_score = results.score;
+          max_org = &org;
         }
       }
 
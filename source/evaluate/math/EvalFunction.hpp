@@ -5,16 +5,25 @@
  *
  *  @file  EvalFunction.hpp
  *  @brief MABE Evaluation module rates organism's ability to perform a specified math function.
- * 
+ *
  *  This module specifies a function that agents are then evaluated based on how well they perform
  *  the function.
+ *
+ *  All test cases are stored as a column-major input matrix (all values for the first input,
+ *  followed by all values for the second input, etc.)  Organisms that override
+ *  OrgType::GenerateOutputBatch() are given the full matrix at once and fill in an output for
+ *  every test case.  All other organisms fall back to having each input trait set and
+ *  GenerateOutput() called, one test case at a time.
  */
 
 #ifndef MABE_EVAL_FUNCTION_HPP
 #define MABE_EVAL_FUNCTION_HPP
 
-#include "emp/base/array.hpp"
+#include <cmath>
+#include <span>
+
 #include "emp/base/notify.hpp"
+#include "emp/data/DataMap.hpp"
 #include "emp/data/Datum.hpp"
 #include "emp/math/constants.hpp"
 
@@ -33,8 +42,7 @@ namespace mabe {
     emp::String fitness_trait = "fitness";      ///< Trait for combined fitness (#tests - error sum)
 
     // Track the DataMap ID for each trait or trait set.
-
-    emp::array<size_t, MAX_INPUTS> input_ids;
+    emp::vector<size_t> input_ids;
     size_t output_id = emp::MAX_SIZE_T;
     size_t errors_id = emp::MAX_SIZE_T;
     size_t fitness_id = emp::MAX_SIZE_T;
@@ -42,15 +50,33 @@ namespace mabe {
     emp::String function = "input1 * 3 + 5*input2"; ///< Function to specify target output.
 
     /// Test values of each input in order, separated by a ';'
-    //emp::String test_summary = "0:100; 100:-1:0"
-    emp::String case_ids = 0:100;
-    emp::String test_summary = "case_id; (case_id*7)%100";
+    emp::String test_summary = "0:100; 100:0:-1";
 
     emp::vector<emp::String> input_names;   ///< Names of individual input traits.
-    std::function<emp::Datum( const emp::DataMap & )> fit_fun;
-    emp::vector<emp::vector<double>> test_values;
-    emp::vector<double> target_results;
-    size_t num_tests = emp::MAX_SIZE_T;
+    emp::vector<double> test_inputs;        ///< Column-major matrix of inputs (num_tests per input)
+    emp::vector<double> target_results;     ///< Expected output for each test case.
+    emp::vector<double> batch_outputs;      ///< Pre-allocated outputs for batch evaluation.
+    size_t num_tests = 0;
+
+    /// Convert a comma-separated list of values or ranges (start:stop or start:stop:step, with
+    /// stop exclusive) into the sequence of values it represents.
+    static emp::vector<double> ToTestValues(const emp::String & in) {
+      emp::vector<double> out;
+      for (emp::String entry : in.Slice(",")) {
+        double start = emp::from_string<double>(emp::string_pop(entry, ':'));
+        if (entry.size() == 0) { out.push_back(start); continue; }
+        double stop = emp::from_string<double>(emp::string_pop(entry, ':'));
+        double step = entry.size() ? emp::from_string<double>(entry) : (start <= stop ? 1.0 : -1.0);
+        if (step == 0.0 || (stop - start) * step < 0.0) {
+          emp::notify::Error("EvalFunction test range '", in, "' never reaches its end.");
+          continue;
+        }
+        for (double val = start; step > 0.0 ? val < stop : val > stop; val += step) {
+          out.push_back(val);
+        }
+      }
+      return out;
+    }
 
   public:
     EvalFunction(mabe::MABE & control,
@@ -76,63 +102,103 @@ namespace mabe {
       LinkVar(fitness_trait, "fitness_trait", "Trait for combined fitness (#tests - error sum)");
       LinkVar(function, "function", "Function to specify target output.");
       LinkVar(test_summary, "test_values", "Test values to use for evaluation.\nFormat: Range list for each variable; use ';' to separate variables");
-      );
     }
 
     void SetupModule() override {
-      input_names = emp::slice(input_traits, ',');
-      if (intput_names.size() > MAX_INPUTS) {
+      input_names = input_traits.Slice(",");
+      if (input_names.size() > MAX_INPUTS) {
         emp::notify::Error("EvalFunction does not allow more than ", MAX_INPUTS, " inputs. ",
                            input_names.size(), " inputs, requested.");
       }
-      for (const emp::String & name : input_names) {
-        AddOwnedTrait<double>(name, "Input value", 0.0);
-      }
-      AddRequiredTrait<double>(output_trait); // Output values
-      AddOwnedTrait<emp::vector<double>>(errors_trait, "Error vector for tests.", emp::vector<double>();
-      AddOwnedTrait<double>(fitness_trait, "Combined success rating", 0.0);
 
       // Prepare the test values to use.
-      emp::remove_whitespace(test_summary);
-      emp::vector<emp::String> test_sets = emp::slice(test_summary, ';');
+      test_summary.RemoveWhitespace();
+      emp::vector<emp::String> test_sets = test_summary.Slice(";");
 
       if (test_sets.size() != input_names.size()) {
         emp::notify::Error("EvalFunction requires one test set for each input.  Found ",
-                           input_names.size(), " inputs, but ", tests_sets.size(), " test sets.");
+                           input_names.size(), " inputs, but ", test_sets.size(), " test sets.");
       }
 
-      // Put the test values in place, along with the expected results.
-      test_values.resize(test_sets.size());               // Create one array for each input variable.
+      // Lay out the test values as a column-major matrix, one column per input.
+      test_inputs.resize(0);
+      num_tests = 0;
       for (size_t i = 0; i < test_sets.size(); ++i) {
-        test_values[i] = emp::ToSequence(test_sets[i]);   // Set all values for one input variable.
-        if (num_tests == emp::MAX_SIZE_T) num_tests = test_values[i].size();
-        else if (test_values[i].size() != num_tests) {
+        emp::vector<double> values = ToTestValues(test_sets[i]);
+        if (i == 0) num_tests = values.size();
+        else if (values.size() != num_tests) {
           emp::notify::Error("EvalFunction requires all inputs to have the same count of values.  First input (0) has ",
-                            test_values[0].size(), " test values, but ", i, " has ", test_values[i].size(), ".");
+                            num_tests, " test values, but ", i, " has ", values.size(), ".");
+          values.resize(num_tests, 0.0);
         }
+        test_inputs.insert(test_inputs.end(), values.begin(), values.end());
       }
 
       // Build a DataMap to determine expected results for each test case.
       emp::DataMap test_map;
+      emp::vector<size_t> test_ids(input_names.size());
       for (size_t i = 0; i < input_names.size(); ++i) {
-        test_map.AddVar<double>(input_names[0]);
+        test_ids[i] = test_map.AddVar<double>(input_names[i], 0.0);
+      }
+      auto target_fun = control.GetConfigScript().BuildDataMapEquation(test_map.GetLayout(), function);
+      target_results.resize(num_tests);
+      for (size_t test_id = 0; test_id < num_tests; ++test_id) {
+        for (size_t i = 0; i < test_ids.size(); ++i) {
+          test_map.Get<double>(test_ids[i]) = test_inputs[i * num_tests + test_id];
+        }
+        target_results[test_id] = target_fun(test_map).AsDouble();
       }
+      batch_outputs.resize(num_tests);
 
+      // Now that we know the number of tests, setup the traits.
+      for (const emp::String & name : input_names) {
+        AddOwnedTrait<double>(name, "Input value", 0.0);
+      }
+      AddRequiredTrait<double>(output_trait); // Output values
+      AddOwnedTrait<double>(errors_trait, "Error for each test case.", 0.0, num_tests);
+      AddOwnedTrait<double>(fitness_trait, "Combined success rating", 0.0);
     }
 
 
-    double Evaluate(const Collection & orgs) {
-      // If we haven't calculated the IDs, do so now.
-      if (output_trait == emp::MAX_SIZE_T) {
-        input_ids.resize(input_names.size());
-        for (size_t i = 0; i < input_names.size(); ++i) {
-          input_ids[i] = orgs.GetDataLayout().GetID(input_names[i]);
+    void SetupDataMap(emp::DataMap & dm) override {
+      input_ids.resize(input_names.size());
+      for (size_t i = 0; i < input_names.size(); ++i) {
+        input_ids[i] = dm.GetID(input_names[i]);
+      }
+      output_id = dm.GetID(output_trait);
+      errors_id = dm.GetID(errors_trait);
+      fitness_id = dm.GetID(fitness_trait);
+    }
+
+    /// Run all of the test cases on a single organism; return its fitness.
+    double EvaluateOrg(Organism & org) {
+      // Try to run all test cases at once; otherwise fall back to running them one at a time.
+      const std::span<const double> inputs(test_inputs.data(), test_inputs.size());
+      const std::span<double> outputs(batch_outputs.data(), batch_outputs.size());
+      if (!org.GenerateOutputBatch(inputs, input_ids.size(), outputs)) {
+        for (size_t test_id = 0; test_id < num_tests; ++test_id) {
+          for (size_t input_pos = 0; input_pos < input_ids.size(); ++input_pos) {
+            org.SetTrait<double>(input_ids[input_pos], test_inputs[input_pos * num_tests + test_id]);
+          }
+          org.GenerateOutput();
+          batch_outputs[test_id] = org.GetTrait<double>(output_id);
         }
-        output_id = orgs.GetDataLayout().GetID(output_trait);
-        errors_id = orgs.GetDataLayout().GetID(errors_trait);
-        fitness_id = orgs.GetDataLayout().GetID(fitness_trait);
       }
 
+      // Write errors directly into the organism's error trait and total them.
+      std::span<double> errors = org.GetTrait<double>(errors_id, num_tests);
+      double error_total = 0.0;
+      for (size_t test_id = 0; test_id < num_tests; ++test_id) {
+        errors[test_id] = std::abs(batch_outputs[test_id] - target_results[test_id]);
+        error_total += errors[test_id];
+      }
+
+      double & fitness = org.GetTrait<double>(fitness_id);
+      fitness = static_cast<double>(num_tests) - error_total;
+      return fitness;
+    }
+
+    double Evaluate(const Collection & orgs) {
       // Loop through the living organisms in the target collection to evaluate each.
       mabe::Collection alive_collect( orgs.GetAlive() );
 
@@ -141,27 +207,10 @@ namespace mabe {
       size_t org_count = 0;
       double max_fitness = 0.0;
       for (Organism & org : alive_collect) {
-        control.Verbose("...eval org #", org_count++);
-
-        double & ouput = org.GetTrait<double>(output_id);
-        double & errors = org.GetTrait<emp::vector<double>>(errors_id);
-        double & fitness = org.GetTrait<double>(fitness_trait);
-
-        /// Loop through test cases to evaluate each.
-        for (size_t test_id = 0; test_id < num_tests; ++test_id) {
-          // Setup inputs for the current test.
-          for (size_t input_pos = 0; input_pos < input_ids.size(); ++input_pos) {
-            org.SetTrait(input_ids[input_pos], test_values[input_pos][test_id]);
-          }
-
-          // Run the organism.
-          org.GenerateOutput();
-
-          // Evaluate the results.
-
-        }
-
-        if (fitness > max_fitness) max_fitness = fitness;
+        control.Verbose("...eval org #", org_count);
+        const double fitness = EvaluateOrg(org);
+        if (fitness > max_fitness || org_count == 0) max_fitness = fitness;
+        ++org_count;
       }
 
       return max_fitness;
@@ -10,6 +10,9 @@
 #ifndef MABE_EVAL_COUNT_BITS_H
 #define MABE_EVAL_COUNT_BITS_H
 
+#include <bit>
+#include <cstdint>
+
 #include "../../core/MABE.hpp"
 #include "../../core/Module.hpp"
 
@@ -61,12 +64,21 @@ namespace mabe {
         // Make sure this organism has its bit sequence ready for us to access.
         org.GenerateOutput();
 
-        // Count the number of ones in the bit sequence.
-        const emp::BitVector & bits = bits_trait.Get(org);
-        double score = (double) bits.CountOnes();
+        // Count the number of ones in the bit sequence, directly from packed words if we can.
+        double score = 0.0;
+        size_t num_bits = 0;
+        const BitWords bit_words = org.GetBitWords();
+        if (!bit_words.words.empty() && bit_words.trait_id == bits_trait.GetID()) {
+          for (uint64_t word : bit_words.words) score += std::popcount(word);
+          num_bits = bit_words.num_bits;
+        } else {
+          const emp::BitVector & bits = bits_trait.Get(org);
+          score = (double) bits.CountOnes();
+          num_bits = bits.size();
+        }
 
         // If we were supposed to count zeros, subtract ones count from total number of bits.
-        if (count_type == 0) score = bits.size() - score;
+        if (count_type == 0) score = num_bits - score;
 
         // Store the count on the organism in the score trait.
         score_trait(org) = score;
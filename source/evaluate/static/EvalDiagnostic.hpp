@@ -13,6 +13,10 @@
 #ifndef MABE_EVAL_DIAGNOSTIC_H
 #define MABE_EVAL_DIAGNOSTIC_H
 
+#include <algorithm>
+#include <numeric>
+#include <span>
+
 #include <emp/math/constants.hpp>
 #include <emp/tools/String.hpp>
 
@@ -22,6 +26,17 @@
 namespace mabe {
 
   class EvalDiagnostic : public Module {
+  public:
+    /// Results from running the diagnostic on a batch of value sets.
+    struct BatchResults {
+      emp::vector<double> totals;        ///< Total score for each row.
+      emp::vector<size_t> first_active;  ///< First active position for each row.
+      emp::vector<size_t> active_count;  ///< Number of active positions for each row.
+      emp::vector<double> best_scores;   ///< Highest score at each position across all rows.
+      size_t lowest_max_pos = 0;         ///< Lowest position of a maximal value in any row.
+      size_t max_row = 0;                ///< Row with the highest total score.
+    };
+
   private:
     size_t num_vals = 100;                     // Cardinality of the problem space.
     RequiredMultiTrait<double> vals_trait{this, "vals", "Set of values to evaluate.", AsConfig(num_vals)};
@@ -49,6 +64,15 @@ namespace mabe {
     double valley_slope = -1.0;  // If we have valleys, how much bigger should each be than the previous?
     // double valley_growth = 0.0;  // If we have valleys, how much bigger should each be than the previous?
 
+    // Buffers reused across evaluations so that each batch runs without allocation.
+    emp::vector<emp::Ptr<Organism>> batch_orgs;  // Organisms in the current batch (one per row)
+    emp::vector<double> batch_vals;              // Dense row-major matrix of values.
+    emp::vector<double> batch_scores;            // Dense row-major matrix of scores.
+
+    // Results are kept so that COLLECTIVE_SCORE and LOWEST_ACTIVE can avoid a rescan.
+    BatchResults batch_results;
+    bool collective_valid = false;               // Have batch_orgs changed since evaluation?
+
   public:
     EvalDiagnostic(mabe::MABE & control,
                    emp::String name="EvalDiagnostic",
@@ -95,132 +119,179 @@ namespace mabe {
       // Nothing needed here yet...
     }
 
-    /// @brief Take a set of initial scores, clean them up, apply valleys, and return the sum.
-    double FinalizeScores(std::span<double> scores, size_t start, size_t end) const {
-      emp_assert(start <= end);
-      emp_assert(end <= scores.size());
-
-      // Clear out scores outside of the range.
-      if (start > 0) std::fill(scores.begin(), scores.begin()+start, 0.0);
-      if (end < scores.size()) std::fill(scores.begin()+end, scores.end(), 0.0);
-
-      // If we have valleys, apply them.
-      if (valley_width > 0.0) {
-        for (size_t pos = start; pos < end; ++pos) {
-          double & score = scores[pos];
-          if (score <= valley_start || score >= valley_end) continue; // Not near valleys.
-          double valley_offset = score - valley_start;
-          double peak = std::floor(valley_offset / valley_width) * valley_width + valley_start;
-          double decline = (score - peak) * valley_slope;
-          score = peak + decline;
-        }
+    /// @brief Apply valleys to a contiguous block of scores.
+    /// Written without branches so that the compiler can vectorize it across the whole block.
+    void ApplyValleys(double * scores, size_t count) const {
+      if (valley_width <= 0.0) return;
+      for (size_t pos = 0; pos < count; ++pos) {
+        const double score = scores[pos];
+        const double peak = std::floor((score - valley_start) / valley_width) * valley_width + valley_start;
+        const double adjusted = peak + (score - peak) * valley_slope;
+        const bool in_valleys = (score > valley_start) & (score < valley_end);
+        scores[pos] = in_valleys ? adjusted : score;
       }
-
-      // Return the sum of the scores.
-      return std::accumulate(scores.begin()+start, scores.begin()+end, 0.0);
     }
 
-    double Evaluate(Collection orgs) {
-      // Track the organism with the highest total score.
-      double max_total = 0.0;
-      emp::Ptr<Organism> max_org = nullptr;
+    // --- Branch-free kernels used on each row of a batch ---
 
-      // Loop through the living organisms in the target collection to evaluate each.
-      mabe::Collection alive_orgs( orgs.GetAlive() );
-      for (Organism & org : alive_orgs) {        
-        // Make sure this organism has its values ready for us to access.
-        org.GenerateOutput();
+    /// Find the position of the first maximal value (same result as emp::FindMaxIndex), using
+    /// two reductions rather than a data-dependent branch.
+    static size_t FindMaxPos(const double * vals, size_t count) {
+      double max_val = vals[0];
+      for (size_t pos = 1; pos < count; ++pos) max_val = std::max(max_val, vals[pos]);
+      size_t max_pos = count;
+      for (size_t pos = 0; pos < count; ++pos) {
+        max_pos = std::min(max_pos, (vals[pos] == max_val) ? pos : count);
+      }
+      return (max_pos < count) ? max_pos : 0;
+    }
 
-        // Get access to the data_map elements that we need.
-        std::span<double> vals = vals_trait(org);
-        std::span<double> scores = scores_trait(org);
-        emp_assert(vals.size() == scores.size());
+    /// Find the end of the run of non-increasing values that begins at start.
+    static size_t FindDescentEnd(const double * vals, size_t start, size_t count) {
+      size_t end = count;
+      for (size_t pos = start+1; pos < count; ++pos) {
+        end = std::min(end, (vals[pos] <= vals[pos-1]) ? count : pos);
+      }
+      return end;
+    }
 
-        double & total_score = total_trait(org);
-        size_t & first_active = first_trait(org);
-        size_t & active_count = active_count_trait(org);
+    /// Copy values in [start, end) into scores and zero everything else.
+    static void CopyActive(const double * vals, double * scores,
+                           size_t start, size_t end, size_t count) {
+      for (size_t pos = 0; pos < count; ++pos) {
+        const bool active = (pos >= start) & (pos < end);
+        scores[pos] = active ? vals[pos] : 0.0;
+      }
+    }
 
-        // Initialize output values.
-        total_score = 0.0;
-        size_t pos = 0;
+    /// @brief Run the configured diagnostic on a dense, row-major matrix of values.
+    /// @param vals Matrix with one row of num_vals values for each of num_rows value sets.
+    /// @param scores Matrix of the same shape to fill with the resulting scores.
+    /// @param results Per-row outputs, plus collective maxima calculated in the same pass.
+    void EvaluateBatch(std::span<const double> vals, std::span<double> scores,
+                       size_t num_rows, BatchResults & results) const {
+      emp_assert(vals.size() == num_rows * num_vals, vals.size(), num_rows, num_vals);
+      emp_assert(scores.size() == vals.size(), scores.size(), vals.size());
+
+      results.totals.resize(num_rows);
+      results.first_active.resize(num_rows);
+      results.active_count.resize(num_rows);
+      results.best_scores.assign(num_vals, 0.0);
+      results.lowest_max_pos = num_vals;
+      results.max_row = 0;
+      if (num_vals == 0) return;
+
+      double * best = results.best_scores.data();
+      for (size_t row = 0; row < num_rows; ++row) {
+        const double * row_vals = vals.data() + row * num_vals;
+        double * row_scores = scores.data() + row * num_vals;
+
+        // Every diagnostic (and LOWEST_ACTIVE) needs to know where the maximum value is.
+        const size_t max_pos = FindMaxPos(row_vals, num_vals);
+        size_t start = 0;
+        size_t end = num_vals;
 
-        // Determine the scores based on the diagnostic type that we're using.
         switch (diagnostic_id) {
         case EXPLOIT:
-          std::copy(vals.begin(), vals.end(), scores.begin());
-          total_score = FinalizeScores(scores, 0, scores.size());
-          first_active = 0;
-          active_count = vals.size();
+          CopyActive(row_vals, row_scores, start, end, num_vals);
           break;
         case STRUCT_EXPLOIT:
-          scores[0] = vals[0];
-          first_active = 0;
-
-          // Use values as long as they are monotonically decreasing.
-          for (pos = 1; pos < vals.size() && vals[pos] <= vals[pos-1]; ++pos) {
-            scores[pos] = vals[pos];
-          }
-          active_count = pos;
-
-          total_score = FinalizeScores(scores, 0, pos);
+          end = FindDescentEnd(row_vals, 0, num_vals);
+          CopyActive(row_vals, row_scores, start, end, num_vals);
           break;
         case EXPLORE:
-          // Start at highest value (clearing everything before it)
-          pos = emp::FindMaxIndex(vals);  // Find the position to start.
-
-          scores[pos] = vals[pos];
-          first_active = pos;
-          pos++;
-
-          // Use values as long as they are monotonically non-increasing.
-          while (pos < vals.size() && vals[pos] <= vals[pos-1]) {
-            scores[pos] = vals[pos];
-            pos++;
-          }
-          active_count = pos - first_active;
-
-          total_score = FinalizeScores(scores, first_active, pos);
+          start = max_pos;
+          end = FindDescentEnd(row_vals, start, num_vals);
+          CopyActive(row_vals, row_scores, start, end, num_vals);
           break;
-        case DIVERSITY:
-          // Only count highest value
-          pos = emp::FindMaxIndex(vals);  // Find the sole active position.
-          scores[pos] = vals[pos];
-          first_active = pos;
-          active_count = 1;
-
-          // All others are subtracted from max and divided by two, creating a
-          // pressure to minimize.
-          for (size_t i = 0; i < vals.size(); i++) {
-            if (i != pos) total_score += (scores[i] = (vals[pos] - vals[i]) / 2.0);
+        case DIVERSITY: {
+          // All but the max are subtracted from max and divided by two, creating a pressure
+          // to minimize.
+          const double max_val = row_vals[max_pos];
+          for (size_t pos = 0; pos < num_vals; ++pos) {
+            row_scores[pos] = (pos == max_pos) ? max_val : (max_val - row_vals[pos]) / 2.0;
           }
-
-          total_score = FinalizeScores(scores, 0, scores.size());
-
           break;
+        }
         case WEAK_DIVERSITY:
-          // Only count highest value
-          pos = emp::FindMaxIndex(vals);  // Find the position to start.
-          scores[pos] = vals[pos];
-          first_active = pos;
-          active_count = 1;
-
-          total_score = FinalizeScores(scores, first_active, first_active+1);
-
+          start = max_pos;
+          end = max_pos + 1;
+          CopyActive(row_vals, row_scores, start, end, num_vals);
           break;
         default:
           emp_error("Unknown Diagnostic.");
         }
 
-        if (total_score > max_total || !max_org) {
-          max_total = total_score;
-          max_org = &org;
-        }
+        ApplyValleys(row_scores + start, end - start);
+
+        // The two diversity diagnostics have only a single active position (the max).
+        const bool single_active = (diagnostic_id == DIVERSITY || diagnostic_id == WEAK_DIVERSITY);
+        results.first_active[row] = single_active ? max_pos : start;
+        results.active_count[row] = single_active ? 1 : end - start;
+        results.totals[row] = std::accumulate(row_scores + start, row_scores + end, 0.0);
+
+        // Update collective information in the same pass.
+        for (size_t pos = 0; pos < num_vals; ++pos) best[pos] = std::max(best[pos], row_scores[pos]);
+        results.lowest_max_pos = std::min(results.lowest_max_pos, max_pos);
+        if (results.totals[row] > results.totals[results.max_row]) results.max_row = row;
       }
-      return max_total;
+    }
+
+    double Evaluate(Collection orgs) {
+      // Gather the values of all living organisms into a dense matrix.
+      mabe::Collection alive_orgs( orgs.GetAlive() );
+      const size_t num_orgs = alive_orgs.GetSize();
+      batch_orgs.resize(0);
+      batch_vals.resize(num_orgs * num_vals);
+      batch_scores.resize(num_orgs * num_vals);
+      for (Organism & org : alive_orgs) {
+        // Make sure this organism has its values ready for us to access.
+        org.GenerateOutput();
+        std::span<double> vals = vals_trait(org);
+        emp_assert(vals.size() == num_vals, vals.size(), num_vals);
+        std::copy(vals.begin(), vals.end(), batch_vals.begin() + batch_orgs.size() * num_vals);
+        batch_orgs.push_back(&org);
+      }
+
+      EvaluateBatch(std::span<const double>(batch_vals.data(), batch_vals.size()),
+                    std::span<double>(batch_scores.data(), batch_scores.size()),
+                    num_orgs, batch_results);
+
+      // Scatter the results back into each organism.
+      for (size_t row = 0; row < num_orgs; ++row) {
+        Organism & org = *batch_orgs[row];
+        std::span<double> scores = scores_trait(org);
+        std::copy(batch_scores.begin() + row * num_vals,
+                  batch_scores.begin() + (row+1) * num_vals,
+                  scores.begin());
+        total_trait(org) = batch_results.totals[row];
+        first_trait(org) = batch_results.first_active[row];
+        active_count_trait(org) = batch_results.active_count[row];
+      }
+
+      // Collective results are valid until the evaluated organisms change.
+      collective_valid = true;
+
+      return num_orgs ? batch_results.totals[batch_results.max_row] : 0.0;
+    }
+
+    /// Can we reuse the collective results from the most recent evaluation for these orgs?
+    bool UseCollectiveCache(const mabe::Collection & alive_orgs) const {
+      if (!collective_valid || alive_orgs.GetSize() != batch_orgs.size()) return false;
+      size_t row = 0;
+      for (const Organism & org : alive_orgs) {
+        if (&org != batch_orgs[row++].Raw()) return false;
+      }
+      return true;
     }
 
     double CalcCollectiveScore(Collection orgs) const {
       mabe::Collection alive_orgs( orgs.GetAlive() );
+      if (UseCollectiveCache(alive_orgs)) {
+        const auto & best_scores = batch_results.best_scores;
+        return std::accumulate(best_scores.begin(), best_scores.end(), 0.0);
+      }
+
       emp::vector<double> best_scores(num_vals, 0.0);
       for (Organism & org : alive_orgs) {
         std::span<double> scores = scores_trait(org);
@@ -234,6 +305,8 @@ namespace mabe {
 
     double FindLowestActive(Collection orgs) const {
       mabe::Collection alive_orgs( orgs.GetAlive() );
+      if (UseCollectiveCache(alive_orgs)) return batch_results.lowest_max_pos;
+
       size_t lowest_active = num_vals;
       for (Organism & org : alive_orgs) {
         // Get access to the data_map elements that we need.
@@ -244,6 +317,11 @@ namespace mabe {
 
       return lowest_active;
     }
+
+    // Any change to the organisms invalidates the collective results.
+    void OnPlacement(OrgPosition) override { collective_valid = false; }
+    void BeforeDeath(OrgPosition) override { collective_valid = false; }
+    void OnSwap(OrgPosition, OrgPosition) override { collective_valid = false; }
   };
 
   MABE_REGISTER_MODULE(EvalDiagnostic, "Evaluate set of values with a specified diagnostic problem.");
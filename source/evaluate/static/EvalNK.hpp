@@ -28,6 +28,7 @@ namespace mabe {
     size_t N = 100;
     size_t K = 2;    
     NKLandscape landscape;
+    EvalCache<emp::BitVector, double> fitness_cache{this};
     // bool track_gene_fitness = false;
 
   public:
@@ -37,6 +38,8 @@ namespace mabe {
       : EvalModule(control, name, desc) { }
     ~EvalNK() { }
 
+    bool IsDeterministic() const override { return true; }
+
     void SetupConfig() override {
       LinkVar(N, "N", "Total number of bits required in sequence");
       LinkVar(K, "K", "Number of bits used in each gene");
@@ -48,6 +51,32 @@ namespace mabe {
       landscape.Config(N, K, control.GetRandom());  // Setup the fitness landscape.
     }
 
+    double CalcFitness(Organism & org) {
+      // Organisms with packed bits (e.g., BitsOrgFixed) can be scored without the bits trait;
+      // this is already cheaper than a cache lookup.
+      const BitWords bit_words = org.GetBitWords();
+      if (!bit_words.words.empty() && bit_words.trait_id == bits_trait.GetID()) {
+        if (bit_words.num_bits != N) {
+          emp::notify::Error("Org returns ", bit_words.num_bits, " bits, but ",
+                             N, " bits needed for NK landscape.",
+                             "\nOrg: ", org.ToString());
+        }
+        return landscape.GetFitness(bit_words.words);
+      }
+
+      const auto & bits = bits_trait(org);
+      if (bits.size() != N) {
+        emp::notify::Error("Org returns ", bits.size(), " bits, but ",
+                           N, " bits needed for NK landscape.",
+                           "\nOrg: ", org.ToString());
+      }
+
+      // if (track_gene_fitness) {
+      //   gene_fitness(org) = landscape.GetGeneFitnesses(bits);
+      // }
+      return fitness_cache.Get(bits, [this,&bits](){ return landscape.GetFitness(bits); });
+    }
+
     double EvaluateCollection(const Collection & orgs) override {
       // Loop through the population and evaluate each organism.
       double max_fitness = 0.0;
@@ -55,17 +84,7 @@ namespace mabe {
       mabe::Collection alive_orgs( orgs.GetAlive() );
       for (Organism & org : alive_orgs) {
         org.GenerateOutput();
-        const auto & bits = bits_trait(org);
-        if (bits.size() != N) {
-          emp::notify::Error("Org returns ", bits.size(), " bits, but ",
-                             N, " bits needed for NK landscape.",
-                             "\nOrg: ", org.ToString());
-        }
-
-        // if (track_gene_fitness) {
-        //   gene_fitness(org) = landscape.GetGeneFitnesses(bits);
-        // }
-        const double fitness = landscape.GetFitness(bits);
+        const double fitness = CalcFitness(org);
         fitness_trait(org) = fitness;
 
         if (fitness > max_fitness || !max_org) {
@@ -80,6 +99,7 @@ namespace mabe {
     /// Re-randomize all of the entries.
     double Reset() override {
       landscape.Config(N, K, control.GetRandom());
+      ClearEvalCache();
       return 0.0;
     }
   };
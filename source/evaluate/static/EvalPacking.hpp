@@ -28,31 +28,33 @@
 #ifndef MABE_EVAL_PACKING_H
 #define MABE_EVAL_PACKING_H
 
-#include "../../core/MABE.hpp"
-#include "../../core/Module.hpp"
+#include "../../core/EvalModule.hpp"
 
 #include "emp/datastructs/reference_vector.hpp"
 
 namespace mabe {
 
   /// \brief Evaluation module that counts the number of packages successfully packed.
-  class EvalPacking : public Module {
+  class EvalPacking : public EvalModule<EvalPacking> {
   protected:
     emp::String bits_trait;    ///< Name of the trait containing the bitstring to evaluate
     emp::String fitness_trait; ///< Name of the trait that stores the resulting fitness
     size_t package_size = 6;   ///< Number of ones expected in a package
     size_t padding_size = 3;   ///< Number of zeros expected on each side of a package
+    EvalCache<emp::BitVector, double> fitness_cache{this}; ///< Results for previously seen bits
 
   public:
     EvalPacking(mabe::MABE & control,
                 emp::String name="EvalPacking",
                 emp::String desc="Evaluate bitstrings by counting correctly packed bricks.")
-      : Module(control, name, desc) , bits_trait("bits") , fitness_trait("fitness")
+      : EvalModule(control, name, desc) , bits_trait("bits") , fitness_trait("fitness")
     {
-      SetEvaluateMod(true);
     }
     ~EvalPacking() { }
 
+    /// Packing fitness depends only on the bits, so results can be cached.
+    bool IsDeterministic() const override { return true; }
+
     /// Set up variables for configuration files
     void SetupConfig() override {
       LinkVar(bits_trait, "bits_trait", "Which trait stores the bit sequence to evaluate?");
@@ -139,7 +141,9 @@ namespace mabe {
     }
   
     /// Evaluate all organisms in a collection, return the max fitness
-    double Evaluate(Collection orgs) {
+    double EvaluateCollection(const Collection & orgs) override {
+      CheckCacheConfig(package_size, padding_size);  // Cached results depend on these settings.
+
       // Loop through the population and evaluate each organism.
       double max_fitness = 0.0;
       mabe::Collection alive_collect( orgs.GetAlive() );
@@ -149,7 +153,8 @@ namespace mabe {
         // Get the bits_traits of the orgnism.
         const emp::BitVector & bits = org.GetTrait<emp::BitVector>(bits_trait);
         // Evaluate the fitness of the orgnism
-        double fitness = EvaluateOrg(bits, padding_size, package_size); 
+        double fitness = fitness_cache.Get(bits,
+          [this,&bits](){ return EvaluateOrg(bits, padding_size, package_size); });
         // Set the fitness_trait for the organism
         org.SetTrait<double>(fitness_trait, fitness);
         // Update the max_fitness if applicable
@@ -160,15 +165,6 @@ namespace mabe {
       return max_fitness;
     }
 
-    /// Set up member functions associated with this class.
-    static void InitType(emplode::TypeInfo & info) {
-      info.AddMemberFunction("EVAL",
-         [](EvalPacking & mod, Collection list) { 
-           return mod.Evaluate(list); 
-         },
-        "Evaluate all orgs in an OrgList on the packing problem.");
-    }
-
   };
 
   MABE_REGISTER_MODULE(EvalPacking, "Evaluate bitstrings by counting correctly packed packages.");
@@ -13,14 +13,13 @@
 #ifndef MABE_EVAL_ROYAL_ROAD_H
 #define MABE_EVAL_ROYAL_ROAD_H
 
-#include "../../core/MABE.hpp"
-#include "../../core/Module.hpp"
+#include "../../core/EvalModule.hpp"
 
 #include "emp/datastructs/reference_vector.hpp"
 
 namespace mabe {
 
-  class EvalRoyalRoad : public Module {
+  class EvalRoyalRoad : public EvalModule<EvalRoyalRoad> {
   private:
     emp::String bits_trait;
     emp::String fitness_trait;
@@ -32,21 +31,13 @@ namespace mabe {
     EvalRoyalRoad(mabe::MABE & control,
                   emp::String name="EvalRoyalRoad",
                   emp::String desc="Evaluate bitstrings by counting ones (or zeros).")
-      : Module(control, name, desc)
+      : EvalModule(control, name, desc)
       , bits_trait("bits")
       , fitness_trait("fitness")
     {
-      SetEvaluateMod(true);
     }
     ~EvalRoyalRoad() { }
 
-    // Setup member functions associated with this class.
-    static void InitType(emplode::TypeInfo & info) {
-      info.AddMemberFunction("EVAL",
-                             [](EvalRoyalRoad & mod, Collection list) { return mod.Evaluate(list); },
-                             "Evaluate RoyalRoad on all orgs in an OrgList.");
-    }
-
     void SetupConfig() override {
       LinkVar(bits_trait, "bits_trait", "Which trait stores the bit sequence to evaluate?");
       LinkVar(fitness_trait, "fitness_trait", 
@@ -60,7 +51,20 @@ namespace mabe {
       AddOwnedTrait<double>(fitness_trait, "Royal Road fitness value", 0.0);
     }
 
-    double Evaluate(Collection orgs) {
+    /// Calculate the Royal Road fitness of a single bit sequence.
+    double EvaluateBits(const emp::BitVector & bits) const {
+      // Count the number of contiguous ones at the start of the bit sequence.
+      int road_length = 0.0;
+      for (size_t i = 0; i < bits.size(); i++) {
+        if (bits[i] == 0) break;
+        road_length++;
+      }
+
+      const int overage = road_length % brick_size;
+      return road_length - overage * (extra_bit_cost + 1.0);
+    }
+
+    double EvaluateCollection(const Collection & orgs) override {
       // Loop through the population and evaluate each organism.
       double max_fitness = 0.0;
       mabe::Collection alive_collect = orgs.GetAlive();
@@ -68,18 +72,9 @@ namespace mabe {
         // Make sure this organism has its bit sequence ready for us to access.
         org.GenerateOutput();
 
-        // Count the number of contiguous ones at the start of the bit sequence.
+        // Store the fitness on the organism in the fitness trait.
         const emp::BitVector & bits = org.GetTrait<emp::BitVector>(bits_trait);
-        int road_length = 0.0;
-        for (size_t i = 0; i < bits.size(); i++) {
-          if (bits[i] == 0) break;
-          road_length++;
-        }
-
-        const int overage = road_length % brick_size;
-
-        // Store the count on the organism in the fitness trait.
-        double fitness = road_length - overage * (extra_bit_cost + 1.0);
+        const double fitness = EvaluateBits(bits);
         org.SetTrait<double>(fitness_trait, fitness);
 
         if (fitness > max_fitness) {
@@ -32,11 +32,13 @@
 #include "evaluate/callable/EvalTaskEqu.hpp"
 #include "evaluate/static/EvalPacking.hpp"
 #include "evaluate/static/EvalRandom.hpp"
+#include "evaluate/math/EvalFunction.hpp"
 
 // Placement Modules
 #include "placement/AnnotatePlacement_Position.hpp"
 #include "placement/RandomReplacement.hpp"
 #include "placement/MaxSizePlacement.hpp"
+#include "placement/GridPlacement.hpp"
 
 // Selection Modules
 #include "select/SelectElite.hpp"
@@ -48,10 +50,12 @@
 
 // Organism Types
 #include "orgs/BitsOrg.hpp"
+#include "orgs/BitsOrgFixed.hpp"
 #include "orgs/BitSummaryOrg.hpp"
 #include "orgs/StatesOrg.hpp"
 #include "orgs/ValsOrg.hpp"
 #include "orgs/AvidaGPOrg.hpp"
+#include "orgs/SimpleProgramOrg.hpp"
 #include "orgs/VirtualCPUOrg.hpp"
 #include "orgs/instructions/VirtualCPU_Inst_Nop.hpp"
 #include "orgs/instructions/VirtualCPU_Inst_Math.hpp"
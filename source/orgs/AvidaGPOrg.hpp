@@ -6,15 +6,23 @@
  *  @file  AvidaGPOrg.hpp
  *  @brief An organism consisting of lineaer code.
  *  @note Status: ALPHA
+ *
+ *  GenerateOutput() is run once per evaluation (e.g., once per move in game evaluations), so it
+ *  avoids any per-call allocation: input and output traits are accessed by ID, inputs are loaded
+ *  directly into the hardware, and outputs are written into the existing output vector.
  */
 
 #ifndef MABE_AVIDA_GP_ORGANISM_H
 #define MABE_AVIDA_GP_ORGANISM_H
 
+#include "../core/GenomeIO.hpp"
 #include "../core/MABE.hpp"
+#include "../core/MutationSites.hpp"
 #include "../core/Organism.hpp"
 #include "../core/OrganismManager.hpp"
 
+#include <algorithm>
+
 #include "emp/datastructs/vector_utils.hpp"
 #include "emp/hardware/AvidaGP.hpp"
 #include "emp/math/Distribution.hpp"
@@ -44,31 +52,16 @@ namespace mabe {
 
       // Internal use (shared by all orgs)
       emp::Binomial mut_dist;              ///< Distribution of number of mutations to occur.
-      emp::BitVector mut_sites;            ///< A pre-allocated vector for mutation sites. 
+      size_t input_id = emp::MAX_SIZE_T;   ///< DataMap ID of inputs (set in SetupDataMap)
+      size_t output_id = emp::MAX_SIZE_T;  ///< DataMap ID of outputs (set in SetupDataMap)
     };
 
     emp::String ToString() const override { return hardware.ToString(); }
 
     size_t Mutate(emp::Random & random) override {
       const size_t num_muts = SharedData().mut_dist.PickRandom(random);
-
-      if (num_muts == 0) return 0;
-      if (num_muts == 1) {
-        const size_t pos = random.GetUInt(hardware.GetSize());
-        hardware.RandomizeInst(pos, random);
-        return 1;
-      }
-
-      // Only remaining option is num_muts > 1.
-      auto & mut_sites = SharedData().mut_sites;
-      mut_sites.Clear();
-      for (size_t i = 0; i < num_muts; i++) {
-        const size_t pos = random.GetUInt(hardware.GetSize());
-        if (mut_sites[pos]) { --i; continue; }  // Duplicate position; try again.
-        hardware.RandomizeInst(pos, random);
-      }
-
-      return num_muts;
+      return ForEachDistinctSite(random, hardware.GetSize(), num_muts,
+                                 [this,&random](size_t pos){ hardware.RandomizeInst(pos, random); });
     }
 
     void Randomize(emp::Random & random) override {
@@ -81,18 +74,56 @@ namespace mabe {
       if (SharedData().init_random) Randomize(random);
     }
 
+    /// Binary genomes are the number of instructions followed by four bytes per instruction:
+    /// the instruction index and its three arguments.
+    bool WriteGenome(std::ostream & os) const override {
+      WriteBinary<uint64_t>(os, hardware.GetSize());
+      for (size_t pos = 0; pos < hardware.GetSize(); ++pos) {
+        const auto & inst = hardware.GetInst(pos);
+        const uint8_t inst_bytes[4] = { (uint8_t) inst.id, (uint8_t) inst.args[0],
+                                        (uint8_t) inst.args[1], (uint8_t) inst.args[2] };
+        WriteBinarySpan(os, std::span<const uint8_t>(inst_bytes));
+      }
+      return os.good();
+    }
+
+    bool ReadGenome(std::istream & is) override {
+      uint64_t num_insts = 0;
+      if (!ReadBinary(is, num_insts)) return false;
+      hardware.Reset();
+      for (size_t pos = 0; pos < num_insts; ++pos) {
+        uint8_t inst_bytes[4];
+        if (!ReadBinarySpan(is, std::span<uint8_t>(inst_bytes))) return false;
+        if (inst_bytes[0] >= hardware.GetInstLib()->GetSize()) {
+          emp::notify::Error("AvidaGPOrg genome has invalid instruction index ",
+                             (size_t) inst_bytes[0], ".");
+          return false;
+        }
+        hardware.PushInst(inst_bytes[0], inst_bytes[1], inst_bytes[2], inst_bytes[3]);
+      }
+      return true;
+    }
+
     /// Put the output values in the correct output position.
     void GenerateOutput() override {
       hardware.ResetHardware();
 
       // Setup the input.
-      hardware.SetInputs(GetTrait<emp::vector<double>>(SharedData().input_name));
+      const emp::vector<double> & inputs = GetTrait<emp::vector<double>>(GetInputID());
+      for (size_t i = 0; i < inputs.size(); ++i) hardware.SetInput((int) i, inputs[i]);
 
       // Run the code.
       hardware.Process(SharedData().eval_time);
 
-      // Store the results.
-      SetTrait<emp::vector<double>>(SharedData().output_name, emp::ToVector(hardware.GetOutputs()));
+      // Store the results, indexed by output ID, reusing the existing output vector.
+      emp::vector<double> & outputs = GetTrait<emp::vector<double>>(GetOutputID());
+      int max_id = -1;
+      for (const auto & [id, value] : hardware.GetOutputs()) max_id = std::max(max_id, id);
+      outputs.resize(0);
+      outputs.resize((size_t) (max_id + 1), 0.0);
+      for (const auto & [id, value] : hardware.GetOutputs()) {
+        if (id >= 0) outputs[(size_t) id] = value;
+      }
     }
 
     /// Setup this organism type to be able to load from config.
@@ -117,15 +148,22 @@ namespace mabe {
       // Setup the mutation distribution.
       SharedData().mut_dist.Setup(SharedData().mut_prob, hardware.GetSize());
 
-      // Setup the default vector to indicate mutation positions.
-      SharedData().mut_sites.Resize(hardware.GetSize());
-
       // Setup the input and output traits.
       GetManager().AddRequiredTrait<emp::vector<double>>(SharedData().input_name);
       GetManager().AddSharedTrait(SharedData().output_name,
                                   "Value map output from organism.",
                                   emp::vector<double>());
     }
+
+    /// Look up the input and output traits once all traits are in place.
+    void SetupDataMap(const emp::DataMap & dm) override {
+      SharedData().input_id = dm.GetID(SharedData().input_name);
+      SharedData().output_id = dm.GetID(SharedData().output_name);
+    }
+
+  private:
+    size_t GetInputID() const { return SharedData().input_id; }
+    size_t GetOutputID() const { return SharedData().output_id; }
   };
 
   MABE_REGISTER_ORG_TYPE(AvidaGPOrg, "Organism consisting of Avida instructions.");
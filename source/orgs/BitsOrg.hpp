@@ -6,12 +6,18 @@
  *  @file  BitsOrg.hpp
  *  @brief An organism consisting of a series of bits.
  *  @note Status: ALPHA
+ *
+ *  The bits are stored directly in the organism's output trait (in its DataMap), so there is
+ *  only one copy of the genome and any module reading the output trait sees it live;
+ *  GenerateOutput() has no work to do.
  */
 
 #ifndef MABE_BITS_ORGANISM_H
 #define MABE_BITS_ORGANISM_H
 
+#include "../core/GenomeIO.hpp"
 #include "../core/MABE.hpp"
+#include "../core/MutationSites.hpp"
 #include "../core/Organism.hpp"
 #include "../core/OrganismManager.hpp"
 
@@ -22,71 +28,83 @@
 namespace mabe {
 
   class BitsOrg : public OrganismTemplate<BitsOrg> {
-  protected:
-    emp::BitVector bits;
-
   public:
     BitsOrg(OrganismManager<BitsOrg> & _manager)
-      : OrganismTemplate<BitsOrg>(_manager), bits(100) { }
+      : OrganismTemplate<BitsOrg>(_manager) { }
     BitsOrg(const BitsOrg &) = default;
     BitsOrg(BitsOrg &&) = default;
-    BitsOrg(const emp::BitVector & in, OrganismManager<BitsOrg> & _manager)
-      : OrganismTemplate<BitsOrg>(_manager), bits(in) { }
-    BitsOrg(size_t N, OrganismManager<BitsOrg> & _manager)
-      : OrganismTemplate<BitsOrg>(_manager), bits(N) { }
     ~BitsOrg() { ; }
 
     struct ManagerData : public Organism::ManagerData {
+      size_t num_bits = 100;             ///< Number of bits in this genome.
       double mut_prob = 0.01;            ///< Probability of each bit mutating on reproduction.
       emp::String output_name = "bits";  ///< Name of trait that should be used to access bits.
       emp::Binomial mut_dist;            ///< Distribution of number of mutations to occur.
-      emp::BitVector mut_sites;          ///< A pre-allocated vector for mutation sites. 
       bool init_random = true;           ///< Should we randomize ancestor?  (false = all zeros)
+      size_t bits_id = emp::MAX_SIZE_T;  ///< DataMap ID for output trait (set in SetupDataMap)
     };
 
-    emp::String ToString() const override { return emp::MakeString(bits); }
+    /// Access the bits, which live in the output trait.
+    emp::BitVector & GetBits() {
+      return GetTrait<emp::BitVector>(GetBitsID());
+    }
+    const emp::BitVector & GetBits() const {
+      return GetTrait<emp::BitVector>(GetBitsID());
+    }
+
+    emp::String ToString() const override { return emp::MakeString(GetBits()); }
 
     size_t Mutate(emp::Random & random) override {
       const size_t num_muts = SharedData().mut_dist.PickRandom(random);
 
       if (num_muts == 0) return 0;
-      if (num_muts == 1) {
-        const size_t pos = random.GetUInt(bits.size());
-        bits.Toggle(pos);
-        return 1;
-      }
-
-      // Only remaining option is num_muts > 1.
-      auto & mut_sites = SharedData().mut_sites;
-      mut_sites.Clear();
-      for (size_t i = 0; i < num_muts; i++) {
-        const size_t pos = random.GetUInt(bits.size());
-        if (mut_sites[pos]) { --i; continue; }  // Duplicate position; try again.
-        mut_sites.Set(pos);
-      }
-      bits ^= mut_sites;
-
-      return num_muts;
+      emp::BitVector & bits = GetBits();
+      return ForEachDistinctSite(random, bits.size(), num_muts,
+                                 [&bits](size_t pos){ bits.Toggle(pos); });
     }
 
     void Randomize(emp::Random & random) override {
-      emp::RandomizeBitVector(bits, random, 0.5);
+      emp::RandomizeBitVector(GetBits(), random, 0.5);
     }
 
     void Initialize(emp::Random & random) override {
-      if (SharedData().init_random) emp::RandomizeBitVector(bits, random, 0.5);
+      if (SharedData().init_random) emp::RandomizeBitVector(GetBits(), random, 0.5);
     }
 
-    /// Put the bits in the correct output position.
-    void GenerateOutput() override {
-      SetTrait<emp::BitVector>(SharedData().output_name, bits);
+    /// Binary genomes are the number of bits followed by the bits packed eight per byte.
+    bool WriteGenome(std::ostream & os) const override {
+      const emp::BitVector & bits = GetBits();
+      WriteBinary<uint64_t>(os, bits.size());
+      for (size_t i = 0; i < bits.GetNumBytes(); ++i) WriteBinary<uint8_t>(os, bits.GetByte(i));
+      return os.good();
     }
 
+    bool ReadGenome(std::istream & is) override {
+      uint64_t num_bits = 0;
+      if (!ReadBinary(is, num_bits)) return false;
+      if (num_bits != SharedData().num_bits) {
+        emp::notify::Error("BitsOrg genome has ", num_bits, " bits, but organisms are ",
+                           "configured for ", SharedData().num_bits, ".");
+        return false;
+      }
+      emp::BitVector & bits = GetBits();
+      bits.Resize(num_bits);
+      const size_t num_bytes = bits.GetNumBytes();
+      for (size_t i = 0; i < num_bytes; ++i) {
+        uint8_t byte = 0;
+        if (!ReadBinary(is, byte)) return false;
+        if (i == num_bytes - 1 && num_bits % 8) byte &= (uint8_t) ((1 << (num_bits % 8)) - 1);
+        bits.SetByte(i, byte);
+      }
+      return true;
+    }
+
+    /// Bits are already stored in the output trait.
+    void GenerateOutput() override { }
+
     /// Setup this organism type to be able to load from config.
     void SetupConfig() override {
-      GetManager().LinkFuns<size_t>([this](){ return bits.size(); },
-                       [this](const size_t & N){ return bits.Resize(N); },
-                       "N", "Number of bits in organism");
+      GetManager().LinkVar(SharedData().num_bits, "N", "Number of bits in organism");
       GetManager().LinkVar(SharedData().mut_prob, "mut_prob",
                       "Probability of each bit mutating on reproduction.");
       GetManager().LinkVar(SharedData().output_name, "output_name",
@@ -98,16 +116,21 @@ namespace mabe {
     /// Setup this organism type with the traits it need to track.
     void SetupModule() override {
       // Setup the mutation distribution.
-      SharedData().mut_dist.Setup(SharedData().mut_prob, bits.size());
+      SharedData().mut_dist.Setup(SharedData().mut_prob, SharedData().num_bits);
 
-      // Setup the default vector to indicate mutation positions.
-      SharedData().mut_sites.Resize(bits.size());
-
-      // Setup the output trait.
+      // Setup the output trait; this is where the bits are stored.
       GetManager().AddSharedTrait(SharedData().output_name,
                                   "Bitset output from organism.",
-                                  emp::BitVector(0));
+                                  emp::BitVector(SharedData().num_bits));
+    }
+
+    /// Look up the output trait once all traits are in place.
+    void SetupDataMap(const emp::DataMap & dm) override {
+      SharedData().bits_id = dm.GetID(SharedData().output_name);
     }
+
+  private:
+    size_t GetBitsID() const { return SharedData().bits_id; }
   };
 
   MABE_REGISTER_ORG_TYPE(BitsOrg, "Organism consisting of a series of N bits.");
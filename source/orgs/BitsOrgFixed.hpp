@@ -0,0 +1,184 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  BitsOrgFixed.hpp
+ *  @brief An organism consisting of a series of bits, with the length fixed at compile time.
+ *  @note Status: ALPHA
+ *
+ *  BitsOrgFixed<N> keeps its N bits inline as an array of 64-bit words, so it never allocates
+ *  and copying an organism (e.g., on birth) is a flat copy.  Evaluators that support it
+ *  (currently EvalNK and EvalCountBits) read those words directly through GetBitWords().
+ *
+ *  The bits trait (an emp::BitVector, as used by BitsOrg) is still provided for any other
+ *  module, but it starts out empty and is only built when something reads it; organisms that
+ *  are only accessed through GetBitWords() never allocate.
+ *
+ *  Common sizes are registered as BitsOrg64, BitsOrg128, BitsOrg256, BitsOrg512, and
+ *  BitsOrg1024.
+ */
+
+#ifndef MABE_BITS_ORGANISM_FIXED_H
+#define MABE_BITS_ORGANISM_FIXED_H
+
+#include "../core/GenomeIO.hpp"
+#include "../core/MABE.hpp"
+#include "../core/MutationSites.hpp"
+#include "../core/Organism.hpp"
+#include "../core/OrganismManager.hpp"
+
+#include <array>
+#include <cstdint>
+
+#include "emp/bits/BitVector.hpp"
+#include "emp/math/Distribution.hpp"
+
+namespace mabe {
+
+  template <size_t N>
+  class BitsOrgFixed : public OrganismTemplate<BitsOrgFixed<N>> {
+  protected:
+    using this_t = BitsOrgFixed<N>;
+    using base_t = OrganismTemplate<this_t>;
+    using base_t::SharedData;
+
+    static_assert(N > 0, "BitsOrgFixed must have at least one bit.");
+    static constexpr size_t NUM_WORDS = (N + 63) / 64;
+    static constexpr size_t NUM_BYTES = (N + 7) / 8;
+    static constexpr uint64_t LAST_WORD_MASK =
+      (N % 64) ? ((uint64_t{1} << (N % 64)) - 1) : ~uint64_t{0};
+
+    std::array<uint64_t, NUM_WORDS> words{};  ///< Bits, with bit 0 as the low bit of words[0].
+
+    bool GetBit(size_t pos) const { return (words[pos >> 6] >> (pos & 63)) & 1; }
+    void ToggleBit(size_t pos) { words[pos >> 6] ^= uint64_t{1} << (pos & 63); }
+
+    /// The bits trait is only rebuilt from the words when something reads it.
+    void BitsChanged() { this->MarkTraitStale(GetBitsID()); }
+
+    void UpdateStaleTrait(size_t trait_id) override {
+      if (trait_id != GetBitsID()) return;
+      this->template GetTrait<emp::BitVector>(trait_id) = MakeBitVector();
+    }
+
+    /// Copy the bits into a (newly allocated) BitVector.
+    emp::BitVector MakeBitVector() const {
+      emp::BitVector bits(N);
+      for (size_t pos = 0; pos < N; pos++) bits.Set(pos, GetBit(pos));
+      return bits;
+    }
+
+  public:
+    BitsOrgFixed(OrganismManager<this_t> & _manager) : base_t(_manager) { }
+    BitsOrgFixed(const BitsOrgFixed &) = default;
+    BitsOrgFixed(BitsOrgFixed &&) = default;
+    ~BitsOrgFixed() { ; }
+
+    struct ManagerData : public Organism::ManagerData {
+      double mut_prob = 0.01;            ///< Probability of each bit mutating on reproduction.
+      emp::String output_name = "bits";  ///< Name of trait that should be used to access bits.
+      emp::Binomial mut_dist;            ///< Distribution of number of mutations to occur.
+      bool init_random = true;           ///< Should we randomize ancestor?  (false = all zeros)
+      size_t bits_id = emp::MAX_SIZE_T;  ///< DataMap ID for output trait (set in SetupDataMap)
+    };
+
+    emp::String ToString() const override { return emp::MakeString(MakeBitVector()); }
+
+    size_t Mutate(emp::Random & random) override {
+      const size_t num_muts = SharedData().mut_dist.PickRandom(random);
+      if (num_muts == 0) return 0;
+      BitsChanged();
+      return ForEachDistinctSite(random, N, num_muts, [this](size_t pos){ ToggleBit(pos); });
+    }
+
+    void Randomize(emp::Random & random) override {
+      for (uint64_t & word : words) word = random.GetUInt64();
+      words.back() &= LAST_WORD_MASK;
+      BitsChanged();
+    }
+
+    void Initialize(emp::Random & random) override {
+      if (SharedData().init_random) Randomize(random);
+      else { words.fill(0); BitsChanged(); }
+    }
+
+    /// Binary genomes match BitsOrg: the number of bits followed by the bits packed eight per
+    /// byte (bits 0-7 in the first byte, and so on, regardless of machine byte order).
+    bool WriteGenome(std::ostream & os) const override {
+      WriteBinary<uint64_t>(os, N);
+      for (size_t i = 0; i < NUM_BYTES; ++i) {
+        WriteBinary<uint8_t>(os, (uint8_t) (words[i >> 3] >> ((i & 7) * 8)));
+      }
+      return os.good();
+    }
+
+    bool ReadGenome(std::istream & is) override {
+      uint64_t num_bits = 0;
+      if (!ReadBinary(is, num_bits)) return false;
+      if (num_bits != N) {
+        emp::notify::Error("Genome has ", num_bits, " bits, but ", this->GetTypeName(),
+                           " organisms have exactly ", N, ".");
+        return false;
+      }
+      words.fill(0);
+      for (size_t i = 0; i < NUM_BYTES; ++i) {
+        uint8_t byte = 0;
+        if (!ReadBinary(is, byte)) return false;
+        words[i >> 3] |= uint64_t{byte} << ((i & 7) * 8);
+      }
+      words.back() &= LAST_WORD_MASK;
+      BitsChanged();
+      return true;
+    }
+
+    /// Give evaluators direct access to the bits.
+    BitWords GetBitWords() const override { return BitWords{words, N, GetBitsID()}; }
+
+    /// The bits trait is brought up to date whenever it is read.
+    void GenerateOutput() override { }
+
+    /// Setup this organism type to be able to load from config.
+    void SetupConfig() override {
+      this->GetManager().LinkVar(SharedData().mut_prob, "mut_prob",
+                      "Probability of each bit mutating on reproduction.");
+      this->GetManager().LinkVar(SharedData().output_name, "output_name",
+                      "Name of variable to contain bit sequence.");
+      this->GetManager().LinkVar(SharedData().init_random, "init_random",
+                      "Should we randomize ancestor?  (0 = all zeros)");
+    }
+
+    /// Setup this organism type with the traits it need to track.
+    void SetupModule() override {
+      // Setup the mutation distribution.
+      SharedData().mut_dist.Setup(SharedData().mut_prob, N);
+
+      // Setup the output trait; it starts empty and is built from the words when read.
+      this->GetManager().AddSharedTrait(SharedData().output_name,
+                                        "Bitset output from organism.",
+                                        emp::BitVector());
+    }
+
+    /// Look up the output trait once the DataMap layout is final.
+    void SetupDataMap(const emp::DataMap & dm) override {
+      SharedData().bits_id = dm.GetID(SharedData().output_name);
+    }
+
+  private:
+    size_t GetBitsID() const { return SharedData().bits_id; }
+  };
+
+  using BitsOrg64 = BitsOrgFixed<64>;
+  using BitsOrg128 = BitsOrgFixed<128>;
+  using BitsOrg256 = BitsOrgFixed<256>;
+  using BitsOrg512 = BitsOrgFixed<512>;
+  using BitsOrg1024 = BitsOrgFixed<1024>;
+
+  MABE_REGISTER_ORG_TYPE(BitsOrg64, "Organism consisting of exactly 64 bits, stored inline.");
+  MABE_REGISTER_ORG_TYPE(BitsOrg128, "Organism consisting of exactly 128 bits, stored inline.");
+  MABE_REGISTER_ORG_TYPE(BitsOrg256, "Organism consisting of exactly 256 bits, stored inline.");
+  MABE_REGISTER_ORG_TYPE(BitsOrg512, "Organism consisting of exactly 512 bits, stored inline.");
+  MABE_REGISTER_ORG_TYPE(BitsOrg1024, "Organism consisting of exactly 1024 bits, stored inline.");
+}
+
+#endif
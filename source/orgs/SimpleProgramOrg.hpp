@@ -1,39 +1,40 @@
 /**
  *  @note This file is part of MABE, https://github.com/mercere99/MABE2
  *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
- *  @date 2021.
+ *  @date 2021-2024.
  *
  *  @file SimpleProgramOrg.hpp
- *  @brief A simple organism with a program-based genome.
- *  @note Status: UNFINISHED.
- * 
- *  Tracking scopes became more complex than was intended for this simple model;
- *  shifting back to using ScopeGP hardware from Empirical, but keep this here
- *  to finish later if warranted.
- * 
- *  Main advantages were intended to be:
- *  - Fixed instruction set, so insts can be looked up in a switch block.
- *  - Fixed sized (array based) memory, for less indirection.
- *  - Fixed chunk of memory (rather than array) for faster access.
- *  - Indirect references to memory built in to arguments.
- *  - Rgisters were part of memory, so they could be more dynamically accessed
- * 
- *  Most of these can be explored in other hardware.
+ *  @brief A simple organism with a fixed-length, program-based genome.
+ *  @note Status: ALPHA
+ *
+ *  This organism trades flexibility for speed:
+ *  - Fixed instruction set, so instructions are dispatched through a single switch block.
+ *  - Fixed sized (array based) genome and memory, for less indirection.
+ *  - Indirect references to memory are built in to arguments.
+ *  - Registers are part of memory, so they can be more dynamically accessed.
+ *
+ *  Scopes are resolved once per genome (on construction, mutation, or randomization) by
+ *  PreprocessScopes(), which records where each IF, WHILE, or COUNTDOWN scope ends.  At run
+ *  time, entering, skipping, or leaving a scope is a table lookup rather than a genome scan.
+ *
+ *  Execution state (memory, instruction pointer, and open scopes) is rebuilt on every call to
+ *  GenerateOutput(), so it is not stored in each organism; each thread has one scratch CPU.
  */
 
 #ifndef MABE_SIMPLE_PROGRAM_ORGANISM_H
 #define MABE_SIMPLE_PROGRAM_ORGANISM_H
 
-#include <math.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 
 #include "../core/MABE.hpp"
+#include "../core/MutationSites.hpp"
 #include "../core/Organism.hpp"
 #include "../core/OrganismManager.hpp"
 
 #include "emp/base/array.hpp"
 #include "emp/base/vector.hpp"
-#include "emp/math/Distribution.hpp"
-#include "emp/math/random_utils.hpp"
 
 namespace mabe {
 
@@ -49,26 +50,28 @@ namespace mabe {
       COPY,                              // (1) Copy ARG1 into ARG2
       IF,                                // (1) Set scope to ARG1; Skip if ARG2 is 0.
       WHILE,                             // (1) Set scope to ARG1; repeat as long as ARG2 is non-zero
-      COUNTDOWN,                         // (1) Set scope to ARG1; repeat and dec ARG2 while non-zero
+      COUNTDOWN,                         // (1) Set scope to ARG1; repeat and dec ARG2 while positive
       CONTINUE,                          // (1) Jump back to WHILE or COUNTDOWN start, or prog start
       BREAK,                             // (1) Jump to end of WHILE or COUNTDOWN scope, or halt prog
-      SET_SCOPE,                         // (1) Set the current scope to ARG1 (end deeper scopes)
+      SET_SCOPE,                         // (1) End all scopes at level ARG1 or deeper
       PUSH, POP,                         // (2) Treat ARG1 as stack pointer; push/pop with ARG2
-      NUM_BASE_INSTS,                    // 21 - Marker for total instruction count in base set
-      NONE,                              // Empty instruction!
-      ERROR                              // Invalid instruction!
+      NUM_BASE_INSTS                     // 21 - Marker for total instruction count in base set
     };
 
+    // Each instruction is four bytes: the instruction ID followed by three arguments.
+    //
     // Arguments can be values (constants) or variables (direct or indirect memory positions).
-    // Constants are just used in CONST instrustions where ARG2c is a direct value centered at zero
-    //   Range is -11 to 12 by default.
-    // Variables are:
-    //   direct registers (10: A-J), first four are regs only; next 6 are ALSO indirect memory.
-    //   indirections to internal memory (2: E,F),
-    //   indirections to input memory (2: G,H), uses offset of + 512.
-    //   indirections to output memory (2: I,J), uses offset of + 768.
+    // Constants are only used in CONST instructions, where ARG2c picks from a fixed table.
+    // Variables are (using the low four bits of the argument):
+    //   direct registers (10: A-J); E-J also hold the offsets used by indirect variables.
+    //   indirections to internal memory (2: K,L), using E and F.
+    //   indirections to input memory (2: M,N), using G and H, with an offset of + 512.
+    //   indirections to output memory (2: O,P), using I and J, with an offset of + 768.
+    // Scoped instructions use the low four bits of ARG1 as their scope level.
 
     static constexpr size_t GENOME_SIZE = 64;
+    static constexpr size_t INST_BYTES = 4;
+    static constexpr size_t NUM_SCOPES = 16;
 
     static constexpr size_t NUM_REGS = 16;
     static constexpr size_t MEM_SIZE = 1024;
@@ -76,64 +79,87 @@ namespace mabe {
     static constexpr size_t MEM_INTERNAL_START = 0;
     static constexpr size_t MEM_INPUT_START = 512;
     static constexpr size_t MEM_OUTPUT_START = MEM_INPUT_START + MEM_IO_SIZE;
-    static_assert(MEM_OUTPUT_START + MEM_IO_SIZE <= MEM_SIZE, "IO must fit inside other memoery.");
+    static_assert(MEM_OUTPUT_START + MEM_IO_SIZE <= MEM_SIZE, "IO must fit inside other memory.");
+    static_assert(GENOME_SIZE < 256, "Scope tables store genome positions as single bytes.");
 
     static constexpr size_t MEM_MASK = MEM_SIZE - 1;
+    static constexpr size_t IO_MASK = MEM_IO_SIZE - 1;
     static constexpr size_t REG_MASK = NUM_REGS - 1;
 
-    using genome_t = emp::array<unsigned char, GENOME_SIZE*4>;
-    using jump_map_t = emp::array<size_t, GENOME_SIZE>;
+    using genome_t = emp::array<unsigned char, GENOME_SIZE * INST_BYTES>;
+    using scope_map_t = emp::array<uint8_t, GENOME_SIZE>;
     using memory_t = emp::array<double, MEM_SIZE>;
 
-    genome_t genome;          // Series of instructions.
-    jump_map_t inst_target;  // Pre-processed jump points for CONTINUE, BREAK, or scope ends
-    size_t inst_ptr;          // Position in genome to execute next.
-    memory_t mem;             // Memory for program to manipulate
+    static constexpr const char * INST_NAMES[(size_t) Inst::NUM_BASE_INSTS] = {
+      "GetConst", "AddConst", "MultConst",
+      "Add", "Sub", "Mult", "Div", "Mod", "Nand",
+      "TestEqu", "TestNEqu", "TestLess",
+      "Copy", "If", "While", "Countdown", "Continue", "Break", "SetScope",
+      "Push", "Pop"
+    };
 
-    // Find the instruction with the provided name.
-    Inst GetInst(const emp::String & name) const {
-      const emp::vector<emp::String> & inst_names = SharedData().inst_names;
-      for (size_t i = 0; i < inst_names.size(); i++) {
-        if (inst_names[i] == name) return (Inst) i;
+    /// Everything that changes while a program runs.
+    struct CPUState {
+      memory_t mem;                  ///< Memory for program to manipulate
+      size_t inst_ptr = 0;           ///< Position in genome to execute next.
+      scope_map_t scope_stack;       ///< Start positions of all currently open scopes.
+      size_t scope_depth = 0;        ///< Number of open scopes.
+      bool halted = false;           ///< Has the program stopped (BREAK outside of a loop)?
+
+      void Reset() {
+        mem.fill(0.0);
+        inst_ptr = 0;
+        scope_depth = 0;
+        halted = false;
       }
-      return Inst::ERROR;
+      void PushScope(size_t start) {
+        emp_assert(scope_depth < GENOME_SIZE);
+        scope_stack[scope_depth++] = (uint8_t) start;
+      }
+      size_t TopScope() const { emp_assert(scope_depth > 0); return scope_stack[scope_depth-1]; }
+    };
+
+    genome_t genome;          ///< Series of instructions.
+    scope_map_t scope_end;    ///< For each scoped instruction, the position where its scope ends.
+
+    /// Execution state is rebuilt for every evaluation, so share a single CPU on each thread.
+    static CPUState & GetCPUState() {
+      thread_local CPUState cpu;
+      return cpu;
+    }
+
+    Inst GetInst(size_t pos) const { return (Inst) genome[pos * INST_BYTES]; }
+
+    static bool IsScopeInst(Inst inst) {
+      return inst == Inst::IF || inst == Inst::WHILE || inst == Inst::COUNTDOWN;
     }
 
-    // Find the name associated with a given instruction.
-    const emp::String & GetName(Inst inst) const {
-      return SharedData().inst_names[(size_t) inst];
+    /// Bit pattern for a value; anything outside of the 32-bit range (or NaN) is treated as zero.
+    static size_t ToBits(double value) {
+      if (!(value > -2147483648.0 && value < 2147483648.0)) return 0;
+      return static_cast<uint32_t>(static_cast<int32_t>(value));
     }
 
     // Convert an argument to the associated variable.
-    double & GetArgVar(const unsigned char arg) {
-      // We're assuming 16 registers, where the last 6 are indirections.
+    static double & GetArgVar(memory_t & mem, const unsigned char arg) {
       switch (arg & REG_MASK) {
-        case 0: return mem[0];
-        case 1: return mem[1];
-        case 2: return mem[2];
-        case 3: return mem[3];
-        case 4: return mem[4];
-        case 5: return mem[5];
-        case 6: return mem[6];
-        case 7: return mem[7];
-        case 8: return mem[8];
-        case 9: return mem[9];
-        case 10: return mem[(((size_t) mem[4]) & MEM_MASK)]; // Internal memory.
-        case 11: return mem[(((size_t) mem[5]) & MEM_MASK)]; // Internal memory.
-        case 12: return mem[((MEM_INPUT_START + (size_t) mem[6]) & MEM_MASK)]; // Input memory.
-        case 13: return mem[((MEM_INPUT_START + (size_t) mem[7]) & MEM_MASK)]; // Input memory.
-        case 14: return mem[((MEM_OUTPUT_START + (size_t) mem[8]) & MEM_MASK)]; // Output memory.
-        case 15: return mem[((MEM_OUTPUT_START + (size_t) mem[9]) & MEM_MASK)]; // Output memory.
+        case 10: return mem[ToBits(mem[4]) & MEM_MASK];                     // Internal memory.
+        case 11: return mem[ToBits(mem[5]) & MEM_MASK];                     // Internal memory.
+        case 12: return mem[MEM_INPUT_START + (ToBits(mem[6]) & IO_MASK)];  // Input memory.
+        case 13: return mem[MEM_INPUT_START + (ToBits(mem[7]) & IO_MASK)];  // Input memory.
+        case 14: return mem[MEM_OUTPUT_START + (ToBits(mem[8]) & IO_MASK)]; // Output memory.
+        case 15: return mem[MEM_OUTPUT_START + (ToBits(mem[9]) & IO_MASK)]; // Output memory.
+        default: return mem[arg & REG_MASK];                                // Registers A-J.
       };
     }
 
-    // Convert an argument variable to a size_t
-    size_t GetArgBits(const unsigned char arg) {
-      return (size_t) GetArgVar(arg);
+    // Convert an argument variable to a bit pattern.
+    static size_t GetArgBits(memory_t & mem, const unsigned char arg) {
+      return ToBits(GetArgVar(mem, arg));
     }
 
     // Convert an argument to the associated constant.
-    double GetArgConst(const unsigned char arg) {
+    static double GetArgConst(const unsigned char arg) {
       // Easy access to a range of potentially useful constants.
       switch (arg & REG_MASK) {
         case 0:  return  -2.0;
@@ -145,331 +171,278 @@ namespace mabe {
         case 6:  return   2.0;
         case 7:  return   3.0;
         case 8:  return   4.0;
-        case 9: return   8.0;
+        case 9:  return   8.0;
         case 10: return  16.0;
         case 11: return  32.0;
         case 12: return  64.0;
         case 13: return 128.0;
         case 14: return 256.0;
-        case 15: return 512.0;
-        default: return 0.0;   // Error?
+        default: return 512.0;
       };
     }
 
-
-    // Analyze this program to figure out scope information for each position.
+    /// Analyze this program to find where each scope ends.  A scope opened at level L is closed
+    /// by the next IF, WHILE, COUNTDOWN, or SET_SCOPE at level L or lower (or the genome end).
     void PreprocessScopes() {
-      unsigned char cur_scope = 0;
-      emp::vector<size_t> scope_starts;
-      scope_starts.reserve(16);
-      for (size_t i = 0; i < GENOME_SIZE; i++) {
-        const size_t genome_pos = i*4;
-        switch (genome[genome_pos]) {          
-        case (size_t) Inst::IF:
-          unsigned char new_scope = genome[genome_pos+1] % 16;
-          break;
-        case (size_t) Inst::WHILE:
-        case (size_t) Inst::COUNTDOWN:
-          unsigned char new_scope = genome[genome_pos+1] % 16;
-          break;
-        case (size_t) Inst::SET_SCOPE:
-          unsigned char new_scope = genome[genome_pos+1] % 16;
-          break;
-        case (size_t) Inst::BREAK:
-          break;
-        case (size_t) Inst::CONTINUE:
-          break;
-        default:
-      
-        };
+      scope_map_t open_scopes;
+      emp::array<uint8_t, GENOME_SIZE> open_levels;
+      size_t num_open = 0;
+      for (size_t pos = 0; pos < GENOME_SIZE; pos++) {
+        scope_end[pos] = (uint8_t) (pos + 1);
+        const Inst inst = GetInst(pos);
+        if (!IsScopeInst(inst) && inst != Inst::SET_SCOPE) continue;
+
+        const uint8_t level = genome[pos * INST_BYTES + 1] % NUM_SCOPES;
+        while (num_open > 0 && open_levels[num_open-1] >= level) {
+          scope_end[open_scopes[--num_open]] = (uint8_t) pos;
+        }
+        if (IsScopeInst(inst)) {
+          open_scopes[num_open] = (uint8_t) pos;
+          open_levels[num_open++] = level;
+        }
       }
+      while (num_open > 0) scope_end[open_scopes[--num_open]] = (uint8_t) GENOME_SIZE;
     }
 
-
-    // What kind of scope are we in?
-    Inst GetScopeType() {
-      if (scope_starts.size() == 0) return Inst::NONE;
-      switch (genome[scope_starts.back()]) {
-        case (size_t) Inst::IF:        return Inst::IF;
-        case (size_t) Inst::WHILE:     return Inst::WHILE;
-        case (size_t) Inst::COUNTDOWN: return Inst::COUNTDOWN;
-
-        default: return Inst::ERROR; // The above are the only legal scope types!
-      };
+    /// Skip over any IF scopes to find the innermost open loop, if there is one.
+    bool FindLoop(CPUState & cpu) const {
+      while (cpu.scope_depth > 0 && GetInst(cpu.TopScope()) == Inst::IF) --cpu.scope_depth;
+      return cpu.scope_depth > 0;
     }
 
-    // Jump past the current scope.
-    void SkipScope() {
-      int scope_level = 1;
-      while (scope_level > 0 && inst_ptr < genome.size()) {
-        switch (genome[inst_ptr]) {
-          case (size_t) Inst::IF:
-          case (size_t) Inst::WHILE:
-          case (size_t) Inst::COUNTDOWN:
-            scope_level++;
-            break;
-          case (size_t) Inst::END_SCOPE:
-            scope_level--;
-        }
+    // Execute the next instruction.
+    void RunInst(CPUState & cpu) const {
+      // Close any scopes that end here; a loop jumps back to retest its condition.
+      while (cpu.scope_depth > 0 && scope_end[cpu.TopScope()] == cpu.inst_ptr) {
+        const size_t start = cpu.scope_stack[--cpu.scope_depth];
+        if (GetInst(start) != Inst::IF) { cpu.inst_ptr = start; break; }
       }
-    }
 
-    // Execute the next instruction.
-    void RunInst() {
       // Loop around to zero if we're off the end.
-      if (inst_ptr >= genome.size()) { inst_ptr = 0; }
-
-      const unsigned char cur_inst = genome[inst_ptr];
-      const unsigned char arg1 = genome[inst_ptr+1];
-      const unsigned char arg2 = genome[inst_ptr+2];
-      const unsigned char arg3 = genome[inst_ptr+3];
-      inst_ptr += 4;
-
-      if (cur_inst < (unsigned char) Inst::NUM_BASE_INSTS) {
-        switch ((Inst) cur_inst) {
-        case Inst::GET_CONST:       // Set ARG1 to the constant value represented by ARG2
-          GetArgVar(arg1) = GetArgConst(arg2);
-          break;
-        case Inst::ADD_CONST:
-          GetArgVar(arg1) += GetArgConst(arg2);
-          break;
-        case Inst::MULT_CONST:
-          GetArgVar(arg1) *= GetArgConst(arg2);
-          break;
-        case Inst::ADD:
-          GetArgVar(arg3) = GetArgVar(arg1) + GetArgVar(arg2);
-          break;
-        case Inst::SUB:
-          GetArgVar(arg3) = GetArgVar(arg1) - GetArgVar(arg2);
-          break;
-        case Inst::MULT:
-          GetArgVar(arg3) = GetArgVar(arg1) * GetArgVar(arg2);
-          break;
-        case Inst::DIV:
-          if (GetArgVar(arg2) != 0.0) GetArgVar(arg3) = GetArgVar(arg1) / GetArgVar(arg2);
-          // @CAO Do something on error?
-          break;
-        case Inst::MOD:
-          if (GetArgVar(arg2) != 0.0) GetArgVar(arg3) = std::remainder(GetArgVar(arg1), GetArgVar(arg2));
-          // @CAO Do something on error?
-          break;
-        case Inst::NAND:
-          GetArgVar(arg3) = ~(GetArgBits(arg1) & GetArgBits(arg2));
-          break;
-        case Inst::TEST_EQU:
-          GetArgVar(arg3) = (GetArgVar(arg1) == GetArgVar(arg2));
-          break;
-        case Inst::TEST_NEQU:
-          GetArgVar(arg3) = (GetArgVar(arg1) != GetArgVar(arg2));
-          break;
-        case Inst::TEST_LESS:
-          GetArgVar(arg3) = (GetArgVar(arg1) < GetArgVar(arg2));
-          break;
-        case Inst::COPY:
-          GetArgVar(arg2) = GetArgVar(arg1);
-          break;
-
-        case Inst::IF:
-        case Inst::WHILE:
-        case Inst::COUNTDOWN:  // Differ only at END_SCOPE
-          scope_starts.push_back(inst_ptr - 4); // Enter a new scope!
-          if (GetArgBits(arg1) == 0) SkipScope();
-          break;
-
-        case Inst::CONTINUE:  // Return to the begining of this scope!
-          // Skip over any 'IF' scopes that we may be in.
-          while (GetScopeType() == Inst::IF) scope_starts.pop_back();
-
-          // If we are in a loop, go back to the start; otherwise go to the start of the genome.
-          switch (GetScopeType()) {
-            case Inst::NONE: inst_ptr = 0; break;
-            case Inst::COUNTDOWN:
-              GetArgVar(arg1) -= 1.0;
-              [[fallthrough]];
-            case Inst::WHILE:
-              inst_ptr = scope_starts.back();
-              break;
-            default:
-              emp_error("Internal error; Invalid context for CONTINUE");
-          };
-
-          break;
-        case Inst::BREAK:
-          // Skip over any 'IF' scopes that we may be in, and then one more for break.
-          while (GetScopeType() == Inst::IF) SkipScope();
-          SkipScope();
-          break;
-        case Inst::END_SCOPE:
-          switch (GetScopeType()) {
-            case Inst::NONE: break;                         // No scope?  Ignore it!
-            case Inst::IF: scope_starts.pop_back(); break;  // We are done with the IF!
-            case Inst::COUNTDOWN:
-              GetArgVar(arg1) -= 1.0;
-              [[fallthrough]];
-            case Inst::WHILE:
-              inst_ptr = scope_starts.back();
-              break;
-            default:
-              emp_error("Internal error; Invalid context for CONTINUE");
-          };          
-          break;
-        case Inst::PUSH:
-          {
-            double & stack_ptr = GetArgVar(arg1);
-            mem[(size_t) stack_ptr] = GetArgVar(arg2);
-            stack_ptr += 1.0;
-          }
-          break;
-        case Inst::POP:
-          {
-            double & stack_ptr = GetArgVar(arg1);
-            stack_ptr -= 1.0;
-            GetArgVar(arg2) = mem[(size_t) stack_ptr];
-          }
-          break;
-        };
+      if (cpu.inst_ptr >= GENOME_SIZE) cpu.inst_ptr = 0;
+
+      const size_t cur_pos = cpu.inst_ptr++;
+      const unsigned char * inst_bytes = genome.data() + cur_pos * INST_BYTES;
+      const unsigned char arg1 = inst_bytes[1];
+      const unsigned char arg2 = inst_bytes[2];
+      const unsigned char arg3 = inst_bytes[3];
+      memory_t & mem = cpu.mem;
+
+      switch ((Inst) inst_bytes[0]) {
+      case Inst::GET_CONST:       // Set ARG1 to the constant value represented by ARG2
+        GetArgVar(mem, arg1) = GetArgConst(arg2);
+        break;
+      case Inst::ADD_CONST:
+        GetArgVar(mem, arg1) += GetArgConst(arg2);
+        break;
+      case Inst::MULT_CONST:
+        GetArgVar(mem, arg1) *= GetArgConst(arg2);
+        break;
+      case Inst::ADD:
+        GetArgVar(mem, arg3) = GetArgVar(mem, arg1) + GetArgVar(mem, arg2);
+        break;
+      case Inst::SUB:
+        GetArgVar(mem, arg3) = GetArgVar(mem, arg1) - GetArgVar(mem, arg2);
+        break;
+      case Inst::MULT:
+        GetArgVar(mem, arg3) = GetArgVar(mem, arg1) * GetArgVar(mem, arg2);
+        break;
+      case Inst::DIV: {            // Division by zero does nothing.
+        const double denom = GetArgVar(mem, arg2);
+        if (denom != 0.0) GetArgVar(mem, arg3) = GetArgVar(mem, arg1) / denom;
+        break;
       }
-      // Special instruction! (or nop?)
-      else {
-
+      case Inst::MOD: {            // Modulus by zero does nothing.
+        const double denom = GetArgVar(mem, arg2);
+        if (denom != 0.0) GetArgVar(mem, arg3) = std::remainder(GetArgVar(mem, arg1), denom);
+        break;
+      }
+      case Inst::NAND:
+        GetArgVar(mem, arg3) =
+          (double) (uint32_t) ~(GetArgBits(mem, arg1) & GetArgBits(mem, arg2));
+        break;
+      case Inst::TEST_EQU:
+        GetArgVar(mem, arg3) = (GetArgVar(mem, arg1) == GetArgVar(mem, arg2));
+        break;
+      case Inst::TEST_NEQU:
+        GetArgVar(mem, arg3) = (GetArgVar(mem, arg1) != GetArgVar(mem, arg2));
+        break;
+      case Inst::TEST_LESS:
+        GetArgVar(mem, arg3) = (GetArgVar(mem, arg1) < GetArgVar(mem, arg2));
+        break;
+      case Inst::COPY:
+        GetArgVar(mem, arg2) = GetArgVar(mem, arg1);
+        break;
+
+      case Inst::IF:
+      case Inst::WHILE:              // Differ only when the scope ends.
+        if (GetArgVar(mem, arg2) != 0.0) cpu.PushScope(cur_pos);
+        else cpu.inst_ptr = scope_end[cur_pos];
+        break;
+      case Inst::COUNTDOWN: {
+        double & counter = GetArgVar(mem, arg2);
+        if (counter > 0.0) { counter -= 1.0; cpu.PushScope(cur_pos); }
+        else cpu.inst_ptr = scope_end[cur_pos];
+        break;
+      }
+      case Inst::CONTINUE:           // Retest the current loop, or restart the program.
+        if (FindLoop(cpu)) cpu.inst_ptr = cpu.scope_stack[--cpu.scope_depth];
+        else cpu.inst_ptr = 0;
+        break;
+      case Inst::BREAK:              // Leave the current loop, or halt the program.
+        if (FindLoop(cpu)) cpu.inst_ptr = scope_end[cpu.scope_stack[--cpu.scope_depth]];
+        else cpu.halted = true;
+        break;
+      case Inst::SET_SCOPE:          // Scopes closed here were already handled above.
+        break;
+
+      case Inst::PUSH: {
+        double & stack_ptr = GetArgVar(mem, arg1);
+        mem[ToBits(stack_ptr) & MEM_MASK] = GetArgVar(mem, arg2);
+        stack_ptr += 1.0;
+        break;
+      }
+      case Inst::POP: {
+        double & stack_ptr = GetArgVar(mem, arg1);
+        stack_ptr -= 1.0;
+        GetArgVar(mem, arg2) = mem[ToBits(stack_ptr) & MEM_MASK];
+        break;
       }
+      default:                       // Unknown instructions are treated as no-ops.
+        break;
+      };
+    }
+
+    /// Run the program for up to num_steps instructions.
+    /// @return The number of instructions actually executed (fewer if the program halted).
+    size_t Process(CPUState & cpu, size_t num_steps) const {
+      size_t step = 0;
+      for (; step < num_steps && !cpu.halted; ++step) RunInst(cpu);
+      return step;
+    }
+
+    /// Instruction bytes must be valid instructions; arguments can be anything.
+    void RandomizeByte(size_t pos, emp::Random & random) {
+      const uint32_t max_value = (pos % INST_BYTES) ? 256 : (uint32_t) Inst::NUM_BASE_INSTS;
+      genome[pos] = (unsigned char) random.GetUInt(max_value);
     }
 
   public:
     struct ManagerData : public Organism::ManagerData {
-      emp::String output_name = "vals";  ///< Name of trait that should be used to access values.
-      double mut_prob = 0.01;            ///< Probability of position mutating on reproduction.
-
-      // Helper member variables.
-      emp::Binomial mut_dist;            ///< Distribution of number of mutations to occur.
-      emp::BitVector mut_sites;          ///< A pre-allocated vector for mutation sites.
-
-      // Instruction Set
-      emp::vector<emp::String> inst_names;  ///< Names of all instructions in use.
-      size_t num_regs;                      ///< Number of registers in the CPU.
-      size_t num_indirect_args;             ///< Number of indirect args for each group.
-      size_t const_shift;                   ///< How far should constant arguments be shifted?
+      double mut_prob = 0.01;              ///< Probability of each genome byte mutating.
+      bool init_random = true;             ///< Should we randomize ancestor?  (false = all zeros)
+      size_t eval_time = 500;              ///< How long should the CPU be given on each evaluate?
+      size_t num_outputs = 16;             ///< How many output values should be recorded?
+      emp::String input_name = "input";    ///< Name of trait that should be used load input values
+      emp::String output_name = "output";  ///< Name of trait that should be used store output values
+
+      // Internal use (shared by all orgs)
+      size_t input_id = emp::MAX_SIZE_T;   ///< DataMap ID of inputs (set in SetupDataMap)
+      size_t output_id = emp::MAX_SIZE_T;  ///< DataMap ID of outputs (set in SetupDataMap)
     };
 
     SimpleProgramOrg(OrganismManager<SimpleProgramOrg> & _manager)
-      : OrganismTemplate<SimpleProgramOrg>(_manager) { }
-    SimpleProgramOrg(const SimpleProgramOrg &) = default;
-    SimpleProgramOrg(SimpleProgramOrg &&) = default;
-    SimpleProgramOrg(const genome_t & in, OrganismManager<SimpleProgramOrg> & _manager)
       : OrganismTemplate<SimpleProgramOrg>(_manager)
     {
-      // SharedData().ApplyBounds(vals);  // Make sure all data is within range.
+      genome.fill(0);
+      PreprocessScopes();
     }
-    SimpleProgramOrg(size_t N, OrganismManager<SimpleProgramOrg> & _manager)
-      : OrganismTemplate<SimpleProgramOrg>(_manager) { }
+    SimpleProgramOrg(const SimpleProgramOrg &) = default;
+    SimpleProgramOrg(SimpleProgramOrg &&) = default;
     ~SimpleProgramOrg() { ; }
 
-    emp::String ToString() const override { } // return emp::MakeString(vals, ":(TOTAL=", total, ")"); }
+    emp::String ToString() const override {
+      emp::String out;
+      for (size_t pos = 0; pos < GENOME_SIZE; pos++) {
+        const size_t inst_id = genome[pos * INST_BYTES];
+        out += (inst_id < (size_t) Inst::NUM_BASE_INSTS) ? INST_NAMES[inst_id] : "Unknown";
+        for (size_t arg = 1; arg < INST_BYTES; arg++) {
+          out += ' ';
+          out += (char) ('A' + (genome[pos * INST_BYTES + arg] & REG_MASK));
+        }
+        out += '\n';
+      }
+      return out;
+    }
 
     size_t Mutate(emp::Random & random) override {
-      // Identify number of and positions for mutations.
-      const size_t num_muts = SharedData().mut_dist.PickRandom(random);
-      emp::BitVector & mut_sites = SharedData().mut_sites;
-      mut_sites.ChooseRandom(random, num_muts);
-
-      // SetVar<double>(SharedData().total_name, total);  // Store total in data map.
+      const size_t num_muts = ForEachMutationSite(random, genome.size(), SharedData().mut_prob,
+        [this,&random](size_t pos){ RandomizeByte(pos, random); });
+      if (num_muts) PreprocessScopes();
       return num_muts;
     }
 
     void Randomize(emp::Random & random) override {
-      for (unsigned char & x : genome) { x = random.GetUInt(0, 256); }
+      for (size_t pos = 0; pos < genome.size(); pos++) RandomizeByte(pos, random);
+      PreprocessScopes();
+    }
+
+    void Initialize(emp::Random & random) override {
+      if (SharedData().init_random) Randomize(random);
     }
 
-    /// Put the values in the correct output positions.
+    /// Load inputs into input memory, run the program, and copy output memory to the outputs.
     void GenerateOutput() override {
-      SetVar<emp::vector<double>>(SharedData().output_name, vals);
-      SetVar<double>(SharedData().total_name, total);
+      CPUState & cpu = GetCPUState();
+      cpu.Reset();
+
+      const emp::vector<double> & inputs = GetTrait<emp::vector<double>>(GetInputID());
+      const size_t num_inputs = std::min(inputs.size(), MEM_IO_SIZE);
+      std::copy_n(inputs.begin(), num_inputs, cpu.mem.begin() + MEM_INPUT_START);
+
+      Process(cpu, SharedData().eval_time);
+
+      // Reuse the existing output vector.
+      emp::vector<double> & outputs = GetTrait<emp::vector<double>>(GetOutputID());
+      outputs.resize(SharedData().num_outputs);
+      std::copy_n(cpu.mem.begin() + MEM_OUTPUT_START, outputs.size(), outputs.begin());
     }
 
     /// Setup this organism type to be able to load from config.
     void SetupConfig() override {
-      GetManager().LinkFuns<size_t>([this](){ return vals.size(); },
-                       [this](const size_t & N){ return vals.resize(N, 0.0); },
-                       "N", "Number of values in organism");
       GetManager().LinkVar(SharedData().mut_prob, "mut_prob",
-                      "Probability of each value mutating on reproduction.");
-      GetManager().LinkVar(SharedData().mut_size, "mut_size",
-                      "Standard deviation on size of mutations.");
-      GetManager().LinkVar(SharedData().min_value, "min_value",
-                      "Lower limit for value fields.");
-      GetManager().LinkVar(SharedData().max_value, "max_value",
-                      "Upper limit for value fields.");
-      GetManager().LinkMenu(
-        SharedData().lower_bound, "lower_bound", "How should the lower limit be enforced?",
-        LIMIT_NONE, "no_limit", "Allow values to be arbirarily low.",
-        LIMIT_CLAMP, "clamp", "Reduce too-low values to min_value.",
-        LIMIT_WRAP, "wrap", "Make low values loop around to maximum.",
-        LIMIT_REBOUND, "rebound", "Make low values 'bounce' back up." );
-      GetManager().LinkMenu(
-        SharedData().upper_bound, "upper_bound", "How should the upper limit be enforced?",
-        LIMIT_NONE, "no_limit", "Allow values to be arbirarily high.",
-        LIMIT_CLAMP, "clamp", "Reduce too-high values to max_value.",
-        LIMIT_WRAP, "wrap", "Make high values loop around to minimum.",
-        LIMIT_REBOUND, "rebound", "Make high values 'bounce' back down." );
+                      "Probability of each genome byte mutating on reproduction.");
+      GetManager().LinkVar(SharedData().init_random, "init_random",
+                      "Should we randomize ancestor?  (0 = \"blank\" default)");
+      GetManager().LinkVar(SharedData().eval_time, "eval_time",
+                      "How many CPU cycles should we give organisms to run?");
+      GetManager().LinkVar(SharedData().num_outputs, "num_outputs",
+                      "How many values from output memory should be recorded?");
+      GetManager().LinkVar(SharedData().input_name, "input_name",
+                      "Name of variable to load inputs from.");
       GetManager().LinkVar(SharedData().output_name, "output_name",
-                      "Name of variable to contain set of values.");
-      GetManager().LinkVar(SharedData().total_name, "total_name",
-                      "Name of variable to contain total of all values.");
+                      "Name of variable to output results.");
     }
 
     /// Setup this organism type with the traits it need to track.
     void SetupModule() override {
       auto & data = SharedData();
+      if (data.num_outputs > MEM_IO_SIZE) {
+        emp::notify::Error("SimpleProgramOrg can have at most ", MEM_IO_SIZE, " outputs; ",
+                           data.num_outputs, " requested.");
+        data.num_outputs = MEM_IO_SIZE;
+      }
 
-      // Setup the mutation distribution.
-      data.mut_dist.Setup(data.mut_prob, vals.size());
-
-      // Setup the default vector to indicate mutation positions.
-      data.mut_sites.Resize(vals.size());
-
-      // Setup the output trait.
+      // Setup the input and output traits.
+      GetManager().AddRequiredTrait<emp::vector<double>>(data.input_name);
       GetManager().AddSharedTrait(data.output_name,
-                                  "Value vector output from organism.",
-                                  emp::vector<double>(vals.size()));
-      // Setup the output trait.
-      GetManager().AddSharedTrait(data.total_name,
-                                  "Total of all organism outputs.",
-                                  0.0);
-
-      // Setup the instruction set.
-      data.inst_names.resize((size_t) Inst::NUM_BASE_INSTS);
-      data.inst_names[(size_t) Inst::GET_CONST] = "GetConst";
-      data.inst_names[(size_t) Inst::ADD_CONST] = "AddConst";
-      data.inst_names[(size_t) Inst::MULT_CONST] = "MultConst";
-      data.inst_names[(size_t) Inst::ADD] == "Add";
-      data.inst_names[(size_t) Inst::SUB] == "Sub";
-      data.inst_names[(size_t) Inst::MULT] == "Mult";
-      data.inst_names[(size_t) Inst::DIV] == "Div";
-      data.inst_names[(size_t) Inst::MOD] == "Mod";
-      data.inst_names[(size_t) Inst::NAND] == "Nand";
-      data.inst_names[(size_t) Inst::TEST_EQU] == "TestEqu";
-      data.inst_names[(size_t) Inst::TEST_NEQU] == "TestNEqu";
-      data.inst_names[(size_t) Inst::TEST_LESS] == "TestLess";
-      data.inst_names[(size_t) Inst::COPY] == "Copy";
-      data.inst_names[(size_t) Inst::IF] == "If";
-      data.inst_names[(size_t) Inst::WHILE] == "While";
-      data.inst_names[(size_t) Inst::COUNTDOWN] == "Countdown";
-      data.inst_names[(size_t) Inst::CONTINUE] == "Continue";
-      data.inst_names[(size_t) Inst::BREAK] == "Break";
-      data.inst_names[(size_t) Inst::END_SCOPE] == "EndScope";
-      data.inst_names[(size_t) Inst::POP] == "Pop";
-      data.inst_names[(size_t) Inst::PUSH] == "Push";
-      
-      // @CAO ADD NON-STANDARD INSTRUCTIONS!
-
-      data.num_indirect_args = data.inst_names.size() / 8;
-      data.const_shift = 4 * data.num_indirect_args;
-      data.num_regs = data.inst_names.size() - data.const_shift;
+                                  "Values from output memory of organism.",
+                                  emp::vector<double>(data.num_outputs, 0.0));
     }
+
+    /// Look up the input and output traits once all traits are in place.
+    void SetupDataMap(const emp::DataMap & dm) override {
+      SharedData().input_id = dm.GetID(SharedData().input_name);
+      SharedData().output_id = dm.GetID(SharedData().output_name);
+    }
+
+  private:
+    size_t GetInputID() const { return SharedData().input_id; }
+    size_t GetOutputID() const { return SharedData().output_id; }
   };
 
 
-  MABE_REGISTER_ORG_TYPE(SimpleProgramOrg, "Organism consisting of a series of N floating-point values.");
+  MABE_REGISTER_ORG_TYPE(SimpleProgramOrg, "Organism consisting of a fixed-length linear program.");
 }
 
 #endif
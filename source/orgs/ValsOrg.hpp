@@ -11,10 +11,15 @@
 #ifndef MABE_VALS_ORGANISM_H
 #define MABE_VALS_ORGANISM_H
 
+#include "../core/GenomeIO.hpp"
 #include "../core/MABE.hpp"
+#include "../core/MutationSites.hpp"
 #include "../core/Organism.hpp"
 #include "../core/OrganismManager.hpp"
 
+#include <algorithm>
+#include <array>
+
 #include "emp/datastructs/span_utils.hpp"
 #include "emp/math/Distribution.hpp"
 #include "emp/math/random_utils.hpp"
@@ -23,7 +28,7 @@
 namespace mabe {
 
   class ValsOrg : public OrganismTemplate<ValsOrg> {
-  protected:
+  public:
     // How do we enforce limits on values?
     enum BoundType {
       LIMIT_NONE=0,  // No boundary limit.  (e.g., in a 0 to 100 range, 103 would stay 103)
@@ -33,12 +38,78 @@ namespace mabe {
       LIMIT_ERROR    // Invalid limit type.
     };
 
+  protected:
+    /// Mutation rates at or above this use the dense (block-based) mutation path.  Both paths
+    /// scale linearly with num_vals (sparse with the expected num_vals * mut_prob mutations,
+    /// dense with one draw per site), so the crossover depends only on mut_prob.
+    static constexpr double DENSE_MUT_PROB = 0.1;
+
     void CalculateTotal(const std::span<double> & vals) {
-      double total = 0.0;
-      for (double x : vals) total += x;
-      SetTrait<double>(SharedData().total_name, total);
+      // Use independent partial sums so the compiler can vectorize the reduction.
+      double partial[4] = { 0.0, 0.0, 0.0, 0.0 };
+      const size_t num_quads = vals.size() / 4;
+      for (size_t i = 0; i < num_quads * 4; i += 4) {
+        partial[0] += vals[i];
+        partial[1] += vals[i+1];
+        partial[2] += vals[i+2];
+        partial[3] += vals[i+3];
+      }
+      double total = (partial[0] + partial[1]) + (partial[2] + partial[3]);
+      for (size_t i = num_quads * 4; i < vals.size(); ++i) total += vals[i];
+      GetTotal() = total;
+    }
+
+    /// Sparse mutation: skip directly from one mutated site to the next, updating the total
+    /// incrementally.
+    size_t MutateSparse(emp::Random & random, std::span<double> vals) {
+      double & total = GetTotal();
+      return ForEachMutationSite(random, vals.size(), SharedData().mut_prob,
+        [this, vals, &total, &random](size_t mut_pos) {
+          double & cur_val = vals[mut_pos];        // Identify the next site to mutate.
+          total -= cur_val;                        // Remove old value from the total.
+          cur_val += random.GetNormal();           // Mutate the value at the site.
+          SharedData().ApplyBounds(cur_val);       // Make sure the value stays in the allowed range.
+          total += cur_val;                        // Add the update value back into the total.
+        });
     }
 
+    /// Dense mutation: draw changes for a block of sites at a time, then apply them with
+    /// branch-free loops over the whole block and recalculate the total.  As with the sparse
+    /// path, bounds are only applied to the sites that mutated.
+    size_t MutateDense(emp::Random & random, std::span<double> vals) {
+      constexpr size_t BLOCK_SIZE = 64;
+      std::array<double, BLOCK_SIZE> deltas;
+      std::array<bool, BLOCK_SIZE> mutated;
+      const double mut_prob = SharedData().mut_prob;
+      size_t num_muts = 0;
+      for (size_t start = 0; start < vals.size(); start += BLOCK_SIZE) {
+        const size_t block_size = std::min(BLOCK_SIZE, vals.size() - start);
+
+        // Random draws are serial, so collect all changes for this block first.
+        for (size_t i = 0; i < block_size; ++i) {
+          mutated[i] = random.P(mut_prob);
+          deltas[i] = mutated[i] ? random.GetNormal() : 0.0;
+          num_muts += mutated[i];
+        }
+
+        std::span<double> block = vals.subspan(start, block_size);
+        for (size_t i = 0; i < block_size; ++i) {
+          const double new_val = SharedData().BoundValue(block[i] + deltas[i]);
+          block[i] = mutated[i] ? new_val : block[i];
+        }
+      }
+      CalculateTotal(vals);
+      return num_muts;
+    }
+
+    /// Values live directly in the genome trait.
+    std::span<double> GetVals() { return GetTrait<double>(GetGenomeID(), SharedData().num_vals); }
+    std::span<const double> GetVals() const {
+      return GetTrait<double>(GetGenomeID(), SharedData().num_vals);
+    }
+    double & GetTotal() { return GetTrait<double>(GetTotalID()); }
+    double GetTotal() const { return GetTrait<double>(GetTotalID()); }
+
   public:
     struct ManagerData : public Organism::ManagerData {
       emp::String genome_name = "vals";  ///< Name of trait that should be used to access values.
@@ -52,13 +123,16 @@ namespace mabe {
       BoundType lower_bound = LIMIT_REBOUND;
 
       // Helper member variables.
-      emp::Binomial mut_dist;            ///< Distribution of number of mutations to occur.
-      emp::BitVector mut_sites;          ///< A pre-allocated vector for mutation sites. 
+      size_t genome_id = emp::MAX_SIZE_T; ///< DataMap ID of genome (set in SetupDataMap)
+      size_t total_id = emp::MAX_SIZE_T;  ///< DataMap ID of total (set in SetupDataMap)
       bool init_random = true;           ///< Should we randomize ancestor?  (false = all 0.0)
 
       // Helper functions.
-      inline void ApplyBounds(double & value);              ///< Put a single value back in range.
-      inline void ApplyBounds(std::span<double> & vals);  ///< Put all values back in range.
+      inline double BoundValue(double value) const;         ///< Value after applying limits.
+      inline void ApplyBounds(double & value) const { value = BoundValue(value); }
+      inline void ApplyBounds(std::span<double> vals) const {
+        for (double & value : vals) value = BoundValue(value);
+      }
     };
 
     ValsOrg(OrganismManager<ValsOrg> & _manager)
@@ -68,60 +142,59 @@ namespace mabe {
     ~ValsOrg() { ; }
 
     emp::String ToString() const override {
-      std::span<const double> vals = GetTrait<double>(SharedData().genome_name, SharedData().num_vals);
-      const double total = GetTrait<double>(SharedData().total_name);
-      return emp::MakeString(vals, ":(TOTAL=", total, ")");
+      return emp::MakeString(GetVals(), ":(TOTAL=", GetTotal(), ")");
     }
 
     size_t Mutate(emp::Random & random) override {
-      // Identify number of and positions for mutations.
-      const size_t num_muts = SharedData().mut_dist.PickRandom(random);
-      emp::BitVector & mut_sites = SharedData().mut_sites;
-      mut_sites.ChooseRandom(random, num_muts);
-      std::span<double> vals = GetTrait<double>(SharedData().genome_name, SharedData().num_vals);
-      double & total = GetTrait<double>(SharedData().total_name);
-
-      // Trigger mutations at the identified positions.
-      int mut_pos = mut_sites.FindOne();
-      while (mut_pos != -1) {
-        double & cur_val = vals[mut_pos];        // Identify the next site to mutate.
-        total -= cur_val;                        // Remove old value from the total.
-        cur_val += random.GetNormal();           // Mutate the value at the site.
-        SharedData().ApplyBounds(cur_val);       // Make sure the value stays in the allowed range.
-        total += cur_val;                        // Add the update value back into the total.
-        mut_pos = mut_sites.FindOne(mut_pos+1);  // Move on to the next site to mutate.
-      }
-
-      SetTrait<double>(SharedData().total_name, total);  // Store total in data map.
-      return num_muts;
+      std::span<double> vals = GetVals();
+      const size_t num_muts = (SharedData().mut_prob < DENSE_MUT_PROB) ?
+        MutateSparse(random, vals) : MutateDense(random, vals);
+      return num_muts;  // Total was updated in place in the data map.
     }
 
     void Randomize(emp::Random & random) override {
-      std::span<double> vals = GetTrait<double>(SharedData().genome_name, SharedData().num_vals);
+      std::span<double> vals = GetVals();
       double total = 0.0;
       for (double & x : vals) {
         x = random.GetDouble(SharedData().min_value, SharedData().max_value);
         total += x;
       }
-      SetTrait<double>(SharedData().total_name, total);  // Store total in data map.
+      GetTotal() = total;  // Store total in data map.
     }
 
     void Initialize(emp::Random & random) override {
       if (SharedData().init_random) Randomize(random);
       else { 
-        std::span<double> vals = GetTrait<double>(SharedData().genome_name, SharedData().num_vals);
-        double total = 0.0;
-        for (double & x : vals) x = 0.0;
-        SetTrait<double>(SharedData().total_name, total);  // Store total in data map.
+        for (double & x : GetVals()) x = 0.0;
+        GetTotal() = 0.0;  // Store total in data map.
       }
     }
 
+    /// Binary genomes are the number of values followed by the raw doubles.
+    bool WriteGenome(std::ostream & os) const override {
+      std::span<const double> vals = GetVals();
+      WriteBinary<uint64_t>(os, vals.size());
+      WriteBinarySpan(os, vals);
+      return os.good();
+    }
 
-    /// Put the values in the correct output positions.
-    void GenerateOutput() override {
-      /// Output is already stored in the DataMap.
+    bool ReadGenome(std::istream & is) override {
+      uint64_t num_vals = 0;
+      if (!ReadBinary(is, num_vals)) return false;
+      if (num_vals != SharedData().num_vals) {
+        emp::notify::Error("ValsOrg genome has ", num_vals, " values, but organisms are ",
+                           "configured for ", SharedData().num_vals, ".");
+        return false;
+      }
+      std::span<double> vals = GetVals();
+      if (!ReadBinarySpan(is, vals)) return false;
+      CalculateTotal(vals);
+      return true;
     }
 
+    /// Values are already stored in the genome trait, so there is no output to generate.
+    void GenerateOutput() override { }
+
     /// Setup this organism type to be able to load from config.
     void SetupConfig() override {
       GetManager().LinkVar(SharedData().num_vals, "N", "Number of values in organism");
@@ -155,12 +228,6 @@ namespace mabe {
 
     /// Setup this organism type with the traits it need to track.
     void SetupModule() override {
-      // Setup the mutation distribution.
-      SharedData().mut_dist.Setup(SharedData().mut_prob, SharedData().num_vals);
-
-      // Setup the default vector to indicate mutation positions.
-      SharedData().mut_sites.Resize(SharedData().num_vals);
-
       // Setup the output trait.
       GetManager().AddSharedTrait(SharedData().genome_name,
                                   "Value array output from organism.",
@@ -171,58 +238,44 @@ namespace mabe {
                                   "Total of all organism outputs.",
                                   0.0);
     }
+
+    /// Look up the genome and total traits once all traits are in place.
+    void SetupDataMap(const emp::DataMap & dm) override {
+      SharedData().genome_id = dm.GetID(SharedData().genome_name);
+      SharedData().total_id = dm.GetID(SharedData().total_name);
+    }
+
+  private:
+    size_t GetGenomeID() const { return SharedData().genome_id; }
+    size_t GetTotalID() const { return SharedData().total_id; }
   };
 
   ///////////////////////////////////////////////////////////////////////////////////////////
   //  Helper functions....
 
-  void ValsOrg::ManagerData::ApplyBounds(double & value) {
-    if (value > max_value) {
-      switch (upper_bound) {
-        case LIMIT_NONE:    break;
-        case LIMIT_CLAMP:   value = max_value; break;
-        case LIMIT_WRAP:    value -= (max_value - min_value); break;
-        case LIMIT_REBOUND: value = 2 * max_value - value; break;
-        case LIMIT_ERROR:   break;  // For now; perhaps do something with error?
-      }
-    }
-    else if (value < min_value) {
-      switch (lower_bound) {
-        case LIMIT_NONE:    break;
-        case LIMIT_CLAMP:   value = min_value; break;
-        case LIMIT_WRAP:    value += (max_value - min_value); break;
-        case LIMIT_REBOUND: value = 2 * min_value - value; break;
-        case LIMIT_ERROR:   break;  // For now; perhaps do something with error?
-      }
-    }
-  }
-
-  void ValsOrg::ManagerData::ApplyBounds(std::span<double> & vals) {
-    const size_t range_size = max_value - min_value;
+  // Both the single-value and the span versions of ApplyBounds() use this function, so sparse
+  // and dense mutations are always bounded the same way.  The upper limit is applied first,
+  // then the lower limit (in case the upper limit moved the value below the range).  Each
+  // policy leaves in-range values unchanged and has no data-dependent branches, so that loops
+  // over many values can be vectorized.
+  double ValsOrg::ManagerData::BoundValue(double value) const {
+    const double range_size = max_value - min_value;
 
     switch (upper_bound) {
-    case LIMIT_NONE: break;
-    case LIMIT_CLAMP:
-      for (double & value : vals) {
-        if (value > max_value) value = max_value;
-        else if (value < min_value) value = min_value;        
-      }
-      break;
-    case LIMIT_WRAP:
-      for (double & value : vals) {
-        if (value > max_value) value -= range_size;
-        else if (value < min_value) value += range_size;        
-      }
-      break;
-    case LIMIT_REBOUND:
-      for (double & value : vals) {
-        if (value > max_value) value = 2 * max_value - value;
-        else if (value < min_value) value = 2 * min_value - value;
-      }
-      break;
-    default:
-      break; // Should probably throw error.
+      case LIMIT_CLAMP:   value = std::min(value, max_value); break;
+      case LIMIT_WRAP:    value -= (value > max_value) * range_size; break;
+      case LIMIT_REBOUND: value = std::min(value, 2 * max_value - value); break;
+      default:            break;  // LIMIT_NONE, or LIMIT_ERROR (for now; perhaps flag error?)
     }
+
+    switch (lower_bound) {
+      case LIMIT_CLAMP:   value = std::max(value, min_value); break;
+      case LIMIT_WRAP:    value += (value < min_value) * range_size; break;
+      case LIMIT_REBOUND: value = std::max(value, 2 * min_value - value); break;
+      default:            break;  // LIMIT_NONE, or LIMIT_ERROR (for now; perhaps flag error?)
+    }
+
+    return value;
   }
 
 
@@ -14,6 +14,13 @@
  *    including support for additional nops, labels, and expanded nop notation for 
  *    math instructions.
  *
+ *  Instruction modules should register member functions with AddInstFunc().  Along with the
+ *    general (type-erased) action, this records a plain function pointer for the instruction.
+ *    If fast_inst_dispatch is on, these are collected into a dense table indexed by inst.idx
+ *    that ProcessStep() calls directly, bypassing the instruction library's std::function.
+ *    Instructions with any functions added some other way fall back to the instruction
+ *    library, which calls every function in their action.
+ *
  *  @note Status: ALPHA
  *
  *  TODO: 
@@ -25,9 +32,14 @@
 #ifndef MABE_VIRTUAL_CPU_ORGANISM_H
 #define MABE_VIRTUAL_CPU_ORGANISM_H
 
+#include <algorithm>
 #include <filesystem>
+#include <functional>
+#include <optional>
 
+#include "../core/GenomeIO.hpp"
 #include "../core/MABE.hpp"
+#include "../core/MutationSites.hpp"
 #include "../core/Organism.hpp"
 #include "../core/OrganismManager.hpp"
 
@@ -57,9 +69,146 @@ namespace mabe {
     using data_vec_t = emp::vector<data_t>;
     using inst_func_t = std::function<void(this_t&, const this_t::inst_t&)>;
 
+    /// A directly callable instruction: a plain function and the module it should act on.
+    struct FastInst {
+      using fun_t = void (*)(void *, this_t &, const inst_t &);
+      fun_t fun = nullptr;
+      void * mod_ptr = nullptr;
+
+      void operator()(this_t & hw, const inst_t & inst) const { fun(mod_ptr, hw, inst); }
+    };
+    using fast_inst_vec_t = emp::vector<FastInst>;
+
+    /// Register arguments for an instruction, resolved (once) from the nops that follow it.
+    struct DecodedArgs {
+      uint8_t result = 1;        ///< First argument (e.g., destination); default B.
+      uint8_t operand1 = 1;      ///< First math operand (always B without expanded nops).
+      uint8_t operand2 = 2;      ///< Second math operand (always C without expanded nops).
+      uint8_t compare = 2;       ///< Register to compare against result (e.g., If instructions).
+      uint8_t nops_to_skip = 0;  ///< Nops an If instruction skips after its test.
+    };
+
+    /// Parent state that an offspring's merit is calculated from.  A birth may be deferred
+    /// until after the parent has reset (e.g., when organisms run in parallel), so this can be
+    /// recorded when the offspring divides off and restored for the birth.
+    struct DivideInfo {
+      double offspring_merit = 0.0;   ///< Parent's offspring merit trait.
+      size_t num_insts_copied = 0;    ///< Instructions the parent had copied.
+      size_t num_insts_executed = 0;  ///< Instructions the parent had executed.
+    };
+
   protected: 
     size_t insts_speculatively_executed = 0;
     emp::BitVector non_speculative_inst_vec;
+    emp::vector<DecodedArgs> decoded_args;  ///< Decoded args for each working genome position.
+    DecodedArgs scratch_args;               ///< Args for an instruction outside working genome.
+    std::optional<DivideInfo> divide_info;  ///< Recorded parent state for the next offspring.
+
+    /// A previous label or nop-sequence search, along with the positions it depends on.
+    struct SearchResult {
+      size_t inst_ptr;      ///< Position of the search instruction.
+      size_t search_type;   ///< Type of search (see GetSearchType()).
+      size_t result;        ///< Position found.
+      size_t scan_start;    ///< First position that the search could have read...
+      size_t scan_length;   ///< ...and how many positions (wrapping around) from there.
+      size_t key_length;    ///< Positions from inst_ptr holding the nops searched for.
+
+      /// Could a write to the given position change this result?
+      bool DependsOn(size_t pos, size_t genome_size) const {
+        return (pos + genome_size - scan_start) % genome_size < scan_length ||
+               (pos + genome_size - inst_ptr) % genome_size < key_length;
+      }
+    };
+
+    /// Each search instruction in a genome usually has only one or two results in use, so a
+    /// short vector is searched linearly.  Results are kept until the working genome is reset
+    /// or resized, or a write lands on a position they depend on.
+    emp::vector<SearchResult> search_cache;
+    size_t search_cache_genome_size = 0;  ///< Working genome size when results were cached.
+
+    /// Searches are identified by type (label or nop sequence), start_local, and reverse.
+    static constexpr size_t GetSearchType(bool is_seq, bool start_local, bool reverse) {
+      return is_seq * 4 + start_local * 2 + reverse;
+    }
+
+    /// Return the cached result of a search from the current IP, running search_fun if needed.
+    /// Searches scan the working genome in order from their start (the IP if start_local,
+    /// otherwise the start or end of the genome) until they find a match, so the result only
+    /// depends on the positions scanned, plus the nops after the IP and after the match.
+    template <typename FUN_T>
+    size_t CachedSearch(bool start_local, bool reverse, size_t search_type, FUN_T && search_fun) {
+      const size_t genome_size = genome_working.size();
+      if (genome_size != search_cache_genome_size) {
+        ClearSearchCache();
+        search_cache_genome_size = genome_size;
+      }
+      for (const SearchResult & cached : search_cache) {
+        if (cached.inst_ptr == inst_ptr && cached.search_type == search_type) return cached.result;
+      }
+
+      const size_t result = search_fun();
+      if (genome_size == 0) return result;
+
+      // If there was no match, the search depends on the whole genome.
+      SearchResult cached{inst_ptr, search_type, result, 0, genome_size,
+                          genome_working[inst_ptr].nop_vec.size() + 1};
+      if (result != inst_ptr) {
+        // Count positions going forward from one position to another, wrapping around.
+        auto dist = [genome_size](size_t from, size_t to){
+          return (to + genome_size - from) % genome_size;
+        };
+        const size_t match_length = genome_working[result].nop_vec.size() + 1;
+        if (reverse) {
+          const size_t scan_from = start_local ? inst_ptr : genome_size - 1;
+          cached.scan_start = result;
+          cached.scan_length = std::max(dist(result, scan_from) + 1, match_length);
+        } else {
+          const size_t scan_from = start_local ? inst_ptr : 0;
+          cached.scan_start = scan_from;
+          cached.scan_length = dist(scan_from, result) + match_length;
+        }
+        cached.scan_length = std::min(cached.scan_length, genome_size);
+      }
+      search_cache.push_back(cached);
+      return result;
+    }
+
+    void ClearSearchCache() { search_cache.resize(0); }
+
+    /// Forget any search results that a write to the given working-genome position could change.
+    void InvalidateSearches(size_t pos) {
+      const size_t genome_size = genome_working.size();
+      auto remove_it = std::remove_if(search_cache.begin(), search_cache.end(),
+        [pos, genome_size](const SearchResult & cached){ return cached.DependsOn(pos, genome_size); });
+      search_cache.erase(remove_it, search_cache.end());
+    }
+
+    /// Resolve the register arguments of a single instruction from its (curated) nops.
+    DecodedArgs DecodeArgs(const inst_t & inst) {
+      const auto & nops = inst.nop_vec;
+      DecodedArgs args;
+      args.result = nops.empty() ? 1 : nops[0];
+      if (expanded_nop_args) {
+        args.operand1 = nops.size() < 2 ? args.result : nops[1];
+        args.operand2 = nops.size() < 3 ? GetComplementNop(args.operand1) : nops[2];
+        args.compare = nops.size() < 2 ? GetComplementNop(args.result) : nops[1];
+        args.nops_to_skip = nops.size();
+      }
+      else {
+        args.compare = GetComplementNop(args.result);
+        args.nops_to_skip = nops.empty() ? 0 : 1;
+      }
+      return args;
+    }
+
+    /// The genome string trait is only rebuilt when something reads it.
+    void MarkGenomeStringStale() { MarkTraitStale(SharedData().genome_trait.GetID()); }
+
+    void UpdateStaleTrait(size_t trait_id) override {
+      if (trait_id == SharedData().genome_trait.GetID()) {
+        SharedData().genome_trait(*this) = GetGenomeString();
+      }
+    }
 
     /// Perform a single point mutation at the given position
     void Mutate_Point(size_t pos, emp::Random& random){
@@ -80,47 +229,52 @@ namespace mabe {
 
     /// Apply mutations according to the passed parameters, and then call the given function 
     /// for each mutation
+    template <typename FUN_T>
     size_t Mutate_Generic(
-        std::function<void(size_t, emp::Random&)> mut_func,
+        FUN_T && mut_func,
         emp::CombinedBinomialDistribution& dist, 
         emp::Random& random, 
         bool ensure_unique_pos = true){
       const size_t num_muts = dist.PickRandom(GetGenomeSize(), random);
 
-      if(num_muts == 0){
-        return 0;
+      if(ensure_unique_pos){ // Ensure no two mutations hit the same site
+        return ForEachDistinctSite(random, GetGenomeSize(), num_muts,
+                                   [&mut_func, &random](size_t pos){ mut_func(pos, random); });
       }
-      if(num_muts == 1){
+      // Mutate without concern of mutations hitting the same site (e.g., deletion)
+      for (size_t i = 0; i < num_muts; i++) {
         const size_t pos = random.GetUInt(GetGenomeSize());
         mut_func(pos, random);
-        return 1;
-      }
-      // Only remaining option is num_muts > 1.
-      if(ensure_unique_pos){ // Ensure no two mutations hit the same site
-        emp::BitVector mut_sites(genome.size());
-        for (size_t i = 0; i < num_muts; i++) {
-          const size_t pos = random.GetUInt(GetGenomeSize());
-          if(mut_sites[pos]){ --i; continue; } // Duplicate position; try again.
-          mut_sites[pos] = true;
-          mut_func(pos, random);
-          if(mut_sites.size() != GetGenomeSize()){
-            mut_sites.resize(GetGenomeSize());
-          }
-        }
-      }
-      else{ // Mutate without concern of mutations hitting the same site (e.g., deletion)
-        for (size_t i = 0; i < num_muts; i++) {
-          const size_t pos = random.GetUInt(GetGenomeSize());
-          mut_func(pos, random);
-        }
       }
       return num_muts;
     }
 
+    /// Call an instruction module's member function; used to build FastInst entries.
+    template <typename MOD_T, auto INST_FUN>
+    static void CallModuleInst(void * mod_ptr, this_t & hw, const inst_t & inst) {
+      (static_cast<MOD_T *>(mod_ptr)->*INST_FUN)(hw, inst);
+    }
+
   public:
     VirtualCPUOrg(OrganismManager<VirtualCPUOrg> & _manager)
-      : OrganismTemplate<VirtualCPUOrg>(_manager), VirtualCPU(genome_t(GetInstLib()) ){ }
+      : OrganismTemplate<VirtualCPUOrg>(_manager)
+      , VirtualCPU(genome_t(_manager.GetManagedData().inst_lib)) { }
     VirtualCPUOrg(const VirtualCPUOrg &) = default;
+
+    /// Tag to select the offspring constructor below.
+    struct OffspringTag { };
+
+    /// Build an offspring of parent.  Traits and settings are copied from the parent, but the
+    /// genome is moved out of the (copied) offspring genome trait rather than copying the
+    /// parent's own genome only to overwrite it.
+    VirtualCPUOrg(const VirtualCPUOrg & parent, OffspringTag)
+      : OrganismTemplate<VirtualCPUOrg>(parent), VirtualCPU(genome_t(parent.GetInstLib())),
+        non_speculative_inst_vec(parent.non_speculative_inst_vec)
+    {
+      genome_t & offspring_genome = SharedData().offspring_genome_trait(*this);
+      genome = std::move(offspring_genome);
+      offspring_genome.clear();  // Leave the offspring's own buffer empty.
+    }
     VirtualCPUOrg(VirtualCPUOrg &&) = default;
     ~VirtualCPUOrg() { ; }
 
@@ -167,11 +321,16 @@ namespace mabe {
                                                    execute instruction.*/
       int max_speculative_insts = -1;         /**< Maximum number of insts. to speculatively 
                                                   execute. -1 for genome length. */
+      bool fast_inst_dispatch = true;  /**< Should instructions registered with AddInstFunc()
+                                            be called directly, skipping type-erased actions? */
+      int inst_pop_id = 0;  ///< Population whose action map provides the instructions.
+
       // Internal use
+      inst_lib_t inst_lib;  ///< Instruction library shared by all organisms of this manager.
+      fast_inst_vec_t fast_inst_table; ///< Direct call for each inst.idx (null fun = use inst_lib)
       emp::CombinedBinomialDistribution point_mut_dist; ///< Distribution of number of point mutations to occur.
       emp::CombinedBinomialDistribution insertion_mut_dist; ///< Distribution of number of insertion mutations to occur.
       emp::CombinedBinomialDistribution deletion_mut_dist; ///< Distribution of number of deletion mutations to occur.
-      emp::BitVector mut_sites; ///< A pre-allocated vector for mutation sites. 
     };
 
     /// Mutate (in place) the current organism.
@@ -191,7 +350,8 @@ namespace mabe {
       );
       // Update hardware and traits accordingly
       ResetWorkingGenome();
-      SharedData().genome_trait(*this) = GetGenomeString();
+      ClearSearchCache();
+      MarkGenomeStringStale();
       SharedData().length_trait(*this) = GetGenomeSize();
       return mut_count;
     }
@@ -202,7 +362,8 @@ namespace mabe {
         RandomizeInst(pos, random);
       }
       ResetWorkingGenome();
-      SharedData().genome_trait(*this) = GetGenomeString();
+      ClearSearchCache();
+      MarkGenomeStringStale();
       SharedData().length_trait(*this) = GetGenomeSize();
     }
 
@@ -214,6 +375,59 @@ namespace mabe {
       ResetWorkingGenome();
     }
 
+    /// Build nop lists and then decode the arguments of every instruction in the working genome.
+    void CurateNops() {
+      base_t::CurateNops();
+      ClearSearchCache();
+      decoded_args.resize(genome_working.size());
+      for (size_t pos = 0; pos < genome_working.size(); ++pos) {
+        decoded_args[pos] = DecodeArgs(genome_working[pos]);
+      }
+    }
+
+    /// The working genome changed size (e.g., on HAlloc); decode only positions that are new.
+    void WorkingGenomeResized() {
+      ClearSearchCache();  // Scans that wrap around now cover different positions.
+      const size_t old_size = decoded_args.size();
+      decoded_args.resize(genome_working.size());
+      for (size_t pos = old_size; pos < genome_working.size(); ++pos) {
+        decoded_args[pos] = DecodeArgs(genome_working[pos]);
+      }
+    }
+
+    /// An instruction was copied within the working genome (e.g., on HCopy), along with its nops.
+    void InstCopied(size_t from_pos, size_t to_pos) {
+      InvalidateSearches(to_pos);
+      if (from_pos < decoded_args.size() && to_pos < decoded_args.size()) {
+        decoded_args[to_pos] = decoded_args[from_pos];
+      }
+    }
+
+    /// Get the decoded arguments for an instruction, which should be in the working genome.
+    const DecodedArgs & GetDecodedArgs(const inst_t & inst) {
+      const inst_t * first = genome_working.data();
+      if (std::less_equal<const inst_t *>()(first, &inst) &&
+          std::less<const inst_t *>()(&inst, first + std::min(decoded_args.size(), genome_working.size()))) {
+        return decoded_args[static_cast<size_t>(&inst - first)];
+      }
+      scratch_args = DecodeArgs(inst);  // Not in working genome; decode it now.
+      return scratch_args;
+    }
+
+    /// Find the label matching the nops after the current instruction (see FindLabel()),
+    /// reusing the result of an earlier identical search if the genome has not changed.
+    size_t FindLabelCached(bool start_local, bool reverse) {
+      return CachedSearch(start_local, reverse, GetSearchType(false, start_local, reverse),
+        [this, start_local, reverse](){ return FindLabel(start_local, reverse); });
+    }
+
+    /// Find the complement of the nop sequence after the current instruction (see
+    /// FindNopSequence()), reusing the result of an earlier identical search if possible.
+    size_t FindNopSequenceCached(bool start_local, bool reverse) {
+      return CachedSearch(start_local, reverse, GetSearchType(true, start_local, reverse),
+        [this, start_local, reverse](){ return FindNopSequence(start_local, reverse); });
+    }
+
     /// Reset organism's hardware to the top of the original genome
     void ResetHardware(){
       ResetWorkingGenome();
@@ -232,7 +446,7 @@ namespace mabe {
       SharedData().merit_trait(*this) = merit;
       SharedData().generation_trait(*this) = gen;
       SharedData().position_trait(*this) = pos;
-      SharedData().genome_trait(*this) = GetGenomeString();
+      MarkGenomeStringStale();
       SharedData().length_trait(*this) = GetGenomeSize();
       SharedData().offspring_merit_trait(*this) = SharedData().initial_merit; 
     }
@@ -257,7 +471,11 @@ namespace mabe {
           SharedData().init_length = GetGenomeSize();
         }
       }
-      // Set traits that are specific to the ancestor (others are in ResetTraits) 
+      SetupAncestor();
+    }
+
+    /// Set traits that are specific to an ancestor (others are in ResetTraits) and reset.
+    void SetupAncestor() {
       SharedData().generation_trait(*this) = 0;
       SharedData().merit_trait(*this) = GetGenomeSize() / SharedData().init_length;
       // Call generic reset methods
@@ -265,39 +483,76 @@ namespace mabe {
       ResetTraits();
     }
 
+    /// Binary genomes are the number of instructions followed by one byte per instruction (its
+    /// index in the instruction library), so they must be loaded with the same instruction set.
+    bool WriteGenome(std::ostream & os) const override {
+      if (GetInstLib().GetSize() > 256) {
+        emp::notify::Error("Binary VirtualCPUOrg genomes support at most 256 instructions.");
+        return false;
+      }
+      WriteBinary<uint64_t>(os, genome.size());
+      for (const inst_t & inst : genome) WriteBinary<uint8_t>(os, (uint8_t) inst.idx);
+      return os.good();
+    }
+
+    /// Load a genome from WriteGenome() and set this organism up as an ancestor.
+    bool ReadGenome(std::istream & is) override {
+      uint64_t num_insts = 0;
+      if (!ReadBinary(is, num_insts)) return false;
+      genome.resize(0);
+      for (size_t pos = 0; pos < num_insts; ++pos) {
+        uint8_t inst_idx = 0;
+        if (!ReadBinary(is, inst_idx)) return false;
+        if (inst_idx >= GetInstLib().GetSize()) {
+          emp::notify::Error("VirtualCPUOrg genome has invalid instruction index ",
+                             (size_t) inst_idx, ".");
+          return false;
+        }
+        PushInst(inst_idx);
+      }
+      ResetWorkingGenome();
+      SetupAncestor();
+      return true;
+    }
+
     /// Reset the organism back to starting conditions
     void Reset(){
       ResetHardware();
       ResetTraits();
     }
     
+    /// Get the current parent state that an offspring's merit would be calculated from.
+    DivideInfo GetDivideInfo() const {
+      return DivideInfo{ SharedData().offspring_merit_trait(*this), GetNumInstsCopied(),
+                         GetNumInstsExecuted() };
+    }
+
+    /// Calculate the merit of the next offspring from recorded state rather than the current
+    /// state (or from the current state again, if info is std::nullopt).
+    void SetDivideInfo(std::optional<DivideInfo> info) { divide_info = info; }
+
     /// Create an offspring organism using the configuration file's mutation rate.
     emp::Ptr<Organism> MakeOffspringOrganism(emp::Random & random) const override {
-      // Create and mutate
-      auto offspring_ptr = OrgType::Clone().DynamicCast<VirtualCPUOrg>();
+      // Create (with the genome from the offspring genome trait) and mutate
+      auto offspring_ptr = emp::NewPtr<VirtualCPUOrg>(*this, OffspringTag{});
       VirtualCPUOrg & offspring = *offspring_ptr;
-      const genome_t offspring_genome = SharedData().offspring_genome_trait(*this);
-      offspring.genome.resize(offspring_genome.size(), GetDefaultInst());
-      std::copy( offspring_genome.begin(),
-                 offspring_genome.end(),
-                 offspring.genome.begin() );
       offspring.ResetWorkingGenome();
       offspring.Mutate(random);
       offspring.Reset();
+      const DivideInfo info = divide_info.value_or(GetDivideInfo());
       double bonus = 0;
       if (SharedData().copy_influences_merit){
           bonus = std::min(
-            {offspring.GetGenomeSize(), GetNumInstsCopied(), GetNumInstsExecuted()}
+            {offspring.GetGenomeSize(), info.num_insts_copied, info.num_insts_executed}
           );
       } 
-      else bonus = std::min(offspring.GetGenomeSize(), GetNumInstsExecuted());
+      else bonus = std::min(offspring.GetGenomeSize(), info.num_insts_executed);
       bonus /= SharedData().init_length;
       // Initialize all necessary traits and ready hardware
-      SharedData().merit_trait(offspring) = bonus + SharedData().offspring_merit_trait(*this);
+      SharedData().merit_trait(offspring) = bonus + info.offspring_merit;
       SharedData().offspring_merit_trait(offspring) = SharedData().initial_merit;
       SharedData().generation_trait(offspring) = SharedData().generation_trait(*this) + 1;
-      offspring.CurateNops();
-      SharedData().genome_trait(offspring) = offspring.GetGenomeString();
+      offspring.MarkGenomeStringStale();
       SharedData().length_trait(offspring) = offspring.GetGenomeSize();
       SharedData().output_trait(offspring).clear();
       offspring.ResetHardware();
@@ -315,7 +570,7 @@ namespace mabe {
       offspring.ResetHardware();
       SharedData().merit_trait(offspring) = SharedData().merit_trait(*this); 
       SharedData().offspring_merit_trait(offspring) = SharedData().initial_merit; 
-      SharedData().genome_trait(offspring) = offspring.GetGenomeString();
+      offspring.MarkGenomeStringStale();
       SharedData().length_trait(offspring) = offspring.GetGenomeSize();
       SharedData().output_trait(offspring).clear();
       offspring.expanded_nop_args = SharedData().expanded_nop_args;
@@ -336,10 +591,23 @@ namespace mabe {
       //Process(SharedData().eval_time, SharedData().verbose);
     }
 
-    /// Return a reference to the instruction library of the organism
-    static inst_lib_t& GetInstLib(){
-      static inst_lib_t inst_lib;
-      return inst_lib;
+    /// Return a reference to the instruction library of the organism (owned by its manager)
+    inst_lib_t& GetInstLib(){ return SharedData().inst_lib; }
+    const inst_lib_t& GetInstLib() const { return SharedData().inst_lib; }
+
+    /// Register INST_FUN (a member function of the module at mod_ptr) as an instruction.
+    /// @return The action that the instruction was added to.
+    template <auto INST_FUN, typename MOD_T>
+    static Action & AddInstFunc(ActionMap & action_map, const emp::String & name, MOD_T * mod_ptr) {
+      const inst_func_t func =
+        [mod_ptr](this_t & hw, const inst_t & inst){ (mod_ptr->*INST_FUN)(hw, inst); };
+      Action & action = action_map.AddFunc<void, this_t&, const inst_t&>(name, func);
+      if (!action.data.HasName("fast_insts")) {
+        action.data.AddVar<fast_inst_vec_t>("fast_insts", fast_inst_vec_t{});
+      }
+      action.data.Get<fast_inst_vec_t>("fast_insts").push_back(
+        FastInst{ &CallModuleInst<MOD_T, INST_FUN>, mod_ptr });
+      return action;
     }
 
     /// Set up configuration options for this organism type
@@ -361,6 +629,20 @@ namespace mabe {
                       "Initial value for merit (task performance)");
       GetManager().LinkVar(SharedData().verbose, "verbose",
                       "If true, print execution info of organisms");
+      GetManager().LinkFuns<emp::String>(
+          [this](){
+            const int pop_id = SharedData().inst_pop_id;
+            MABE & control = GetManager().GetControl();
+            if (pop_id < 0 || (size_t) pop_id >= control.GetNumPopulations()) return emp::String();
+            return emp::String(control.GetPopulation(pop_id).GetName());
+          },
+          [this](const emp::String & name){
+            SharedData().inst_pop_id = GetManager().GetControl().GetPopID(name);
+            if (SharedData().inst_pop_id == -1) {
+              emp::notify::Error("Trying to access population '", name, "'; does not exist.");
+            }
+          },
+          "inst_pop", "Population whose instruction modules provide the instruction set.");
       GetManager().LinkVar(SharedData().inst_set_input_filename, "inst_set_input_filename",
                       "File that contains the instruction set to use."
                       " One instruction name per line. Order is maintained.");
@@ -380,6 +662,11 @@ namespace mabe {
                       "max_speculative_insts",
                       "Maximum number of instructions to speculatively execute. "
                       "-1 for genome length.");
+      GetManager().LinkVar(SharedData().fast_inst_dispatch,
+                      "fast_inst_dispatch",
+                      "If true, instructions from built-in instruction modules are called "
+                      "directly from a table indexed by instruction, rather than through the "
+                      "instruction library and their (type-erased) actions.");
       GetManager().LinkVar(SharedData().copy_influences_merit, 
                       "copy_influences_merit",
                       "If 1, the number of instructions copied (e.g., via HCopy instruction)"
@@ -439,7 +726,8 @@ namespace mabe {
       inst_lib_t& inst_lib = GetInstLib();
       if(SharedData().use_speculative_execution) non_speculative_inst_vec.Clear();
       // All instructions are stored in the populations ActionMap
-      ActionMap& action_map = GetManager().GetControl().GetActionMap(0);
+      ActionMap& action_map =
+        GetManager().GetControl().GetActionMap(SharedData().inst_pop_id);
       std::unordered_map<emp::String, mabe::Action>& typed_action_map =
         action_map.GetFuncs<void, VirtualCPUOrg&, const inst_t&>();
       // Print the number of instructions found and each of their names
@@ -450,6 +738,8 @@ namespace mabe {
       std::cout << std::endl;
 
       const emp::vector<emp::String> name_vec = LoadInstSetFromFile();
+      fast_inst_vec_t & fast_inst_table = SharedData().fast_inst_table;
+      fast_inst_table.assign(name_vec.size(), FastInst{});
       for(size_t inst_idx = 0; inst_idx < name_vec.size(); ++inst_idx){
         const emp::String& name = name_vec[inst_idx];
         if(typed_action_map.find(name) == typed_action_map.end()){
@@ -489,11 +779,7 @@ namespace mabe {
           (action.data.HasName("num_args") ?  action.data.Get<size_t>("num_args") : 0);
         inst_lib.AddInst(
             action.name,                       // Instruction name
-            [&action](VirtualCPUOrg& org, const inst_t& inst){
-              for(size_t func_idx = 0; func_idx < action.function_vec.size(); ++func_idx){
-                action.function_vec[func_idx].Call<void, VirtualCPUOrg&, const inst_t&>(org, inst);
-              }
-            },                                 // Function that will be executed
+            BuildInstFunc(action, fast_inst_table[inst_idx]), // Function that will be executed
             num_args,                          // Number of arguments
             desc,                              // Description 
             emp::ScopeType::NONE,              // No scope type, but must provide
@@ -501,6 +787,54 @@ namespace mabe {
             std::unordered_set<emp::String>(), // Instruction properties
             inst_idx);                          // Instruction ID
       }
+      if (SharedData().verbose) {
+        const size_t num_fast = (size_t) std::count_if(fast_inst_table.begin(),
+          fast_inst_table.end(), [](const FastInst & entry){ return entry.fun != nullptr; });
+        std::cout << "Using fast dispatch for " << num_fast << " of " << name_vec.size()
+                  << " instructions." << std::endl;
+      }
+    }
+
+    /// Build the function that the instruction library should call for an action.  If every
+    /// function in the action was added with AddInstFunc(), call them directly; otherwise go
+    /// through the general (type-erased) action functions.  Single-function instructions are
+    /// also placed in table_entry, so ProcessStep() can skip the instruction library entirely.
+    inst_func_t BuildInstFunc(Action & action, FastInst & table_entry) {
+      if (SharedData().fast_inst_dispatch && action.data.HasName("fast_insts")) {
+        const fast_inst_vec_t & fast_insts = action.data.Get<fast_inst_vec_t>("fast_insts");
+        if (fast_insts.size() == action.function_vec.size()) {
+          if (fast_insts.size() == 1) {
+            table_entry = fast_insts[0];
+            return fast_insts[0];
+          }
+          return [fast_insts](VirtualCPUOrg& org, const inst_t& inst){
+            for (const FastInst & fast_inst : fast_insts) fast_inst(org, inst);
+          };
+        }
+      }
+      return [&action](VirtualCPUOrg& org, const inst_t& inst){
+        for(size_t func_idx = 0; func_idx < action.function_vec.size(); ++func_idx){
+          action.function_vec[func_idx].Call<void, VirtualCPUOrg&, const inst_t&>(org, inst);
+        }
+      };
+    }
+
+    /// Execute the instruction at the instruction pointer.  Instructions in the fast dispatch
+    /// table are called directly; all others go through the instruction library, as does the
+    /// first instruction after a reset (so the base hardware can finish any lazy setup) and
+    /// everything when verbose output is on.
+    void ProcessNextInst() {
+      const fast_inst_vec_t & fast_inst_table = SharedData().fast_inst_table;
+      if (num_insts_executed > 0 && !SharedData().verbose) {
+        const inst_t & inst = genome_working[inst_ptr];
+        if (inst.idx < fast_inst_table.size() && fast_inst_table[inst.idx].fun) {
+          fast_inst_table[inst.idx](*this, inst);
+          AdvanceIP();
+          ++num_insts_executed;
+          return;
+        }
+      }
+      Process(1, SharedData().verbose);
     }
 
     /// Speculatively execute instructions up until an instruction modifies the outside world
@@ -519,7 +853,7 @@ namespace mabe {
               std::cout << "[" << SharedData().position_trait(*this).Pos() 
                 << "]" << std::endl;
             }
-            Process(1, SharedData().verbose);
+            ProcessNextInst();
             ++insts_speculatively_executed; 
           }
           else{
@@ -528,7 +862,7 @@ namespace mabe {
                 std::cout << "[" << SharedData().position_trait(*this).Pos() 
                   << "]" << std::endl;
               }
-              Process(1, SharedData().verbose);
+              ProcessNextInst();
             }
             else break;
             
@@ -548,7 +882,7 @@ namespace mabe {
           std::cout << "[" << SharedData().position_trait(*this).Pos()
             << "]" << std::endl;;
         }
-        Process(1, SharedData().verbose);
+        ProcessNextInst();
       }
       return true;
     }
@@ -561,7 +895,6 @@ namespace mabe {
         SharedData().insertion_mut_dist.Setup(SharedData().insertion_mut_prob, 
             GetGenomeSize());
         SharedData().deletion_mut_dist.Setup(SharedData().deletion_mut_prob, GetGenomeSize());
-        SharedData().mut_sites.Resize(GetGenomeSize());
       }
       else { // Otherwise, use the genome size set in the configuration file
         SharedData().point_mut_dist.Setup(SharedData().point_mut_prob, 
@@ -570,7 +903,6 @@ namespace mabe {
             SharedData().init_length);
         SharedData().deletion_mut_dist.Setup(SharedData().deletion_mut_prob, 
             SharedData().init_length);
-        SharedData().mut_sites.Resize(SharedData().init_length);
       }
     }
 
@@ -34,52 +34,29 @@ namespace mabe {
     ~VirtualCPU_Inst_Flow() { }
 
     
+    // Registers to compare (and nops to skip) were resolved when the genome was decoded.
     void Inst_IfNotEqual(org_t& hw, const org_t::inst_t& inst){
-      if(hw.expanded_nop_args){
-        size_t idx_op_1 = inst.nop_vec.size() < 1 ? 1 : inst.nop_vec[0];
-        size_t idx_op_2 = 
-            inst.nop_vec.size() < 2 ? hw.GetComplementNop(idx_op_1) : inst.nop_vec[1];
-        if(hw.regs[idx_op_1] == hw.regs[idx_op_2])
-          hw.AdvanceIP(1);
-        hw.AdvanceIP(inst.nop_vec.size()); 
-       }
-      else{
-        size_t idx_1 = inst.nop_vec.empty() ? 1 : inst.nop_vec[0];
-        size_t idx_2 = hw.GetComplementNop(idx_1);
-        if(hw.regs[idx_1] == hw.regs[idx_2])
-          hw.AdvanceIP(1);
-        if(inst.nop_vec.size()) hw.AdvanceIP(1); 
-      }
+      const auto & args = hw.GetDecodedArgs(inst);
+      if(hw.regs[args.result] == hw.regs[args.compare])
+        hw.AdvanceIP(1);
+      if(args.nops_to_skip) hw.AdvanceIP(args.nops_to_skip);
     }
     void Inst_IfLess(org_t& hw, const org_t::inst_t& inst){
-      if(hw.expanded_nop_args){
-        size_t idx_op_1 = inst.nop_vec.size() < 1 ? 1 : inst.nop_vec[0];
-        size_t idx_op_2 = 
-            inst.nop_vec.size() < 2 ? hw.GetComplementNop(idx_op_1) : inst.nop_vec[1];
-        if(hw.regs[idx_op_1] >= hw.regs[idx_op_2])
-          hw.AdvanceIP(1);
-        hw.AdvanceIP(inst.nop_vec.size()); 
-      }
-      else{
-        size_t idx_1 = inst.nop_vec.empty() ? 1 : inst.nop_vec[0];
-        size_t idx_2 = hw.GetComplementNop(idx_1);
-        if(hw.regs[idx_1] >= hw.regs[idx_2])
-          hw.AdvanceIP(1);
-        if(inst.nop_vec.size()) hw.AdvanceIP(1); 
-      }
+      const auto & args = hw.GetDecodedArgs(inst);
+      if(hw.regs[args.result] >= hw.regs[args.compare])
+        hw.AdvanceIP(1);
+      if(args.nops_to_skip) hw.AdvanceIP(args.nops_to_skip);
     }
     void Inst_IfLabel(org_t& hw, const org_t::inst_t& inst){
       hw.AdvanceIP(inst.nop_vec.size());
       if(!hw.CheckIfLastCopied(hw.GetComplementNopSequence(inst.nop_vec))) hw.AdvanceIP();
     }
     void Inst_MoveHeadIfNotEqual(org_t& hw, const org_t::inst_t& inst){
+      const auto & args = hw.GetDecodedArgs(inst);
       if(hw.expanded_nop_args){
-        size_t idx_op_1 = inst.nop_vec.size() < 1 ? 1 : inst.nop_vec[0];
-        size_t idx_op_2 = 
-            inst.nop_vec.size() < 2 ? hw.GetComplementNop(idx_op_1) : inst.nop_vec[1];
         size_t idx_mov_head = inst.nop_vec.size() < 3 ? 0 : inst.nop_vec[2];
         size_t idx_target_head = inst.nop_vec.size() < 4 ? 3 : inst.nop_vec[2];
-        if(hw.regs[idx_op_1] != hw.regs[idx_op_2]){
+        if(hw.regs[args.result] != hw.regs[args.compare]){
           size_t target_head_val = hw.inst_ptr;
           const size_t target_mod = idx_target_head % 4;
           if(     target_mod == 1) target_head_val = hw.read_head; 
@@ -94,9 +71,7 @@ namespace mabe {
         }
       }
       else{
-        size_t idx = inst.nop_vec.empty() ? 1 : inst.nop_vec[0];
-        size_t idx_2 = hw.GetComplementNop(idx);
-        if(hw.regs[idx] != hw.regs[idx_2]) hw.inst_ptr = hw.flow_head; 
+        if(hw.regs[args.result] != hw.regs[args.compare]) hw.inst_ptr = hw.flow_head; 
       }
     }
 
@@ -114,28 +89,16 @@ namespace mabe {
     void SetupFuncs(){
       ActionMap& action_map = control.GetActionMap(pop_id);
       { // If not equal
-        const inst_func_t func_if_not_equ = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_IfNotEqual(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "IfNEqu",func_if_not_equ);
+        org_t::AddInstFunc<&this_t::Inst_IfNotEqual>(action_map, "IfNEqu", this);
       }
       { // If less 
-        const inst_func_t func_if_less = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_IfLess(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "IfLess", func_if_less);
+        org_t::AddInstFunc<&this_t::Inst_IfLess>(action_map, "IfLess", this);
       }
       { // If label 
-        const inst_func_t func_if_label = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_IfLabel(hw, inst); };
-        action_map.AddFunc<void, org_t&,const org_t::inst_t&>(
-            "IfLabel",func_if_label);
+        org_t::AddInstFunc<&this_t::Inst_IfLabel>(action_map, "IfLabel", this);
       }
       { // Move head if not equal
-        const inst_func_t func_mov_head_if_not_equ = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_MoveHeadIfNotEqual(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "MoveHeadIfNEqu",func_mov_head_if_not_equ);
+        org_t::AddInstFunc<&this_t::Inst_MoveHeadIfNotEqual>(action_map, "MoveHeadIfNEqu", this);
       }
     }
 
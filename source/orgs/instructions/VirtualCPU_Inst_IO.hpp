@@ -1,7 +1,7 @@
 /**
  *  @note This file is part of MABE, https://github.com/mercere99/MABE2
  *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
- *  @date 2021-2022.
+ *  @date 2021-2024.
  *
  *  @file  VirtualCPU_Inst_IO.hpp
  *  @brief Provides VirtualCPUOrgs an IO instruction that loads a new input and caches the output
@@ -13,6 +13,7 @@
 
 #include <limits>
 
+#include "../../core/DeferredActions.hpp"
 #include "../../core/MABE.hpp"
 #include "../../core/Module.hpp"
 #include "../VirtualCPUOrg.hpp"
@@ -49,9 +50,10 @@ namespace mabe {
         size_t& input_idx = hw.GetTrait<size_t>(input_idx_name);
         // Ensure inputs have been generated
         if(input_vec.size() < num_inputs){
+          emp::Random & random = DeferredActions::GetRandom(control.GetRandom());
           for(size_t idx = input_vec.size(); idx < num_inputs; idx++){
             data_t rand_num = 
-                (data_t)(std::numeric_limits<data_t>::max() * control.GetRandom().GetDouble()) ;
+                (data_t)(std::numeric_limits<data_t>::max() * random.GetDouble()) ;
             input_vec.push_back((rand_num << 8) | stamp_vec[idx]);
           }
         }
@@ -92,10 +94,7 @@ namespace mabe {
     /// Define IO instruction and make it available to the specified population
     void SetupFuncs(){
       ActionMap& action_map = control.GetActionMap(pop_id);
-      const inst_func_t func_input = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_IO(hw, inst); };
-      action_map.AddFunc<void, VirtualCPUOrg&, const VirtualCPUOrg::inst_t&>(
-          "IO", func_input);
+      org_t::AddInstFunc<&this_t::Inst_IO>(action_map, "IO", this);
     }
 
   };
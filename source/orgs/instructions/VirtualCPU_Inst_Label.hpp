@@ -34,24 +34,25 @@ namespace mabe {
     ~VirtualCPU_Inst_Label() { }
 
 
+    // Search results are cached by the organism until its working genome changes.
     void Inst_Label(org_t& /*hw*/, const org_t::inst_t& /*inst*/){ ; }
     void Inst_SearchLabelDirectS(org_t& hw, const org_t::inst_t& /*inst*/){
-      hw.flow_head = hw.FindLabel(false, false); 
+      hw.flow_head = hw.FindLabelCached(false, false); 
     }
     void Inst_SearchLabelDirectF(org_t& hw, const org_t::inst_t& /*inst*/){
-      hw.flow_head = hw.FindLabel(true, false); 
+      hw.flow_head = hw.FindLabelCached(true, false); 
     }
     void Inst_SearchLabelDirectB(org_t& hw, const org_t::inst_t& /*inst*/){
-      hw.flow_head = hw.FindLabel(true, true); 
+      hw.flow_head = hw.FindLabelCached(true, true); 
     }
     void Inst_SearchSeqDirectS(org_t& hw, const org_t::inst_t& /*inst*/){
-      hw.flow_head = hw.FindNopSequence(false, false); 
+      hw.flow_head = hw.FindNopSequenceCached(false, false); 
     }
     void Inst_SearchSeqDirectF(org_t& hw, const org_t::inst_t& /*inst*/){
-      hw.flow_head = hw.FindNopSequence(true, false); 
+      hw.flow_head = hw.FindNopSequenceCached(true, false); 
     }
     void Inst_SearchSeqDirectB(org_t& hw, const org_t::inst_t& /*inst*/){
-      hw.flow_head = hw.FindNopSequence(true, true); 
+      hw.flow_head = hw.FindNopSequenceCached(true, true); 
     }
 
     /// Set up variables for configuration file
@@ -68,46 +69,25 @@ namespace mabe {
     void SetupFuncs(){
       ActionMap& action_map = control.GetActionMap(pop_id);
       { // Label 
-        const inst_func_t func_label = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_Label(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "Label", func_label);
+        org_t::AddInstFunc<&this_t::Inst_Label>(action_map, "Label", this);
       }
       { // SearchLabelDirectS 
-        const inst_func_t func_search_label_direct_s = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_SearchLabelDirectS(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "SearchLabelDirectS", func_search_label_direct_s);
+        org_t::AddInstFunc<&this_t::Inst_SearchLabelDirectS>(action_map, "SearchLabelDirectS", this);
       }
       { // SearchLabelDirectF 
-        const inst_func_t func_search_label_direct_f = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_SearchLabelDirectF(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "SearchLabelDirectF", func_search_label_direct_f);
+        org_t::AddInstFunc<&this_t::Inst_SearchLabelDirectF>(action_map, "SearchLabelDirectF", this);
       }
       { // SearchLabelDirectB 
-        const inst_func_t func_search_label_direct_b = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_SearchLabelDirectB(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "SearchLabelDirectB", func_search_label_direct_b);
+        org_t::AddInstFunc<&this_t::Inst_SearchLabelDirectB>(action_map, "SearchLabelDirectB", this);
       }
       { // SearchSeqDirectS 
-        const inst_func_t func_search_seq_direct_s = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_SearchSeqDirectS(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "SearchSeqDirectS", func_search_seq_direct_s);
+        org_t::AddInstFunc<&this_t::Inst_SearchSeqDirectS>(action_map, "SearchSeqDirectS", this);
       }
       { // SearchSeqDirectF 
-        const inst_func_t func_search_seq_direct_f = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_SearchSeqDirectF(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "SearchSeqDirectF", func_search_seq_direct_f);
+        org_t::AddInstFunc<&this_t::Inst_SearchSeqDirectF>(action_map, "SearchSeqDirectF", this);
       }
       { // SearchSeqDirectB 
-        const inst_func_t func_search_seq_direct_b = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_SearchSeqDirectB(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "SearchSeqDirectB", func_search_seq_direct_b);
+        org_t::AddInstFunc<&this_t::Inst_SearchSeqDirectB>(action_map, "SearchSeqDirectB", this);
       }
     }
 
@@ -123,52 +123,28 @@ namespace mabe {
     void SetupFuncs(){
       ActionMap& action_map = control.GetActionMap(pop_id);
       { // Pop 
-        const inst_func_t func_pop = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_Pop(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "Pop", func_pop);
+        org_t::AddInstFunc<&this_t::Inst_Pop>(action_map, "Pop", this);
       }
       { // Push 
-        const inst_func_t func_push = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_Push(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "Push", func_push);
+        org_t::AddInstFunc<&this_t::Inst_Push>(action_map, "Push", this);
       }
       { // Swap stack 
-        const inst_func_t func_swap_stack = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_SwapStack(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "SwapStk", func_swap_stack);
+        org_t::AddInstFunc<&this_t::Inst_SwapStack>(action_map, "SwapStk", this);
       }
       { // Swap 
-        const inst_func_t func_swap = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_Swap(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "Swap", func_swap);
+        org_t::AddInstFunc<&this_t::Inst_Swap>(action_map, "Swap", this);
       }
       { // Move head 
-        const inst_func_t func_mov_head = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_MoveHead(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "MovHead", func_mov_head);
+        org_t::AddInstFunc<&this_t::Inst_MoveHead>(action_map, "MovHead", this);
       }
       { // Jump head 
-        const inst_func_t func_jmp_head = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_JumpHead(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "JumpHead", func_jmp_head);
+        org_t::AddInstFunc<&this_t::Inst_JumpHead>(action_map, "JumpHead", this);
       }
       { // Get head  
-        const inst_func_t func_get_head = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_GetHead(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "GetHead", func_get_head);
+        org_t::AddInstFunc<&this_t::Inst_GetHead>(action_map, "GetHead", this);
       }
       { // Set flow  
-        const inst_func_t func_set_flow = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_SetFlow(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "SetFlow", func_set_flow);
+        org_t::AddInstFunc<&this_t::Inst_SetFlow>(action_map, "SetFlow", this);
       }
     }
 
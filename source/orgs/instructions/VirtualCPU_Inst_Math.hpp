@@ -34,59 +34,30 @@ namespace mabe {
     ~VirtualCPU_Inst_Math() { }
 
     void Inst_Inc(org_t& hw, const org_t::inst_t& inst){
-      size_t idx = inst.nop_vec.empty() ? 1 : inst.nop_vec[0];
-      ++hw.regs[idx];
+      ++hw.regs[hw.GetDecodedArgs(inst).result];
     }
     void Inst_Dec(org_t& hw, const org_t::inst_t& inst){
-      size_t idx = inst.nop_vec.empty() ? 1 : inst.nop_vec[0];
-      --hw.regs[idx];
+      --hw.regs[hw.GetDecodedArgs(inst).result];
     }
+    // Operands were resolved when the genome was decoded: with expanded nop args each may be
+    // set by a nop, otherwise the computation is always B op C.
     void Inst_Add(org_t& hw, const org_t::inst_t& inst){
-      if(hw.expanded_nop_args){
-        size_t idx_res = inst.nop_vec.empty() ? 1 : inst.nop_vec[0];
-        size_t idx_op_1 = inst.nop_vec.size() < 2 ? idx_res : inst.nop_vec[1];
-        size_t idx_op_2 = 
-            inst.nop_vec.size() < 3 ? hw.GetComplementNop(idx_op_1) : inst.nop_vec[2];
-        hw.regs[idx_res] = hw.regs[idx_op_1] + hw.regs[idx_op_2];
-      }
-      else{ // Nop determines destination, computation is always B + C
-        size_t idx = inst.nop_vec.empty() ? 1 : inst.nop_vec[0];
-        hw.regs[idx] = hw.regs[1] + hw.regs[2];
-      }
+      const auto & args = hw.GetDecodedArgs(inst);
+      hw.regs[args.result] = hw.regs[args.operand1] + hw.regs[args.operand2];
     }
     void Inst_Sub(org_t& hw, const org_t::inst_t& inst){
-      if(hw.expanded_nop_args){
-        size_t idx_res = inst.nop_vec.empty() ? 1 : inst.nop_vec[0];
-        size_t idx_op_1 = inst.nop_vec.size() < 2 ? idx_res : inst.nop_vec[1];
-        size_t idx_op_2 = 
-            inst.nop_vec.size() < 3 ? hw.GetComplementNop(idx_op_1) : inst.nop_vec[2];
-        hw.regs[idx_res] = hw.regs[idx_op_1] - hw.regs[idx_op_2];
-      }
-      else{ // Nop determines destination. Computation is always B - C
-        size_t idx = inst.nop_vec.empty() ? 1 : inst.nop_vec[0];
-        hw.regs[idx] = hw.regs[1] - hw.regs[2];
-      }
+      const auto & args = hw.GetDecodedArgs(inst);
+      hw.regs[args.result] = hw.regs[args.operand1] - hw.regs[args.operand2];
     }
     void Inst_Nand(org_t& hw, const org_t::inst_t& inst){
-      if(hw.expanded_nop_args){
-        size_t idx_res = inst.nop_vec.empty() ? 1 : inst.nop_vec[0];
-        size_t idx_op_1 = inst.nop_vec.size() < 2 ? idx_res : inst.nop_vec[1];
-        size_t idx_op_2 = 
-            inst.nop_vec.size() < 3 ? hw.GetComplementNop(idx_op_1) : inst.nop_vec[2];
-        hw.regs[idx_res] = ~(hw.regs[idx_op_1] & hw.regs[idx_op_2]);
-      }
-      else{ // Nop determines destination. Computation is always B NAND C
-        size_t idx = inst.nop_vec.empty() ? 1 : inst.nop_vec[0];
-        hw.regs[idx] = ~(hw.regs[1] & hw.regs[2]);
-      }
+      const auto & args = hw.GetDecodedArgs(inst);
+      hw.regs[args.result] = ~(hw.regs[args.operand1] & hw.regs[args.operand2]);
     }
     void Inst_ShiftL(org_t& hw, const org_t::inst_t& inst){
-      size_t idx = inst.nop_vec.empty() ? 1 : inst.nop_vec[0];
-      hw.regs[idx] <<= 1;
+      hw.regs[hw.GetDecodedArgs(inst).result] <<= 1;
     }
     void Inst_ShiftR(org_t& hw, const org_t::inst_t& inst){
-      size_t idx = inst.nop_vec.empty() ? 1 : inst.nop_vec[0];
-      hw.regs[idx] >>= 1;
+      hw.regs[hw.GetDecodedArgs(inst).result] >>= 1;
     }
 
     /// Set up variables for configuration file
@@ -103,46 +74,25 @@ namespace mabe {
     void SetupFuncs(){
       ActionMap& action_map = control.GetActionMap(pop_id);
       { // Increment
-        const inst_func_t func_inc = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_Inc(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "Inc", func_inc);
+        org_t::AddInstFunc<&this_t::Inst_Inc>(action_map, "Inc", this);
       }
       { // Decrement 
-        const inst_func_t func_dec = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_Dec(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "Dec", func_dec);
+        org_t::AddInstFunc<&this_t::Inst_Dec>(action_map, "Dec", this);
       }
       { // Add 
-        const inst_func_t func_add = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_Add(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "Add", func_add);
+        org_t::AddInstFunc<&this_t::Inst_Add>(action_map, "Add", this);
       }
       { // Sub 
-        const inst_func_t func_sub = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_Sub(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "Sub", func_sub);
+        org_t::AddInstFunc<&this_t::Inst_Sub>(action_map, "Sub", this);
       }
       { // NAND 
-        const inst_func_t func_nand = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_Nand(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "Nand", func_nand);
+        org_t::AddInstFunc<&this_t::Inst_Nand>(action_map, "Nand", this);
       }
       { // Shift Left 
-        const inst_func_t func_shift_l = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_ShiftL(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "ShiftL", func_shift_l);
+        org_t::AddInstFunc<&this_t::Inst_ShiftL>(action_map, "ShiftL", this);
       }
       { // Shift Right 
-        const inst_func_t func_shift_r = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_ShiftR(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "ShiftR", func_shift_r);
+        org_t::AddInstFunc<&this_t::Inst_ShiftR>(action_map, "ShiftR", this);
       }
     }
 
@@ -53,17 +53,13 @@ namespace mabe {
     void SetupFuncs(){
       emp_assert(num_nops <= 23,"Code only supports 23 normal NOP instructions currently");
       ActionMap& action_map = control.GetActionMap(pop_id);
-      const inst_func_t func_nop = 
-        [this](org_t& hw, const org_t::inst_t& inst){ Inst_Nop(hw, inst); };
       // Add the appropriate amount of nops
       for(size_t i = 0; i < num_nops; i++){
         std::string s = "Nop";
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            s + (char)('A' + i), func_nop);
+        org_t::AddInstFunc<&this_t::Inst_Nop>(action_map, s + (char)('A' + i), this);
       }
       { // Special case: Nop X
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "NopX", func_nop);
+        org_t::AddInstFunc<&this_t::Inst_Nop>(action_map, "NopX", this);
       }
     }
 
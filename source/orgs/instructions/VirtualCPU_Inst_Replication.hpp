@@ -1,11 +1,15 @@
 /**
  *  @note This file is part of MABE, https://github.com/mercere99/MABE2
  *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
- *  @date 2021-2022.
+ *  @date 2021-2024.
  *
  *  @file  VirtualCPU_Inst_Replication.hpp
  *  @brief Provides replication instructions to a population of VirtualCPUOrgs.
  *
+ *  If organisms are being run in parallel (see DeferredActions.hpp), births are queued along
+ *  with the offspring genome and happen once the time slice is over; the parent is still reset
+ *  immediately, so it carries on as if the birth had happened.
+ *
  *  TODO: 
  *      - HCopy (and other instructions) should be able to add mutations to this genome
  * 
@@ -14,6 +18,7 @@
 #ifndef MABE_VIRTUAL_CPU_INST_REPLICATION_H
 #define MABE_VIRTUAL_CPU_INST_REPLICATION_H
 
+#include "../../core/DeferredActions.hpp"
 #include "../../core/MABE.hpp"
 #include "../../core/Module.hpp"
 #include "../VirtualCPUOrg.hpp"
@@ -48,10 +53,33 @@ namespace mabe {
       : Module(control, name, desc) {;}
     ~VirtualCPU_Inst_Replication() { }
 
+    /// Place the offspring whose genome is in the parent's offspring genome trait, or queue the
+    /// birth if organisms are running in parallel.
+    void Replicate(org_t& hw, OrgPosition org_pos){
+      emp::Ptr<DeferredActions> deferred = DeferredActions::GetActive();
+      if (!deferred) {
+        control.Replicate(org_pos, *org_pos.PopPtr());
+        return;
+      }
+      // Hold onto the genome ourselves, since the parent may divide again before the birth.
+      // The parent also resets right away, so record the state that offspring merit uses.
+      org_t::genome_t& offspring_genome = hw.GetTrait<org_t::genome_t>(offspring_genome_trait);
+      deferred->Add(
+        [this, org_pos, genome = std::move(offspring_genome), info = hw.GetDivideInfo()]
+        (Organism & parent) mutable {
+          org_t & parent_hw = static_cast<org_t &>(parent);
+          parent_hw.GetTrait<org_t::genome_t>(offspring_genome_trait) = std::move(genome);
+          parent_hw.SetDivideInfo(info);
+          control.Replicate(org_pos, *org_pos.PopPtr());
+          parent_hw.SetDivideInfo(std::nullopt);
+        });
+    }
+
     void Inst_HAlloc(org_t& hw, const org_t::inst_t& /*inst*/){
       // Only expand once
       if(hw.genome_working.size() == hw.genome.size()){
         hw.genome_working.resize(hw.genome.size() * 2, hw.GetDefaultInst());
+        hw.WorkingGenomeResized();
         hw.regs[0] = hw.genome.size();
       }
     }
@@ -78,13 +106,14 @@ namespace mabe {
             offspring_genome_trait);
         offspring_genome.resize(hw.genome_working.size() - hw.read_head,
             hw.GetDefaultInst());
-        std::copy(
+        // The copied region is discarded from the working genome, so move it out.
+        std::move(
             hw.genome_working.begin() + hw.read_head,
             hw.genome_working.end(),
             offspring_genome.begin());
         hw.genome_working.resize(hw.read_head, hw.GetDefaultInst());
         // Replicate
-        control.Replicate(org_pos, *org_pos.PopPtr());
+        Replicate(hw, org_pos);
         // Reset the parent
         hw.Reset();
         // Set to end so completion of this inst moves it 0 
@@ -93,6 +122,7 @@ namespace mabe {
     }
     void Inst_HCopy(org_t& hw, const org_t::inst_t& /*inst*/){
       hw.genome_working[hw.write_head] = hw.genome_working[hw.read_head];
+      hw.InstCopied(hw.read_head, hw.write_head);
       hw.copied_inst_id_vec.push_back(hw.genome_working[hw.write_head].id);
       hw.genome_working[hw.read_head].has_been_copied = true;
       hw.AdvanceRH();
@@ -130,7 +160,7 @@ namespace mabe {
             hw.genome.end(),
             offspring_genome.begin());
         // Replicate 
-        control.Replicate(org_pos, *org_pos.PopPtr());
+        Replicate(hw, org_pos);
         // Reset the parent
         hw.Reset();
         // Set to end so completion of this inst moves it 0 
@@ -171,35 +201,20 @@ namespace mabe {
     void SetupFuncs(){
       ActionMap& action_map = control.GetActionMap(pop_id);
       { // Head allocate 
-        const inst_func_t func_h_alloc = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_HAlloc(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-              "HAlloc", func_h_alloc);
+        org_t::AddInstFunc<&this_t::Inst_HAlloc>(action_map, "HAlloc", this);
       }
       { // Head divide 
-        const inst_func_t func_h_divide = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_HDivide(hw, inst); };
-        Action& action = action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "HDivide", func_h_divide);
+        Action& action = org_t::AddInstFunc<&this_t::Inst_HDivide>(action_map, "HDivide", this);
         action.data.AddVar<bool>("is_non_speculative", true);
       }
       { // Head copy 
-        const inst_func_t func_h_copy = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_HCopy(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "HCopy", func_h_copy);
+        org_t::AddInstFunc<&this_t::Inst_HCopy>(action_map, "HCopy", this);
       }
       { // Head search 
-        const inst_func_t func_h_search = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_HSearch(hw, inst); };
-        action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "HSearch", func_h_search);
+        org_t::AddInstFunc<&this_t::Inst_HSearch>(action_map, "HSearch", this);
       }
       { // Repro 
-        const inst_func_t func_repro = 
-          [this](org_t& hw, const org_t::inst_t& inst){ Inst_Repro(hw, inst); };
-        Action& action = action_map.AddFunc<void, org_t&, const org_t::inst_t&>(
-            "Repro", func_repro);
+        Action& action = org_t::AddInstFunc<&this_t::Inst_Repro>(action_map, "Repro", this);
         action.data.AddVar<bool>("is_non_speculative", true);
       }
     }
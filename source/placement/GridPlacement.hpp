@@ -0,0 +1,210 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  GridPlacement.hpp
+ *  @brief Arrange a population as a 2D or 3D grid; births go into a neighboring cell.
+ *
+ *  The population is sized to width * height * depth cells during setup, with cell (x,y,z) at
+ *  position x + width * (y + height * z).  Grids can wrap around at the edges (toroidal) or be
+ *  bounded, and neighborhoods can be Moore (all adjacent cells, including diagonals) or von
+ *  Neumann (only cells that share a face).
+ *
+ *  Every cell's neighbors are computed once, in a flat table, so that choosing a random
+ *  neighbor for a birth (or for FindNeighbor) is a single lookup.
+ *
+ *  Injected organisms fill empty cells in order; once the grid is full they replace a random
+ *  cell.
+ */
+
+#ifndef MABE_GRID_PLACEMENT_H
+#define MABE_GRID_PLACEMENT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <span>
+
+#include "../core/MABE.hpp"
+#include "../core/Module.hpp"
+
+#include "emp/base/vector.hpp"
+
+namespace mabe {
+
+  /// Arrange populations as a grid, placing births into a random neighboring cell.
+  class GridPlacement : public Module {
+  private:
+    enum Neighborhood {
+      MOORE,        ///< All adjacent cells, including diagonals.
+      VON_NEUMANN   ///< Only cells that share a face.
+    };
+
+    Collection target_collect;   ///< Collection of populations to manage
+    size_t width = 60;           ///< Number of cells across the grid.
+    size_t height = 60;          ///< Number of cells down the grid.
+    size_t depth = 1;            ///< Number of layers in the grid (1 for a 2D grid).
+    bool toroidal = true;        ///< Do the edges of the grid wrap around?
+    Neighborhood neighborhood = Neighborhood::MOORE;
+
+    size_t max_neighbors = 0;                ///< Row length in the neighbor table.
+    emp::vector<uint32_t> neighbor_table;    ///< Neighbors of each cell, one row per cell.
+    emp::vector<uint8_t> neighbor_counts;    ///< Number of neighbors each cell actually has.
+    size_t next_inject = 0;                  ///< Where to start looking for an empty cell.
+
+    size_t GetNumCells() const { return width * height * depth; }
+
+    /// Build the neighbor table for the configured grid.
+    void BuildNeighborTable() {
+      const size_t num_cells = GetNumCells();
+      const int z_range = (depth > 1) ? 1 : 0;
+      if (neighborhood == Neighborhood::MOORE) max_neighbors = z_range ? 26 : 8;
+      else max_neighbors = z_range ? 6 : 4;
+      neighbor_table.resize(num_cells * max_neighbors);
+      neighbor_counts.resize(num_cells);
+
+      // Find the neighbor of (x,y,z) in one dimension, or -1 if it is off a bounded grid.
+      auto offset = [this](size_t coord, int delta, size_t size) -> long long {
+        long long result = static_cast<long long>(coord) + delta;
+        if (result >= 0 && result < static_cast<long long>(size)) return result;
+        if (!toroidal) return -1;
+        return (result + static_cast<long long>(size)) % static_cast<long long>(size);
+      };
+
+      for (size_t cell = 0; cell < num_cells; ++cell) {
+        const size_t x = cell % width;
+        const size_t y = (cell / width) % height;
+        const size_t z = cell / (width * height);
+        uint32_t * row = neighbor_table.data() + cell * max_neighbors;
+        size_t count = 0;
+        for (int dz = -z_range; dz <= z_range; ++dz) {
+          for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+              const int dist = std::abs(dx) + std::abs(dy) + std::abs(dz);
+              if (dist == 0 || (neighborhood == Neighborhood::VON_NEUMANN && dist > 1)) continue;
+              const long long nx = offset(x, dx, width);
+              const long long ny = offset(y, dy, height);
+              const long long nz = offset(z, dz, depth);
+              if (nx < 0 || ny < 0 || nz < 0) continue;
+              const uint32_t neighbor = static_cast<uint32_t>(nx + width * (ny + height * nz));
+              // Narrow wrapped grids can reach the same cell (or this one) more than once.
+              if (neighbor == cell) continue;
+              if (std::find(row, row + count, neighbor) != row + count) continue;
+              row[count++] = neighbor;
+            }
+          }
+        }
+        neighbor_counts[cell] = static_cast<uint8_t>(count);
+      }
+    }
+
+    /// Choose a random neighbor of a cell; return the cell itself if it has no neighbors.
+    size_t RandomNeighbor(size_t cell) {
+      const size_t count = neighbor_counts[cell];
+      if (count == 0) return cell;
+      return neighbor_table[cell * max_neighbors + control.GetRandom().GetUInt(count)];
+    }
+
+  public:
+    GridPlacement(mabe::MABE & control,
+                  const std::string & name="GridPlacement",
+                  const std::string & desc="Module to arrange populations in a grid, with births placed next to parents.")
+      : Module(control, name, desc), target_collect(control.GetPopulation(0))
+    {
+      SetPlacementMod(true);
+    }
+    ~GridPlacement() { }
+
+    /// Set up variables for configuration file
+    void SetupConfig() override {
+      LinkCollection(target_collect, "target", "Population(s) to manage.");
+      LinkVar(width, "width", "Number of cells across the grid.");
+      LinkVar(height, "height", "Number of cells down the grid.");
+      LinkVar(depth, "depth", "Number of layers in the grid (1 for a 2D grid).");
+      LinkVar(toroidal, "toroidal", "Should the edges of the grid wrap around? (0 = bounded)");
+      LinkMenu(neighborhood, "neighborhood", "Which cells count as neighbors?",
+        Neighborhood::MOORE, "moore", "All adjacent cells, including diagonals.",
+        Neighborhood::VON_NEUMANN, "von_neumann", "Only cells that share a face.");
+    }
+
+    /// Build the grid and set birth, inject, and neighbor functions for the specified populations
+    void SetupModule() override {
+      if (GetNumCells() == 0) {
+        emp::notify::Error("GridPlacement '", name, "' needs a width, height, and depth of at least 1.");
+        return;
+      }
+      if (GetNumCells() > std::numeric_limits<uint32_t>::max()) {
+        emp::notify::Error("GridPlacement '", name, "' has too many cells (", GetNumCells(), ").");
+        return;
+      }
+      BuildNeighborTable();
+
+      for(size_t pop_id = 0; pop_id < control.GetNumPopulations(); ++pop_id){
+        Population& pop = control.GetPopulation(pop_id);
+        if(target_collect.HasPopulation(pop)){
+          pop.SetPlaceBirthFun(
+            [this, &pop](Organism & /*org*/, OrgPosition ppos) {
+              return PlaceBirth(ppos, pop);
+            }
+          );
+          pop.SetPlaceInjectFun(
+            [this, &pop](Organism & /*org*/){
+              return PlaceInject(pop);
+            }
+          );
+          pop.SetFindNeighborFun(
+            [this, &pop](OrgPosition pos){
+              return FindNeighbor(pos, pop);
+            }
+          );
+          control.ResizePop(pop, GetNumCells());  // One position per cell.
+        }
+      }
+    }
+
+    /// Place a birth in a random cell next to the parent.
+    OrgPosition PlaceBirth(OrgPosition ppos, Population & target_pop) {
+      if (!target_collect.HasPopulation(target_pop)) return OrgPosition();
+      emp_assert(target_pop.GetSize() == GetNumCells(), target_pop.GetSize(), GetNumCells());
+
+      // A parent from elsewhere has no location in this grid; use any cell.
+      if (!ppos.IsInPop(target_pop)) {
+        return OrgPosition(target_pop, control.GetRandom().GetUInt(target_pop.GetSize()));
+      }
+      return OrgPosition(target_pop, RandomNeighbor(ppos.Pos()));
+    }
+
+    /// Inject into the next empty cell, or a random cell if the grid is full.
+    OrgPosition PlaceInject(Population & target_pop) {
+      if (!target_collect.HasPopulation(target_pop)) return OrgPosition();
+      emp_assert(target_pop.GetSize() == GetNumCells(), target_pop.GetSize(), GetNumCells());
+
+      if (next_inject >= target_pop.GetSize()) next_inject = 0;
+      size_t pos = target_pop.FindEmptyPos(next_inject);
+      if (pos == target_pop.npos) pos = target_pop.FindEmptyPos(0);
+      if (pos == target_pop.npos) pos = control.GetRandom().GetUInt(target_pop.GetSize());
+      next_inject = pos + 1;
+      return OrgPosition(target_pop, pos);
+    }
+
+    /// Get the cells next to a given cell.
+    std::span<const uint32_t> GetNeighbors(size_t cell) const {
+      emp_assert(cell < neighbor_counts.size(), cell, neighbor_counts.size());
+      return std::span<const uint32_t>(neighbor_table.data() + cell * max_neighbors,
+                                       neighbor_counts[cell]);
+    }
+    size_t GetNumNeighbors(size_t cell) const { return GetNeighbors(cell).size(); }
+
+    /// Return a random cell next to the given position.
+    OrgPosition FindNeighbor(OrgPosition pos, Population & target_pop) {
+      if (!pos.IsInPop(target_pop) || pos.Pos() >= neighbor_counts.size()) return OrgPosition();
+      return OrgPosition(target_pop, RandomNeighbor(pos.Pos()));
+    }
+  };
+
+  MABE_REGISTER_MODULE(GridPlacement, "Arrange population as a 2D or 3D grid; births go into a neighboring cell.");
+}
+
+#endif
@@ -1,7 +1,7 @@
 /**
  *  @note This file is part of MABE, https://github.com/mercere99/MABE2
  *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
- *  @date 2021-2022.
+ *  @date 2021-2024.
  *
  *  @file  MaxSizePlacement.h
  *  @brief Population grows up to a given size, then new births randomly replace existing orgs
@@ -12,6 +12,11 @@
  * 
  *  When a neighbor position is requested, a random position from the entire population is
  *  returned.
+ *
+ *  The total size of the managed populations is tracked through resize signals, so checking
+ *  whether they are full is constant time, as is choosing a (non-parent) position to replace.
+ *  Targets are whole populations: every position in a managed population counts toward
+ *  max_pop_size, including positions that are added as it grows.
  */
 
 #ifndef MABE_MAX_SIZE_PLACEMENT_H
@@ -20,6 +25,8 @@
 #include "../core/MABE.hpp"
 #include "../core/Module.hpp"
 
+#include "emp/base/vector.hpp"
+
 namespace mabe {
 
   /// Grows population to a given size, then randomly places additional births over existing orgs
@@ -27,6 +34,25 @@ namespace mabe {
   private:
     Collection target_collect; ///< Collection of populations to manage
     size_t max_pop_size;       ///< Maximum population size, at which additional births replace existing organisms
+    emp::vector<bool> is_target;  ///< Is each population (by ID) managed by this module?
+    size_t target_size = 0;       ///< Current total size of all managed populations (in full).
+
+    bool IsTarget(const Population & pop) const {
+      const size_t pop_id = static_cast<size_t>(pop.GetID());
+      return pop_id < is_target.size() && is_target[pop_id];
+    }
+
+    /// Pick a random position in a population other than the parent's (if it is there).
+    OrgPosition RandomOtherPos(Population & target_pop, OrgPosition ppos) {
+      const size_t pop_size = target_pop.GetSize();
+      if (!ppos.IsInPop(target_pop) || pop_size < 2) {
+        return OrgPosition(target_pop, control.GetRandom().GetUInt(pop_size));
+      }
+      // Draw from one fewer position, skipping over the parent.
+      size_t pos = control.GetRandom().GetUInt(pop_size - 1);
+      if (pos >= ppos.Pos()) ++pos;
+      return OrgPosition(target_pop, pos);
+    }
 
   public:
     MaxSizePlacement(mabe::MABE & control,
@@ -46,9 +72,13 @@ namespace mabe {
 
     /// Set birth and inject functions for the specified populations
     void SetupModule() override {
+      is_target.assign(control.GetNumPopulations(), false);
+      target_size = 0;
       for(size_t pop_id = 0; pop_id < control.GetNumPopulations(); ++pop_id){
         Population& pop = control.GetPopulation(pop_id);
         if(target_collect.HasPopulation(pop)){
+          is_target[pop_id] = true;
+          target_size += pop.GetSize();
           pop.SetPlaceBirthFun( 
             [this, &pop](Organism & /*org*/, OrgPosition ppos) {
               return PlaceBirth(ppos, pop);
@@ -63,19 +93,18 @@ namespace mabe {
       }
     }
 
+    /// Keep the total size of the managed populations current.
+    void OnPopResize(Population & pop, size_t old_size) override {
+      if (IsTarget(pop)) target_size = target_size + pop.GetSize() - old_size;
+    }
+
     /// Place a birth. Method depends on current population size
     OrgPosition PlaceBirth(OrgPosition ppos, Population & target_pop) {
-      if (target_collect.HasPopulation(target_pop)) { // If population is monitored...
+      if (IsTarget(target_pop)) { // If population is monitored...
         // If population not full, add new position
-        if(target_collect.GetSize() < max_pop_size) return control.PushEmpty(target_pop);
-        else{ // If population full, return a random org's position
-          OrgPosition new_pos = 
-              OrgPosition(target_pop, control.GetRandom().GetUInt(target_pop.GetSize()));
-          while(new_pos == ppos){ // Ensure we don't overwrite parent's position
-            new_pos = OrgPosition(target_pop, control.GetRandom().GetUInt(target_pop.GetSize()));
-          }
-          return new_pos;
-        }
+        if(target_size < max_pop_size) return control.PushEmpty(target_pop);
+        // If population full, return a random position (never the parent's)
+        return RandomOtherPos(target_pop, ppos);
       }
 
       // Otherwise, don't find a legal place!
@@ -84,9 +113,9 @@ namespace mabe {
 
     /// Manually inject an organism. Method depends on current population size
     OrgPosition PlaceInject(Population & target_pop) {
-      if (target_collect.HasPopulation(target_pop)) { // If population is monitored...
+      if (IsTarget(target_pop)) { // If population is monitored...
         // If population not full, add new position
-        if(target_collect.GetSize() < max_pop_size) return control.PushEmpty(target_pop);
+        if(target_size < max_pop_size) return control.PushEmpty(target_pop);
         else{ // If population full, return a random org's position
           return OrgPosition(target_pop, control.GetRandom().GetUInt(target_pop.GetSize()));
         }
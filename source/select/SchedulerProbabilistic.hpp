@@ -5,20 +5,53 @@
  *
  *  @file  SchedulerProbabilistic.h
  *  @brief Rations out updates to organisms based on a specified attribute, using a method akin to roulette selection. 
+ *
+ *  In "single" mode each step is given to an organism chosen by roulette selection, one at a
+ *  time.  In "batch" mode the number of steps each organism receives is drawn all at once (a
+ *  multinomial over the weights, so the total is the same) and organisms are then run for
+ *  their allotments in blocks of up to batch_block steps, visiting organisms in a new random
+ *  order for each round of blocks.
+ *
+ *  "parallel" mode allots steps the same way, but each round of blocks is a time slice run on
+ *  num_threads worker threads, each with a contiguous range of positions.  Actions that would
+ *  change the population (e.g., births) are queued with DeferredActions and carried out by a
+ *  single thread after each slice, in a shuffled (but seeded) order; an action is dropped if the
+ *  organism that requested it has since been replaced.  Results do not depend on num_threads.
+ *  Worker threads are started once per call to Schedule() and wait at a barrier between
+ *  slices while the actions are committed.
+ *
+ *  Each position's weight (base_value + merit_scale_factor * merit) is kept up to date
+ *  incrementally: it is set on placement, moved on swaps, zeroed on death, and re-read after
+ *  an organism runs (since merit usually changes through the organism's own actions, such as
+ *  task rewards).  Each change costs O(log N).
  **/
 
 #ifndef MABE_SCHEDULER_PROB_H
 #define MABE_SCHEDULER_PROB_H
 
+#include <algorithm>
+#include <barrier>
+#include <cmath>
+#include <thread>
+
+#include "../core/DeferredActions.hpp"
 #include "../core/MABE.hpp"
 #include "../core/Module.hpp"
+#include "emp/bits/BitVector.hpp"
 #include "emp/datastructs/UnorderedIndexMap.hpp"
+#include "emp/math/random_utils.hpp"
 
 namespace mabe {
 
   /// Rations out updates to organisms based on a specified attribute, using a method akin to roulette selection  
   class SchedulerProbabilistic : public Module {
   private:
+    enum Mode {
+      SINGLE,    ///< Pick an organism for each step.
+      BATCH,     ///< Pick step counts for all organisms, then run each in blocks.
+      PARALLEL   ///< As BATCH, but run blocks on worker threads, deferring population changes.
+    };
+
     emp::String trait = "merit";  ///< Which trait should we select on?
     emp::String reset_self_trait = "reset_self";  ///< What should we call the trait used to track resetting?
     double avg_updates = 0; ///< How many updates should organisms receive on average?
@@ -26,6 +59,197 @@ namespace mabe {
     emp::UnorderedIndexMap weight_map; ///< Data structure storing all organism fitnesses
     double base_value = 1; ///< Fitness value that all organisms start with 
     double merit_scale_factor = 1; ///< Fitness = base_value + (merit * this value)
+    Mode mode = Mode::SINGLE;  ///< How should steps be handed out?
+    size_t batch_block = 16;   ///< In batch mode, max steps an org runs before others get a turn.
+    emp::vector<size_t> step_counts;  ///< Steps remaining for each position (batch mode).
+    emp::vector<size_t> visit_order;  ///< Positions with steps remaining (batch mode).
+    size_t num_threads = 1;           ///< Worker threads to use (parallel mode; 0 = all available)
+    emp::vector<DeferredActions> worker_actions;        ///< Queued actions for each worker.
+    emp::vector<DeferredActions::Action> commit_list;   ///< All queued actions, in commit order.
+    emp::BitVector replaced_pos;      ///< Positions given a new organism during this commit.
+    bool committing = false;          ///< Are deferred actions currently being carried out?
+
+    // Trait IDs, resolved in SetupDataMap.
+    size_t trait_id = emp::MAX_SIZE_T;
+    size_t reset_self_id = emp::MAX_SIZE_T;
+
+    bool IsTargetPop(OrgPosition pos) const { return pos.PopID() == pop_id; }
+
+    /// Scheduling weight for an organism.
+    double CalcWeight(const Organism & org) {
+      return base_value + merit_scale_factor * org.GetTrait<double>(trait_id);
+    }
+
+    /// Pick up any change in an organism's merit since its weight was last set.
+    void RefreshWeight(Population & pop, size_t pos) {
+      if (pos >= weight_map.GetSize() || pop.IsEmpty(pos)) return;
+      const double weight = CalcWeight(pop[pos]);
+      if (weight != weight_map.GetWeight(pos)) weight_map.Adjust(pos, weight);
+    }
+
+    /// Set every weight from scratch (e.g., if the population changed while we weren't watching).
+    void RebuildWeights(Population & pop) {
+      weight_map.Resize(pop.GetSize(), 0.0);
+      for (size_t pos = 0; pos < pop.GetSize(); ++pos) {
+        weight_map.Adjust(pos, pop.IsEmpty(pos) ? 0.0 : CalcWeight(pop[pos]));
+      }
+    }
+
+    /// Draw from Binomial(n, p).  The count is exact when few successes are expected (stepping
+    /// between successes with geometric skips); otherwise a normal approximation is used.
+    static size_t SampleBinomial(emp::Random & random, size_t n, double p) {
+      if (n == 0 || p <= 0.0) return 0;
+      if (p >= 1.0) return n;
+      if (p > 0.5) return n - SampleBinomial(random, n, 1.0 - p);
+
+      const double mean = n * p;
+      if (mean > 32.0) {
+        const double draw = std::round(mean + std::sqrt(mean * (1.0 - p)) * random.GetNormal());
+        return static_cast<size_t>(std::clamp(draw, 0.0, static_cast<double>(n)));
+      }
+
+      const double log_fail = std::log1p(-p);
+      size_t count = 0;
+      double pos = -1.0;
+      while (true) {
+        pos += std::floor(std::log(1.0 - random.GetDouble()) / log_fail) + 1.0;
+        if (pos >= static_cast<double>(n)) return count;
+        ++count;
+      }
+    }
+
+    /// Divide total_steps among the first num_slots positions in proportion to their weights.
+    void AllotSteps(emp::Random & random, size_t num_slots, size_t total_steps) {
+      step_counts.assign(num_slots, 0);
+      const size_t num_weighted = std::min(num_slots, weight_map.GetSize());
+      double weight_left = weight_map.GetWeight();
+      if (weight_left <= 0.0) {  // No weights -> pick randomly
+        for (size_t i = 0; i < total_steps; ++i) step_counts[random.GetUInt(num_slots)]++;
+        return;
+      }
+
+      // Find the last position with weight, so that it can take any remaining steps.
+      size_t last_pos = num_weighted;
+      while (last_pos > 0 && weight_map.GetWeight(last_pos-1) <= 0.0) --last_pos;
+      if (last_pos == 0) return;
+      --last_pos;
+
+      // Multinomial draw, as a series of binomials conditioned on the steps not yet assigned.
+      size_t steps_left = total_steps;
+      for (size_t pos = 0; pos < last_pos && steps_left > 0; ++pos) {
+        const double weight = weight_map.GetWeight(pos);
+        if (weight <= 0.0) continue;
+        step_counts[pos] = SampleBinomial(random, steps_left, weight / weight_left);
+        steps_left -= step_counts[pos];
+        weight_left -= weight;
+      }
+      step_counts[last_pos] += steps_left;
+    }
+
+    /// Run all of the steps assigned in step_counts in time slices, on worker threads.  The
+    /// same workers are used for every slice; between slices they wait at a barrier while the
+    /// last to arrive refreshes weights and commits the deferred actions.
+    void RunAllottedStepsParallel(emp::Random & random, Population & pop) {
+      const size_t block_size = std::max<size_t>(batch_block, 1);
+      const size_t num_pos = step_counts.size();
+      const size_t num_workers = std::clamp<size_t>(num_threads, 1, std::max<size_t>(num_pos, 1));
+      if (worker_actions.size() < num_workers) worker_actions.resize(num_workers);
+
+      auto steps_left = [this](){
+        return std::any_of(step_counts.begin(), step_counts.end(), [](size_t c){ return c > 0; });
+      };
+      if (!steps_left()) return;
+      uint64_t slice_seed = random.GetUInt64();
+      bool done = false;
+
+      // Runs on a single thread once every worker has finished the current slice.
+      auto finish_slice = [this, &random, &pop, &slice_seed, &done, &steps_left,
+                           num_pos, num_workers]() noexcept {
+        // Weights can't be adjusted from the workers, so pick up merit changes now.
+        for (size_t pos = 0; pos < num_pos; ++pos) RefreshWeight(pop, pos);
+        CommitDeferred(random, pop, num_workers);
+        done = !steps_left();
+        if (!done) slice_seed = random.GetUInt64();
+      };
+      std::barrier slice_barrier(static_cast<std::ptrdiff_t>(num_workers), finish_slice);
+
+      auto run_worker = [this, &pop, &slice_seed, &done, &slice_barrier,
+                         block_size, num_pos, num_workers](size_t worker_id) {
+        DeferredActions & deferred = worker_actions[worker_id];
+        const size_t start = num_pos * worker_id / num_workers;
+        const size_t end = num_pos * (worker_id + 1) / num_workers;
+        while (!done) {
+          deferred.Start(slice_seed);
+          for (size_t pos = start; pos < end; ++pos) {
+            const size_t num_steps = std::min(step_counts[pos], block_size);
+            if (num_steps == 0) continue;
+            deferred.SetOrgPos(pos);
+            Organism & org = pop[pos];   // Nothing can replace an organism during a time slice.
+            for (size_t step = 0; step < num_steps; ++step) org.ProcessStep();
+            step_counts[pos] -= num_steps;
+          }
+          deferred.Stop();
+          slice_barrier.arrive_and_wait();
+        }
+      };
+
+      emp::vector<std::thread> workers;
+      for (size_t worker_id = 1; worker_id < num_workers; ++worker_id) {
+        workers.emplace_back(run_worker, worker_id);
+      }
+      run_worker(0);
+      for (std::thread & worker : workers) worker.join();
+    }
+
+    /// Carry out all actions queued by the workers during the last time slice.
+    void CommitDeferred(emp::Random & random, Population & pop, size_t num_workers) {
+      // Workers cover positions in order, so this list doesn't depend on the thread count;
+      // shuffle it so that no position is favored.
+      commit_list.resize(0);
+      for (size_t worker_id = 0; worker_id < num_workers; ++worker_id) {
+        for (DeferredActions::Action & action : worker_actions[worker_id].GetActions()) {
+          commit_list.push_back(std::move(action));
+        }
+      }
+      emp::Shuffle(random, commit_list);
+
+      replaced_pos.Resize(pop.GetSize());
+      replaced_pos.Clear();
+      committing = true;
+      for (DeferredActions::Action & action : commit_list) {
+        // Skip actions from organisms that have been replaced since they asked.
+        if (action.org_pos < replaced_pos.GetSize() && replaced_pos.Has(action.org_pos)) continue;
+        if (pop.IsEmpty(action.org_pos)) continue;
+        action.fun(pop[action.org_pos]);
+      }
+      committing = false;
+    }
+
+    /// Run all of the steps assigned in step_counts.
+    void RunAllottedSteps(emp::Random & random, Population & pop) {
+      const size_t block_size = std::max<size_t>(batch_block, 1);
+      visit_order.clear();
+      for (size_t pos = 0; pos < step_counts.size(); ++pos) {
+        if (step_counts[pos]) visit_order.push_back(pos);
+      }
+
+      while (visit_order.size()) {
+        emp::Shuffle(random, visit_order);
+        size_t num_kept = 0;
+        for (size_t pos : visit_order) {
+          const size_t num_steps = std::min(step_counts[pos], block_size);
+          // Index each step, since a step may replace the organism at this position.
+          for (size_t step = 0; step < num_steps && pos < pop.GetSize(); ++step) {
+            pop[pos].ProcessStep();
+          }
+          RefreshWeight(pop, pos);
+          step_counts[pos] -= num_steps;
+          if (step_counts[pos]) visit_order[num_kept++] = pos;
+        }
+        visit_order.resize(num_kept);
+      }
+    }
+
   public:
     SchedulerProbabilistic(mabe::MABE & control,
                      const emp::String & name="SchedulerProbabilistic",
@@ -49,12 +273,29 @@ namespace mabe {
       LinkVar(base_value, "base_value", "What value should the scheduler use for organisms"
           " that have performed no tasks?");
       LinkVar(merit_scale_factor, "merit_scale_factor", "How should the scheduler scale merit?");
+      LinkMenu(mode, "mode", "How should steps be handed out to organisms?",
+        Mode::SINGLE, "single", "Choose an organism (by weight) for each step.",
+        Mode::BATCH, "batch", "Choose how many steps each organism gets, then run them in blocks.",
+        Mode::PARALLEL, "parallel", "As batch, but run blocks on multiple threads.");
+      LinkVar(batch_block, "batch_block",
+          "In batch or parallel mode, max steps an organism runs before others get a turn.");
+      LinkVar(num_threads, "num_threads", "Threads to use in parallel mode (0 = all available)");
     }
 
     /// Register traits
     void SetupModule() override {
       AddRequiredTrait<double>(trait); ///< The fitness trait must be set by another module.
       AddOwnedTrait<bool>(reset_self_trait, "Does org need reset?", false); ///< Allow organisms to reset themselves 
+      if (num_threads == 0) num_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    /// Current scheduling weight of each position in the target population.
+    const emp::UnorderedIndexMap & GetWeightMap() const { return weight_map; }
+
+    /// Look up trait IDs once the DataMap is final.
+    void SetupDataMap(emp::DataMap & dm) override {
+      trait_id = dm.GetID(trait);
+      reset_self_id = dm.GetID(reset_self_trait);
     }
 
     /// Set up member functions associated with this class.
@@ -79,7 +320,14 @@ namespace mabe {
         return 0;
       }
 
-      if(weight_map.GetSize() == 0) weight_map.Resize(N, base_value);
+      if (weight_map.GetSize() != N) RebuildWeights(pop);
+      if (mode != Mode::SINGLE) {
+        AllotSteps(random, N, static_cast<size_t>(std::ceil(N * avg_updates)));
+        if (mode == Mode::PARALLEL) RunAllottedStepsParallel(random, pop);
+        else RunAllottedSteps(random, pop);
+        return weight_map.GetWeight();
+      }
+
       size_t selected_idx;
       // Dole out updates
       for(size_t i = 0; i < N * avg_updates; ++i){
@@ -89,21 +337,47 @@ namespace mabe {
         }
         else selected_idx = random.GetUInt(pop.GetSize()); // No weights -> pick randomly 
         pop[selected_idx].ProcessStep();
+        RefreshWeight(pop, selected_idx);
       }
       return weight_map.GetWeight();
     }
 
     /// When an organism is placed in a population, add its weight to the weight map
     void OnPlacement(OrgPosition placement_pos) override {
+      if (!IsTargetPop(placement_pos)) return;
       Population & pop = placement_pos.Pop();
       const size_t N = pop.GetSize();
       if(weight_map.GetSize() < N){
-        weight_map.Resize(N, 1);
+        weight_map.Resize(N, 0.0);
       }
       size_t org_idx = placement_pos.Pos();
-      weight_map.Adjust(org_idx, 
-          base_value + merit_scale_factor * placement_pos.Pop()[org_idx].GetTrait<double>(trait));
-      placement_pos.Pop()[org_idx].SetTrait<bool>(reset_self_trait, false);
+      if (committing) {
+        if (replaced_pos.GetSize() <= org_idx) replaced_pos.Resize(org_idx + 1);
+        replaced_pos.Set(org_idx);
+      }
+      Organism & org = pop[org_idx];
+      weight_map.Adjust(org_idx, CalcWeight(org));
+      org.SetTrait<bool>(reset_self_id, false);
+    }
+
+    /// Dead organisms should no longer be scheduled.
+    void BeforeDeath(OrgPosition pos) override {
+      if (!IsTargetPop(pos) || pos.Pos() >= weight_map.GetSize()) return;
+      weight_map.Adjust(pos.Pos(), 0.0);
+    }
+
+    /// Weights move with their organisms.
+    void OnSwap(OrgPosition pos1, OrgPosition pos2) override {
+      const bool in_pop1 = IsTargetPop(pos1) && pos1.Pos() < weight_map.GetSize();
+      const bool in_pop2 = IsTargetPop(pos2) && pos2.Pos() < weight_map.GetSize();
+      if (in_pop1) weight_map.Adjust(pos1.Pos(), pos1.IsEmpty() ? 0.0 : CalcWeight(*pos1));
+      if (in_pop2) weight_map.Adjust(pos2.Pos(), pos2.IsEmpty() ? 0.0 : CalcWeight(*pos2));
+    }
+
+    /// New positions start empty (weight 0); removed positions were already cleared.
+    void OnPopResize(Population & pop, size_t /*old_size*/) override {
+      if (pop.GetID() != pop_id) return;
+      weight_map.Resize(pop.GetSize(), 0.0);
     }
   };
 
@@ -19,6 +19,9 @@
 #ifndef MABE_TOOLS_NK_HPP
 #define MABE_TOOLS_NK_HPP
 
+#include <cstdint>
+#include <span>
+
 #include "emp/base/vector.hpp"
 #include "emp/bits/BitVector.hpp"
 #include "emp/functional/memo_function.hpp"
@@ -138,6 +141,36 @@ namespace mabe {
       return total;
     }
 
+    /// Get the fitness of a whole bitstring packed into 64-bit words (bit 0 is the low bit of
+    /// words[0]), without building any temporary bit sequences.
+    double GetFitness(std::span<const uint64_t> words) const {
+      emp_assert(words.size() * 64 >= N, words.size(), N);
+      emp_assert(K < 64, K);
+      const uint64_t mask = emp::MaskLow<uint64_t>(K+1);
+
+      // Genes whose K+1 bits don't wrap around span at most two words.
+      double total = 0.0;
+      const size_t num_direct = (N > K) ? N - K : 0;
+      for (size_t i = 0; i < num_direct; i++) {
+        const size_t word_id = i >> 6;
+        const size_t shift = i & 63;
+        uint64_t cur_val = words[word_id] >> shift;
+        if (shift + K >= 64) cur_val |= words[word_id+1] << (64 - shift);
+        total += GetFitness(i, cur_val & mask);
+      }
+
+      // The final K genes wrap around to the start of the genome.
+      for (size_t i = num_direct; i < N; i++) {
+        size_t cur_val = 0;
+        for (size_t j = 0; j <= K; j++) {
+          const size_t pos = (i + j) % N;
+          cur_val |= ((words[pos >> 6] >> (pos & 63)) & 1) << j;
+        }
+        total += GetFitness(i, cur_val);
+      }
+      return total;
+    }
+
     /// Get the fitness of each gene in a bitstring (pass by value so can be modified.)
     emp::vector<double> GetGeneFitnesses(emp::BitVector genome) const {
       emp::vector<double> gene_fitnesses;
@@ -16,6 +16,11 @@ test-%: %.cpp $(CATCH_DIR)/catch.hpp
 test: test-prep $(addprefix test-, $(TEST_NAMES))
 	rm -rf temp
 
+######## BENCHMARKS (hidden test cases tagged [.benchmark], built with optimizations)
+bench-%: %.cpp $(CATCH_DIR)/catch.hpp
+	$(CXX) $(FLAGS_OPT) $< -o $@.out
+	./$@.out "[benchmark]"
+
 ######## CODE COVERAGE
 cov-%: %.cpp ${CATCH_DIR}/catch.hpp
 	$(CXX) $(FLAGS_COVERAGE) $< -o $@.out
@@ -0,0 +1,74 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  SetupHelpers.hpp
+ *  @brief Shared helpers for unit tests that need configured modules and organism DataMaps.
+ */
+
+#ifndef MABE_TEST_SETUP_HELPERS_H
+#define MABE_TEST_SETUP_HELPERS_H
+
+#include <string>
+
+#include "emp/data/DataMap.hpp"
+
+#include "core/MABE.hpp"
+#include "core/OrganismManager.hpp"
+
+/// Create a module of the given type through the config system and return a reference to it.
+template<typename T>
+T& GetConfiguredRef(
+    mabe::MABE& control,
+    const std::string& type_name,
+    const std::string& var_name,
+    emplode::Symbol_Scope& scope){
+  emplode::Symbol_Object& symbol_obj =
+      control.GetConfigScript().GetSymbolTable().MakeObjSymbol(type_name, var_name, scope);
+  return *dynamic_cast<T*>(symbol_obj.GetObjectPtr().Raw());
+}
+
+/// Run setup_fun (which should set up modules) while traits can be added, then return the
+/// locked DataMap that organisms should use.
+template <typename FUN_T>
+emp::DataMap SetupTraits(mabe::MABE & control, FUN_T setup_fun) {
+  control.GetTraitManager().Unlock();
+  setup_fun();
+  control.GetTraitManager().Lock();
+  emp::DataMap data_map = control.GetOrganismDataMap();
+  control.GetTraitManager().RegisterAll(data_map);
+  data_map.LockLayout();
+  return data_map;
+}
+
+/// Run setup on an organism manager (after any other modules it relies on) and return the
+/// locked DataMap that its organisms should use.
+template <typename MANAGER_T, typename... MODULE_Ts>
+emp::DataMap SetupManager(mabe::MABE & control, MANAGER_T & manager, MODULE_Ts &... modules) {
+  emp::DataMap data_map = SetupTraits(control, [&](){
+    (modules.SetupModule(), ...);
+    manager.SetupModule();
+  });
+  manager.SetupDataMap(data_map);
+  return data_map;
+}
+
+/// A MABE instance with a single organism manager that is fully set up.  The manager's shared
+/// data can be adjusted by config_fun before setup is run.
+template <typename ORG_T>
+struct ManagerSetup {
+  mabe::MABE control{0, nullptr};
+  mabe::OrganismManager<ORG_T> manager{control, "test_manager", "desc"};
+  emp::DataMap data_map;
+
+  template <typename CONFIG_T>
+  ManagerSetup(CONFIG_T config_fun) {
+    control.GetRandom().ResetSeed(100);
+    config_fun(manager.GetManagedData());
+    data_map = SetupManager(control, manager);
+  }
+  ManagerSetup() : ManagerSetup([](typename ORG_T::ManagerData &){ }) { }
+};
+
+#endif
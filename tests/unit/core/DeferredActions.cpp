@@ -0,0 +1,59 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  DeferredActions.cpp
+ *  @brief Tests for queuing actions from organisms running on worker threads
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// Empirical tools
+#include "emp/math/Random.hpp"
+// MABE
+#include "core/DeferredActions.hpp"
+
+TEST_CASE("DeferredActions_Queue", "[core]"){
+  mabe::DeferredActions deferred;
+  CHECK(mabe::DeferredActions::GetActive() == nullptr);
+
+  deferred.Start(1234);
+  CHECK(mabe::DeferredActions::GetActive() == &deferred);
+  deferred.SetOrgPos(3);
+  deferred.Add([](mabe::Organism &){ });
+  deferred.SetOrgPos(7);
+  deferred.Add([](mabe::Organism &){ });
+  deferred.Stop();
+  CHECK(mabe::DeferredActions::GetActive() == nullptr);
+
+  REQUIRE(deferred.GetActions().size() == 2);
+  CHECK(deferred.GetActions()[0].org_pos == 3);
+  CHECK(deferred.GetActions()[1].org_pos == 7);
+
+  // Starting a new time slice clears the old actions.
+  deferred.Start(1234);
+  CHECK(deferred.GetActions().size() == 0);
+  deferred.Stop();
+}
+
+TEST_CASE("DeferredActions_Random", "[core]"){
+  emp::Random main_random(1);
+  CHECK(&mabe::DeferredActions::GetRandom(main_random) == &main_random);
+
+  // Each organism gets its own stream, which depends only on the slice seed and its position.
+  mabe::DeferredActions deferred1, deferred2;
+  deferred1.Start(99);
+  deferred1.SetOrgPos(5);
+  const double val1 = mabe::DeferredActions::GetRandom(main_random).GetDouble();
+  deferred1.Stop();
+
+  deferred2.Start(99);
+  deferred2.SetOrgPos(2);
+  mabe::DeferredActions::GetRandom(main_random).GetDouble();
+  deferred2.SetOrgPos(5);
+  CHECK(&mabe::DeferredActions::GetRandom(main_random) != &main_random);
+  CHECK(mabe::DeferredActions::GetRandom(main_random).GetDouble() == val1);
+  deferred2.Stop();
+}
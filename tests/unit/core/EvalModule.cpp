@@ -0,0 +1,93 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  EvalModule.cpp
+ *  @brief Tests for the evaluation results cache in EvalModule.hpp
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// Empirical tools
+#include "emp/bits/BitVector.hpp"
+// MABE
+#include "core/EvalModule.hpp"
+
+/// Minimal deterministic evaluator that counts how often it actually has to calculate.
+class CountingEval : public mabe::EvalModule<CountingEval> {
+public:
+  mabe::EvalCache<emp::BitVector, double> cache{this};
+  size_t num_calcs = 0;
+  double bonus = 0.0;   // Stand-in for a config setting that results depend on.
+
+  CountingEval(mabe::MABE & control) : EvalModule(control, "CountingEval", "Test evaluator") { }
+
+  bool IsDeterministic() const override { return true; }
+  void SetCacheSize(size_t size) { cache_size = size; }
+  double EvaluateCollection(const mabe::Collection &) override { return 0.0; }
+
+  double Calc(const emp::BitVector & bits) {
+    CheckCacheConfig(bonus);
+    return cache.Get(bits, [this,&bits](){ ++num_calcs; return bits.CountOnes() + bonus; });
+  }
+};
+
+TEST_CASE("EvalModule_EvalCache", "[core]"){
+  mabe::MABE control(0, NULL);
+  CountingEval eval(control);
+  const emp::BitVector bits1("0011");
+  const emp::BitVector bits2("1111");
+  const emp::BitVector bits3("1000");
+
+  // With no cache size, every call should calculate.
+  CHECK(eval.Calc(bits1) == 2.0);
+  CHECK(eval.Calc(bits1) == 2.0);
+  CHECK(eval.num_calcs == 2);
+  CHECK(eval.GetCacheHits() == 0);
+  CHECK(eval.cache.GetSize() == 0);
+
+  // Turn on the cache; repeats should now be hits.
+  eval.SetCacheSize(2);
+  eval.num_calcs = 0;
+  CHECK(eval.Calc(bits1) == 2.0);
+  CHECK(eval.Calc(bits1) == 2.0);
+  CHECK(eval.Calc(bits2) == 4.0);
+  CHECK(eval.num_calcs == 2);
+  CHECK(eval.GetCacheHits() == 1);
+  CHECK(eval.GetCacheMisses() == 2);
+
+  // Use bits1 so that bits2 is least recently used; adding bits3 should evict bits2.
+  CHECK(eval.Calc(bits1) == 2.0);
+  CHECK(eval.Calc(bits3) == 1.0);
+  CHECK(eval.cache.GetSize() == 2);
+  CHECK(eval.Calc(bits1) == 2.0);
+  CHECK(eval.num_calcs == 3);
+  CHECK(eval.Calc(bits2) == 4.0);
+  CHECK(eval.num_calcs == 4);
+
+  // Clearing must drop all results.
+  eval.ClearEvalCache();
+  CHECK(eval.cache.GetSize() == 0);
+  CHECK(eval.Calc(bits1) == 2.0);
+  CHECK(eval.num_calcs == 5);
+}
+
+TEST_CASE("EvalModule_EvalCacheConfig", "[core]"){
+  mabe::MABE control(0, NULL);
+  CountingEval eval(control);
+  eval.SetCacheSize(4);
+  const emp::BitVector bits("0111");
+
+  CHECK(eval.Calc(bits) == 3.0);
+  CHECK(eval.Calc(bits) == 3.0);
+  CHECK(eval.num_calcs == 1);
+
+  // Changing a setting that results depend on must not return the old result.
+  eval.bonus = 10.0;
+  CHECK(eval.Calc(bits) == 13.0);
+  CHECK(eval.num_calcs == 2);
+  CHECK(eval.Calc(bits) == 13.0);
+  CHECK(eval.num_calcs == 2);
+}
@@ -1,17 +1,208 @@
 /**
  *  @note This file is part of MABE, https://github.com/mercere99/MABE2
  *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
- *  @date 2019-2021.
+ *  @date 2019-2024.
  *
  *  @file  Genome.cpp
- *  @brief TODO. Currently this is a placeholder so codecov will see the untested source code
+ *  @brief Tests for Genome.hpp
  */
 
+#include <limits>
+
 // CATCH
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
+// Empirical tools
+#include "emp/base/vector.hpp"
 // MABE
 #include "core/Genome.hpp"
 
+/// Genome of ints (initially 0, 1, 2, ...) that can be linear or circular, and that counts
+/// its bulk reads and writes to make sure each one stays inside the genome.
+class TestGenome : public mabe::Genome {
+public:
+  emp::vector<int> data;
+  bool circular = false;
+  mutable size_t num_bulk_calls = 0;
+
+  TestGenome(size_t size, bool _circular) : data(size), circular(_circular) {
+    for (size_t i = 0; i < size; ++i) data[i] = (int) i;
+  }
+
+  emp::Ptr<Genome> Clone() override { return emp::NewPtr<TestGenome>(*this); }
+  emp::Ptr<Genome> CloneProtocol() override { return emp::NewPtr<TestGenome>(0, circular); }
+
+  size_t GetSize() const override { return data.size(); }
+  void Resize(size_t new_size) override { data.resize(new_size); }
+  void Resize(size_t new_size, double default_val) override { data.resize(new_size, (int) default_val); }
+  size_t GetNumBytes() const override { return data.size() * sizeof(int); }
+  void SetSizeRange(size_t, size_t) override { }
+
+  bool IsValid(size_t pos) const override { return circular ? data.size() > 0 : pos < data.size(); }
+  size_t ValidatePosition(size_t pos) const override {
+    if (!circular || data.empty()) return pos;
+    // Heads move backward by adding a wrapped-around (i.e., negative) offset.
+    constexpr size_t MAX = std::numeric_limits<size_t>::max();
+    if (pos > MAX / 2) return data.size() - 1 - ((MAX - pos) % data.size());
+    return pos % data.size();
+  }
+
+  void Randomize(emp::Random & random, size_t pos) override { data[pos] = (int) random.GetUInt(100); }
+  size_t Mutate(emp::Random &) override { return 0; }
+
+  int ReadInt(size_t index) const override { return data[index]; }
+  double ReadDouble(size_t index) const override { return data[index]; }
+  std::byte ReadByte(size_t index) const override { return (std::byte) data[index]; }
+  bool ReadBit(size_t index) const override { return data[index] & 1; }
+  int ReadInt(size_t index, int min, int max) const override {
+    return std::clamp(data[index], min, max);
+  }
+
+  void WriteInt(size_t index, int value) override { data[index] = value; }
+  void WriteDouble(size_t index, double value) override { data[index] = (int) value; }
+  void WriteByte(size_t index, std::byte value) override { data[index] = (int) value; }
+  void WriteBit(size_t index, bool value) override { data[index] = value; }
+
+  void ReadInts(size_t start_index, std::span<int> out) const override {
+    CHECK(start_index + out.size() <= data.size());
+    ++num_bulk_calls;
+    std::copy_n(data.begin() + start_index, out.size(), out.begin());
+  }
+  void WriteInts(size_t start_index, std::span<const int> values) override {
+    CHECK(start_index + values.size() <= data.size());
+    ++num_bulk_calls;
+    std::copy(values.begin(), values.end(), data.begin() + start_index);
+  }
+};
+
+TEST_CASE("Genome_HeadReadSpanForward", "[core]"){
+  TestGenome genome(10, false);
+  emp::vector<int> out(5);
+
+  auto head = genome.GetHead(2);
+  CHECK(head.ReadInts(out) == 5);
+  CHECK(out == emp::vector<int>{2, 3, 4, 5, 6});
+  CHECK(genome.num_bulk_calls == 1);
+  CHECK(head == genome.GetHead(7));
+
+  // Reading past the end stops at the end; remaining values are zero.
+  genome.num_bulk_calls = 0;
+  head = genome.GetHead(8);
+  CHECK(head.ReadInts(out) == 2);
+  CHECK(out == emp::vector<int>{8, 9, 0, 0, 0});
+  CHECK(genome.num_bulk_calls == 1);
+  CHECK(head == genome.GetHead(13));
+  CHECK(!head.IsValid());
+  CHECK(head.ReadInts(out) == 0);
+  CHECK(out == emp::vector<int>{0, 0, 0, 0, 0});
+
+  // Doubles go through the per-value fallback.
+  emp::vector<double> out_d(3);
+  head = genome.GetHead(7);
+  CHECK(head.ReadDoubles(out_d) == 3);
+  CHECK(out_d == emp::vector<double>{7.0, 8.0, 9.0});
+}
+
+TEST_CASE("Genome_HeadReadSpanBackward", "[core]"){
+  TestGenome genome(10, false);
+  emp::vector<int> out(3);
+
+  // Values come back in the order they are reached, from one bulk call.
+  auto head = genome.GetHead(4, -1);
+  CHECK(head.ReadInts(out) == 3);
+  CHECK(out == emp::vector<int>{4, 3, 2});
+  CHECK(genome.num_bulk_calls == 1);
+  CHECK(head == genome.GetHead(1, -1));
+
+  // Reading past the start stops there.
+  emp::vector<int> out4(4);
+  CHECK(head.ReadInts(out4) == 2);
+  CHECK(out4 == emp::vector<int>{1, 0, 0, 0});
+  CHECK(!head.IsValid());
+}
+
+TEST_CASE("Genome_HeadWriteSpan", "[core]"){
+  TestGenome genome(10, false);
+
+  // Forward writes are a single bulk call; values past the end are dropped.
+  auto head = genome.GetHead(8);
+  head.WriteInts(emp::vector<int>{100, 101, 102});
+  CHECK(genome.num_bulk_calls == 1);
+  CHECK(genome.data == emp::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 100, 101});
+  CHECK(head == genome.GetHead(11));
+
+  // Backward writes place values at decreasing positions.
+  head = genome.GetHead(2, -1);
+  head.WriteInts(emp::vector<int>{50, 51, 52, 53});
+  CHECK(genome.data == emp::vector<int>{52, 51, 50, 3, 4, 5, 6, 7, 100, 101});
+  CHECK(!head.IsValid());
+}
+
+TEST_CASE("Genome_HeadSpanCircular", "[core]"){
+  TestGenome genome(10, true);
+
+  // Forward reads wrap around, with one bulk call per pass over the genome.
+  emp::vector<int> out(6);
+  auto head = genome.GetHead(7);
+  CHECK(head.ReadInts(out) == 6);
+  CHECK(out == emp::vector<int>{7, 8, 9, 0, 1, 2});
+  CHECK(genome.num_bulk_calls == 2);
+  CHECK(head == genome.GetHead(3));
+
+  genome.num_bulk_calls = 0;
+  emp::vector<int> out25(25);
+  head = genome.GetHead(0);
+  CHECK(head.ReadInts(out25) == 25);
+  for (size_t i = 0; i < out25.size(); ++i) CHECK(out25[i] == (int) (i % 10));
+  CHECK(genome.num_bulk_calls == 3);
+  CHECK(head == genome.GetHead(5));
+
+  // Backward reads wrap from the start to the end.
+  emp::vector<int> out5(5);
+  head = genome.GetHead(2, -1);
+  CHECK(head.ReadInts(out5) == 5);
+  CHECK(out5 == emp::vector<int>{2, 1, 0, 9, 8});
+  CHECK(head == genome.GetHead(7, -1));
+
+  // Writes wrap the same way.
+  genome.num_bulk_calls = 0;
+  head = genome.GetHead(8);
+  head.WriteInts(emp::vector<int>{20, 21, 22, 23});
+  CHECK(genome.num_bulk_calls == 2);
+  head = genome.GetHead(1, -1);
+  head.WriteInts(emp::vector<int>{30, 31, 32});
+  CHECK(genome.data == emp::vector<int>{31, 30, 2, 3, 4, 5, 6, 7, 20, 32});
+  CHECK(head == genome.GetHead(8, -1));
+}
+
+TEST_CASE("Genome_HeadSpanMatchesSingleValues", "[core]"){
+  // Every span read or write must match the same sequence of single-value calls.
+  for (bool circular : {false, true}) {
+    for (int direction : {1, -1}) {
+      for (size_t start = 0; start < 10; ++start) {
+        for (size_t count = 0; count <= 25; ++count) {
+          TestGenome genome(10, circular);
+          auto span_head = genome.GetHead(start, direction);
+          auto single_head = genome.GetHead(start, direction);
+          emp::vector<int> span_out(count);
+          const size_t num_read = span_head.ReadInts(span_out);
+          size_t num_valid = 0;
+          for (size_t i = 0; i < count; ++i) {
+            if (single_head.IsValid()) ++num_valid;
+            CHECK(single_head.ReadInt() == span_out[i]);
+          }
+          CHECK(num_read == num_valid);
+          CHECK(span_head == single_head);
 
-TEST_CASE("Genome_Placeholder", "[core]"){ ; }
+          emp::vector<int> values(count);
+          for (size_t i = 0; i < count; ++i) values[i] = 1000 + (int) i;
+          TestGenome span_genome(10, circular), single_genome(10, circular);
+          span_genome.GetHead(start, direction).WriteInts(values);
+          auto write_head = single_genome.GetHead(start, direction);
+          for (int value : values) write_head.WriteInt(value);
+          CHECK(span_genome.data == single_genome.data);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,223 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  GenomeIO.cpp
+ *  @brief Tests for the binary genome tools in GenomeIO.hpp
+ */
+
+#include <fstream>
+#include <sstream>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// Empirical tools
+#include "emp/base/vector.hpp"
+// MABE
+#include "core/GenomeIO.hpp"
+#include "core/MABE.hpp"
+#include "orgs/AvidaGPOrg.hpp"
+#include "orgs/BitsOrg.hpp"
+#include "orgs/ValsOrg.hpp"
+#include "orgs/VirtualCPUOrg.hpp"
+#include "orgs/instructions/VirtualCPU_Inst_IO.hpp"
+#include "orgs/instructions/VirtualCPU_Inst_Nop.hpp"
+// Test helpers
+#include "../SetupHelpers.hpp"
+
+/// Expose the AvidaGP hardware so that a genome can be built.
+class AvidaGPTester : public mabe::AvidaGPOrg {
+public:
+  using mabe::AvidaGPOrg::AvidaGPOrg;
+  using mabe::AvidaGPOrg::hardware;
+};
+
+TEST_CASE("GenomeIO_RoundTrip", "[core]"){
+  std::stringstream ss;
+  emp::vector<double> vals = {1.5, -2.25, 1e10, 0.0};
+  mabe::WriteBinary<uint64_t>(ss, vals.size());
+  mabe::WriteBinarySpan(ss, std::span<const double>(vals));
+  mabe::WriteBinaryString(ss, "genome");
+
+  uint64_t size = 0;
+  CHECK(mabe::ReadBinary(ss, size));
+  CHECK(size == vals.size());
+  emp::vector<double> loaded(size);
+  CHECK(mabe::ReadBinarySpan(ss, std::span<double>(loaded)));
+  CHECK(loaded == vals);
+  emp::String name;
+  CHECK(mabe::ReadBinaryString(ss, name));
+  CHECK(name == "genome");
+
+  // Nothing is left to read.
+  uint8_t extra = 0;
+  CHECK(mabe::ReadBinary(ss, extra) == false);
+}
+
+TEST_CASE("GenomeIO_CheckBinaryCount", "[core]"){
+  std::stringstream ss;
+  mabe::WriteBinary<uint64_t>(ss, 3);
+  mabe::WriteBinarySpan(ss, std::span<const double>(emp::vector<double>{1.0, 2.0, 3.0}));
+  uint64_t size = 0;
+  CHECK(mabe::ReadBinary(ss, size));
+  CHECK(mabe::CheckBinaryCount(ss, size, sizeof(double)));
+  CHECK(mabe::CheckBinaryCount(ss, size + 1, sizeof(double)) == false);
+  CHECK(mabe::CheckBinaryCount(ss, 0xFFFFFFFFFFFFull, sizeof(double)) == false);
+  CHECK(mabe::CheckBinaryCount(ss, 24, 1));
+  // Checking does not move the read position.
+  emp::vector<double> loaded(size);
+  CHECK(mabe::ReadBinarySpan(ss, std::span<double>(loaded)));
+  CHECK(loaded == emp::vector<double>{1.0, 2.0, 3.0});
+
+  // A string with a corrupt length is rejected before it is allocated.
+  std::stringstream ss_string;
+  mabe::WriteBinary<uint32_t>(ss_string, 0xFFFFFFF0u);
+  ss_string << "short";
+  emp::String str;
+  CHECK(mabe::ReadBinaryString(ss_string, str) == false);
+  CHECK(str.size() == 0);
+}
+
+TEST_CASE("GenomeIO_Header", "[core]"){
+  std::stringstream ss;
+  mabe::GenomeFileHeader header;
+  header.org_type = "BitsOrg";
+  header.num_genomes = 1000000;
+  header.Write(ss);
+
+  mabe::GenomeFileHeader loaded;
+  CHECK(loaded.Read(ss, "test"));
+  CHECK(loaded.version == mabe::GenomeFileHeader::CUR_VERSION);
+  CHECK(loaded.org_type == "BitsOrg");
+  CHECK(loaded.num_genomes == 1000000);
+}
+
+TEST_CASE("GenomeIO_BitsOrg", "[core]"){
+  mabe::MABE control(0, nullptr);
+  control.GetRandom().ResetSeed(100);
+  mabe::OrganismManager<mabe::BitsOrg> manager(control, "bits_manager", "desc");
+  manager.GetManagedData().num_bits = 37;   // Not a whole number of bytes.
+  emp::DataMap data_map = SetupManager(control, manager);
+
+  mabe::BitsOrg org(manager), loaded(manager);
+  org.SetDataMap(data_map);
+  loaded.SetDataMap(data_map);
+  org.Initialize(control.GetRandom());
+
+  std::stringstream ss;
+  CHECK(org.WriteGenome(ss));
+  CHECK(ss.str().size() == sizeof(uint64_t) + 5);
+  CHECK(loaded.ReadGenome(ss));
+  CHECK(loaded.GetTrait<emp::BitVector>("bits") == org.GetTrait<emp::BitVector>("bits"));
+  CHECK(loaded.ToString() == org.ToString());
+  uint8_t extra = 0;
+  CHECK(mabe::ReadBinary(ss, extra) == false);
+
+  // A truncated genome fails to load.
+  std::stringstream ss_truncated;
+  org.WriteGenome(ss_truncated);
+  std::stringstream ss_short(ss_truncated.str().substr(0, ss_truncated.str().size() - 1));
+  CHECK(loaded.ReadGenome(ss_short) == false);
+}
+
+TEST_CASE("GenomeIO_ValsOrg", "[core]"){
+  mabe::MABE control(0, nullptr);
+  control.GetRandom().ResetSeed(100);
+  mabe::OrganismManager<mabe::ValsOrg> manager(control, "vals_manager", "desc");
+  manager.GetManagedData().num_vals = 20;
+  emp::DataMap data_map = SetupManager(control, manager);
+
+  mabe::ValsOrg org(manager), loaded(manager);
+  org.SetDataMap(data_map);
+  loaded.SetDataMap(data_map);
+  org.Initialize(control.GetRandom());
+
+  std::stringstream ss;
+  CHECK(org.WriteGenome(ss));
+  CHECK(ss.str().size() == sizeof(uint64_t) + 20 * sizeof(double));
+  CHECK(loaded.ReadGenome(ss));
+  std::span<double> vals = org.GetTrait<double>(data_map.GetID("vals"), 20);
+  std::span<double> loaded_vals = loaded.GetTrait<double>(data_map.GetID("vals"), 20);
+  for (size_t i = 0; i < 20; ++i) CHECK(loaded_vals[i] == vals[i]);
+  CHECK(loaded.GetTrait<double>("total") == org.GetTrait<double>("total"));
+  CHECK(loaded.ToString() == org.ToString());
+}
+
+TEST_CASE("GenomeIO_AvidaGPOrg", "[core]"){
+  mabe::MABE control(0, nullptr);
+  control.GetRandom().ResetSeed(100);
+  mabe::OrganismManager<mabe::AvidaGPOrg> manager(control, "avida_manager", "desc");
+  emp::DataMap data_map = SetupManager(control, manager);
+
+  AvidaGPTester org(manager), loaded(manager);
+  org.SetDataMap(data_map);
+  loaded.SetDataMap(data_map);
+  org.hardware.PushDefaultInst(50);
+  org.Randomize(control.GetRandom());
+  loaded.hardware.PushDefaultInst(10);   // Loading replaces any existing genome.
+
+  std::stringstream ss;
+  CHECK(org.WriteGenome(ss));
+  CHECK(ss.str().size() == sizeof(uint64_t) + 50 * 4);
+  CHECK(loaded.ReadGenome(ss));
+  CHECK(loaded.hardware.GetSize() == 50);
+  CHECK(loaded.ToString() == org.ToString());
+}
+
+TEST_CASE("GenomeIO_VirtualCPUOrg", "[core]"){
+  // Instruction sets are loaded from a file.
+  std::ofstream("temp/genome_io_inst_set.txt") << "NopA\nNopB\nNopC\nIO\n";
+
+  mabe::MABE control(0, nullptr);
+  control.GetRandom().ResetSeed(100);
+  control.AddPopulation("test_pop", 0);
+  emplode::Symbol_Scope root_scope("root_scope", "desc", nullptr);
+  mabe::OrganismManager<mabe::VirtualCPUOrg> manager(control, "vcpu_manager", "desc");
+  auto & nop_inst_module = GetConfiguredRef<mabe::VirtualCPU_Inst_Nop>(
+      control, "VirtualCPU_Inst_Nop", "insts_nop", root_scope);
+  auto & io_inst_module = GetConfiguredRef<mabe::VirtualCPU_Inst_IO>(
+      control, "VirtualCPU_Inst_IO", "insts_io", root_scope);
+  manager.GetManagedData().inst_set_input_filename = "temp/genome_io_inst_set.txt";
+  emp::DataMap data_map = SetupManager(control, manager, nop_inst_module, io_inst_module);
+
+  mabe::VirtualCPUOrg org(manager), loaded(manager);
+  org.SetDataMap(data_map);
+  loaded.SetDataMap(data_map);
+  org.Initialize(control.GetRandom());
+  REQUIRE(org.GetGenomeSize() > 0);
+
+  std::stringstream ss;
+  CHECK(org.WriteGenome(ss));
+  CHECK(ss.str().size() == sizeof(uint64_t) + org.GetGenomeSize());
+  CHECK(loaded.ReadGenome(ss));
+  CHECK(loaded.GetGenomeSize() == org.GetGenomeSize());
+  CHECK(loaded.GetGenomeString() == org.GetGenomeString());
+}
+
+TEST_CASE("GenomeIO_SaveLoadGenomes", "[core]"){
+  mabe::MABE control(0, nullptr);
+  control.GetRandom().ResetSeed(100);
+  emplode::Symbol_Scope root_scope("root_scope", "desc", nullptr);
+  GetConfiguredRef<mabe::OrganismManager<mabe::BitsOrg>>(control, "BitsOrg", "bits_org", root_scope);
+  mabe::Population & source_pop = control.AddPopulation("source_pop");
+  mabe::Population & loaded_pop = control.AddPopulation("loaded_pop");
+  REQUIRE(control.Setup());
+
+  control.Inject(source_pop, "bits_org", 10);
+  CHECK(control.SaveGenomes(source_pop, "temp/bits_genomes.bin") == 10);
+
+  mabe::Collection loaded = control.LoadGenomes(loaded_pop, "temp/bits_genomes.bin");
+  CHECK(loaded.GetSize() == 10);
+  REQUIRE(loaded_pop.GetSize() == 10);
+  for (size_t pos = 0; pos < 10; ++pos) {
+    CHECK(loaded_pop[pos].GetTypeName() == "bits_org");
+    CHECK(loaded_pop[pos].ToString() == source_pop[pos].ToString());
+  }
+
+  // Loading again appends another copy of every genome.
+  control.LoadGenomes(loaded_pop, "temp/bits_genomes.bin");
+  REQUIRE(loaded_pop.GetSize() == 20);
+  CHECK(loaded_pop[15].ToString() == source_pop[5].ToString());
+}
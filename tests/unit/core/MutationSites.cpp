@@ -0,0 +1,83 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  MutationSites.cpp
+ *  @brief Tests for the mutation-site samplers in MutationSites.hpp
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// Empirical tools
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+// MABE
+#include "core/MutationSites.hpp"
+
+TEST_CASE("MutationSites_ForEachDistinctSite", "[core]"){
+  emp::Random random(5);
+  emp::vector<size_t> hits(100, 0);
+  auto count_fun = [&hits](size_t pos){ ++hits[pos]; };
+
+  // Small counts (tracked on the stack) and large counts (Floyd's algorithm) must both
+  // produce exactly the requested number of distinct sites.
+  for (size_t num_muts : {0, 1, 5, 32, 40, 99}) {
+    std::fill(hits.begin(), hits.end(), 0);
+    CHECK(mabe::ForEachDistinctSite(random, hits.size(), num_muts, count_fun) == num_muts);
+    size_t total = 0;
+    for (size_t count : hits) {
+      CHECK(count <= 1);
+      total += count;
+    }
+    CHECK(total == num_muts);
+  }
+
+  // Asking for more mutations than sites should mutate every site once.
+  std::fill(hits.begin(), hits.end(), 0);
+  CHECK(mabe::ForEachDistinctSite(random, hits.size(), 500, count_fun) == 100);
+  for (size_t count : hits) CHECK(count == 1);
+
+  // Large genomes, run repeatedly and with varying sizes, so that the reused tracking bits must
+  // be left clear after each call.
+  emp::vector<size_t> big_hits(100000, 0);
+  for (size_t num_sites : {100000, 70000, 100000}) {
+    std::fill(big_hits.begin(), big_hits.end(), 0);
+    const size_t num_muts = num_sites / 2;
+    CHECK(mabe::ForEachDistinctSite(random, num_sites, num_muts,
+                                    [&big_hits](size_t pos){ ++big_hits[pos]; }) == num_muts);
+    size_t total = 0;
+    for (size_t pos = 0; pos < num_sites; ++pos) {
+      if (big_hits[pos] > 1) FAIL("Site " << pos << " mutated more than once.");
+      total += big_hits[pos];
+    }
+    CHECK(total == num_muts);
+  }
+}
+
+TEST_CASE("MutationSites_ForEachMutationSite", "[core]"){
+  emp::Random random(7);
+  emp::vector<size_t> hits(1000, 0);
+  auto count_fun = [&hits](size_t pos){ ++hits[pos]; };
+
+  CHECK(mabe::ForEachMutationSite(random, hits.size(), 0.0, count_fun) == 0);
+  CHECK(mabe::ForEachMutationSite(random, hits.size(), 1.0, count_fun) == 1000);
+  for (size_t count : hits) CHECK(count == 1);
+
+  // Sites are visited in increasing order, at most once, at roughly the expected rate.
+  size_t total = 0;
+  for (size_t trial = 0; trial < 100; ++trial) {
+    size_t prev = 0;
+    bool first = true;
+    total += mabe::ForEachMutationSite(random, hits.size(), 0.01,
+      [&prev, &first](size_t pos){
+        CHECK(pos < 1000);
+        if (!first) CHECK(pos > prev);
+        prev = pos;
+        first = false;
+      });
+  }
+  CHECK(total > 700);   // Expected 1000 mutations over 100 trials.
+  CHECK(total < 1300);
+}
@@ -1,17 +1,102 @@
 /**
  *  @note This file is part of MABE, https://github.com/mercere99/MABE2
  *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
- *  @date 2019-2021.
+ *  @date 2019-2024.
  *
  *  @file  Organism.cpp
- *  @brief TODO. Currently this is a placeholder so codecov will see the untested source code
+ *  @brief Tests for Organism.hpp
  */
 
 // CATCH
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 // MABE
+#include "core/MABE.hpp"
 #include "core/Organism.hpp"
+#include "core/OrganismManager.hpp"
 
+/// Organism whose traits can be marked stale; a stale trait is recalculated as 100 + its ID.
+class StaleOrg : public mabe::OrganismTemplate<StaleOrg> {
+public:
+  emp::vector<size_t> updates;   ///< IDs of traits recalculated, in order.
 
-TEST_CASE("Organism_Placeholder", "[core]"){ ; }
+  StaleOrg(mabe::OrganismManager<StaleOrg> & manager)
+    : mabe::OrganismTemplate<StaleOrg>(manager) { }
+
+  struct ManagerData : public mabe::Organism::ManagerData { };
+
+  size_t Mutate(emp::Random &) override { return 0; }
+
+  void MarkStale(size_t trait_id) { MarkTraitStale(trait_id); }
+
+  void UpdateStaleTrait(size_t trait_id) override {
+    updates.push_back(trait_id);
+    GetTrait<int>(trait_id) = 100 + (int) trait_id;
+  }
+};
+
+TEST_CASE("Organism_StaleTraits", "[core]"){
+  mabe::MABE control(0, nullptr);
+  mabe::OrganismManager<StaleOrg> manager(control, "stale_manager", "desc");
+  const emp::vector<emp::String> names = {"t0", "t1", "t2", "t3", "t4", "t5"};
+  control.GetTraitManager().Unlock();
+  for (const auto & name : names) manager.AddSharedTrait<int>(name, "Test trait", 0);
+  control.GetTraitManager().Lock();
+  emp::DataMap data_map = control.GetOrganismDataMap();
+  control.GetTraitManager().RegisterAll(data_map);
+  data_map.LockLayout();
+  emp::vector<size_t> ids;
+  for (const auto & name : names) ids.push_back(data_map.GetID(name));
+
+  StaleOrg org(manager);
+  org.SetDataMap(data_map);
+
+  { // Marking a second trait stale must not lose the first.
+    org.MarkStale(ids[0]);
+    org.MarkStale(ids[1]);
+    org.MarkStale(ids[1]);
+    CHECK(org.GetTrait<int>("t1") == 100 + (int) ids[1]);
+    CHECK(org.GetTrait<int>(ids[0]) == 100 + (int) ids[0]);
+    CHECK(org.updates == emp::vector<size_t>{ids[1], ids[0]});
+    CHECK(org.GetTrait<int>(ids[0]) == 100 + (int) ids[0]);
+    CHECK(org.updates.size() == 2);   // Only recalculated once.
+  }
+
+  { // An explicitly set value must not be overwritten by a later read.
+    org.updates.resize(0);
+    org.MarkStale(ids[2]);
+    org.SetTrait<int>(ids[2], 7);
+    CHECK(org.GetTrait<int>(ids[2]) == 7);
+    org.MarkStale(ids[3]);
+    org.SetTrait("t3", 8);
+    CHECK(org.GetTrait<int>("t3") == 8);
+    CHECK(org.updates.size() == 0);
+  }
+
+  { // Reading other traits by name leaves a stale trait alone until it is read itself.
+    org.updates.resize(0);
+    org.MarkStale(ids[5]);
+    CHECK(org.GetTrait<int>("t2") == 7);
+    CHECK(org.GetTraitAsString("t3") == "8");
+    CHECK(org.updates.size() == 0);
+    CHECK(org.GetTrait<int>("t5") == 100 + (int) ids[5]);
+    CHECK(org.updates == emp::vector<size_t>{ids[5]});
+  }
+
+  { // More stale traits than are tracked inline; all must still end up correct.
+    org.updates.resize(0);
+    for (size_t id : ids) org.MarkStale(id);
+    for (size_t id : ids) CHECK(org.GetTrait<int>(id) == 100 + (int) id);
+    CHECK(org.updates.size() == ids.size());
+  }
+
+  { // Copies keep the stale traits of the original.
+    org.updates.resize(0);
+    org.MarkStale(ids[4]);
+    StaleOrg copy(org);
+    copy.updates.resize(0);
+    CHECK(copy.GetTrait<int>(ids[4]) == 100 + (int) ids[4]);
+    CHECK(copy.updates.size() == 1);
+    CHECK(org.updates.size() == 0);
+  }
+}
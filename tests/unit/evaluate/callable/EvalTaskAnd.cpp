@@ -51,6 +51,7 @@ TEST_CASE("EvalTaskAnd", "[evaluate/callable]"){
   control.GetTraitManager().Lock();
   org_t org(org_manager);
   control.GetTraitManager().RegisterAll(org.GetDataMap());
+  task.SetupDataMap(org.GetDataMap());
   org_t::inst_t inst(0,0);
   
   // Setup and fetch the new function
@@ -85,3 +86,27 @@ TEST_CASE("EvalTaskAnd", "[evaluate/callable]"){
   CHECK(org.GetTrait<double>("merit") == 1);
   CHECK(org.GetTrait<bool>("and_performed"));
 }
+
+TEST_CASE("EvalTaskAnd_AnswerTable", "[evaluate/callable]"){
+  using data_t = mabe::VirtualCPUOrg::data_t;
+  using table_t = mabe::EvalTaskInterface::answer_table_t;
+
+  mabe::MABE control = mabe::MABE(0, NULL);
+  control.AddPopulation("fake pop"); 
+  mabe::EvalTaskAnd task(control);
+
+  emp::vector<data_t> inputs = {127, 35, 12};
+  table_t table;
+  CHECK(!table.IsBuiltFor(inputs));
+  table.Rebuild(inputs);
+  task.AddAnswers(inputs, table, 2);
+  CHECK(table.IsBuiltFor(inputs));
+  CHECK(table.Lookup(127 & 35) == 2);
+  CHECK(table.Lookup(127 & 12) == 2);
+  CHECK(table.Lookup(35 & 12) == 2);
+  CHECK(table.Lookup(127) == 0);
+
+  // Copies start empty and must be rebuilt for their own inputs.
+  table_t table_copy(table);
+  CHECK(!table_copy.IsBuiltFor(inputs));
+}
@@ -51,6 +51,7 @@ TEST_CASE("EvalTaskEqu", "[evaluate/callable]"){
   control.GetTraitManager().Lock();
   org_t org(org_manager);
   control.GetTraitManager().RegisterAll(org.GetDataMap());
+  task.SetupDataMap(org.GetDataMap());
   org_t::inst_t inst(0,0);
   
   // Setup and fetch the new function
@@ -52,6 +52,7 @@ TEST_CASE("EvalTaskNand", "[evaluate/callable]"){
   control.GetTraitManager().Lock();
   org_t org(org_manager);
   control.GetTraitManager().RegisterAll(org.GetDataMap());
+  task.SetupDataMap(org.GetDataMap());
   org_t::inst_t inst(0,0);
   
   // Setup and fetch the new function
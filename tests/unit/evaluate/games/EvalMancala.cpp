@@ -1,22 +1,167 @@
 /**
  *  @note This file is part of MABE, https://github.com/mercere99/MABE2
  *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
- *  @date 2019-2021.
+ *  @date 2019-2024.
  *
- *  @file EvalMancala.cpp 
- *  @brief Placeholder test file for EvalMancala.hpp 
+ *  @file EvalMancala.cpp
+ *  @brief Tests for EvalMancala.hpp
  */
 
+#include <set>
+#include <utility>
+
 // CATCH
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 // Empirical tools
 #include "emp/base/vector.hpp"
 // MABE
+#include "core/OrganismManager.hpp"
 #include "evaluate/games/EvalMancala.hpp"
+// Test helpers
+#include "../../SetupHelpers.hpp"
+
+/// Organism that plays a fixed strategy (chosen by its style) based on the board state.
+class MancalaOrg : public mabe::OrganismTemplate<MancalaOrg> {
+public:
+  size_t style = 0;
+
+  MancalaOrg(mabe::OrganismManager<MancalaOrg> & manager)
+    : mabe::OrganismTemplate<MancalaOrg>(manager) { }
+
+  struct ManagerData : public mabe::Organism::ManagerData { };
+
+  size_t Mutate(emp::Random &) override { return 0; }
+
+  void GenerateOutput() override {
+    const emp::vector<double> & input = GetTrait<emp::vector<double>>("input");
+    emp::vector<double> & output = GetTrait<emp::vector<double>>("output");
+    output.resize(6);
+    for (size_t i = 0; i < 6; ++i) {
+      output[i] = input[i] * (double) ((style + i) % 4) + (double) ((style * 7 + i * 3) % 6);
+    }
+  }
+};
 
+/// Build an EvalMancala module and a set of organisms (each with a different style) to play.
+struct MancalaSetup {
+  mabe::MABE control{0, nullptr};
+  emplode::Symbol_Scope root_scope{"root_scope", "desc", nullptr};
+  mabe::EvalMancala & eval;
+  mabe::OrganismManager<MancalaOrg> manager{control, "mancala_manager", "desc"};
+  emp::DataMap data_map;
+  emp::vector<emp::Ptr<MancalaOrg>> orgs;
+  emp::vector<emp::Ptr<mabe::Organism>> players;
 
-TEST_CASE("EvalMancala_Placeholder", "[evaluate/games]"){
+  MancalaSetup(const emp::String & opponent_type, size_t num_orgs)
+    : eval(GetConfiguredRef<mabe::EvalMancala>(control, "EvalMancala", "eval_mancala", root_scope))
   {
+    control.AddPopulation("test_pop");
+    control.GetRandom().ResetSeed(100);
+    eval.AsScope().GetSymbol("opponent_type")->SetString(opponent_type);
+    eval.AsScope().GetSymbol("num_opponents")->SetValue(3);
+
+    data_map = SetupTraits(control, [this](){
+      eval.SetupModule_Internal();
+      eval.SetupModule();
+      manager.AddSharedTrait<emp::vector<double>>("output", "Move preferences", {});
+    });
+    eval.SetupDataMap_Internal(data_map);
+    eval.SetupDataMap(data_map);
+
+    for (size_t i = 0; i < num_orgs; ++i) {
+      orgs.push_back(emp::NewPtr<MancalaOrg>(manager));
+      orgs.back()->style = i;
+      orgs.back()->SetDataMap(data_map);
+      players.push_back(orgs.back().Raw());
+    }
+  }
+  ~MancalaSetup() { for (auto org_ptr : orgs) org_ptr.Delete(); }
+
+  /// Evaluate all organisms with a given number of threads; return every organism's traits.
+  emp::vector<double> Evaluate(size_t num_threads, int seed) {
+    eval.AsScope().GetSymbol("num_threads")->SetValue((double) num_threads);
+    control.GetRandom().ResetSeed(seed);
+    eval.EvaluateTournament(players);
+    emp::vector<double> results;
+    for (auto org_ptr : orgs) {
+      for (const char * trait : {"scoreA", "scoreB", "num_errors", "fitness"}) {
+        results.push_back(org_ptr->GetTrait<double>(trait));
+      }
+    }
+    return results;
+  }
+
+  /// Check that no organism plays itself or plays twice in a round; return the matches played
+  /// by each organism.
+  emp::vector<size_t> CheckRounds(size_t num_orgs) {
+    const auto & schedule = eval.GetSchedule();
+    const auto & round_starts = eval.GetRoundStarts();
+    REQUIRE(round_starts.size() >= 1);
+    CHECK(round_starts.back() == schedule.size());
+    emp::vector<size_t> match_counts(num_orgs, 0);
+    for (size_t round = 0; round + 1 < round_starts.size(); ++round) {
+      emp::vector<bool> in_round(num_orgs, false);
+      for (size_t match_id = round_starts[round]; match_id < round_starts[round+1]; ++match_id) {
+        const auto & match = schedule[match_id];
+        REQUIRE(match.player0 < num_orgs);
+        REQUIRE(match.player1 < num_orgs);
+        CHECK(match.player0 != match.player1);
+        CHECK(!in_round[match.player0]);
+        CHECK(!in_round[match.player1]);
+        in_round[match.player0] = in_round[match.player1] = true;
+        ++match_counts[match.player0];
+        ++match_counts[match.player1];
+      }
+    }
+    return match_counts;
+  }
+};
+
+TEST_CASE("EvalMancala_RoundRobinSchedule", "[evaluate/games]"){
+  MancalaSetup setup("round_robin", 0);
+  for (size_t num_orgs = 0; num_orgs <= 9; ++num_orgs) {
+    setup.eval.BuildSchedule(num_orgs);
+    const size_t expected_matches = (num_orgs < 2) ? 0 : num_orgs * (num_orgs - 1) / 2;
+    CHECK(setup.eval.GetSchedule().size() == expected_matches);
+    if (num_orgs >= 2) {
+      // Circle method: one round per organism, minus one if the count is even.
+      CHECK(setup.eval.GetRoundStarts().size() == num_orgs - 1 + (num_orgs & 1) + 1);
+    }
+
+    // Every pair of organisms meets exactly once.
+    const emp::vector<size_t> match_counts = setup.CheckRounds(num_orgs);
+    std::set<std::pair<size_t,size_t>> pairs;
+    for (const auto & match : setup.eval.GetSchedule()) {
+      pairs.insert(std::minmax(match.player0, match.player1));
+    }
+    CHECK(pairs.size() == expected_matches);
+    for (size_t count : match_counts) CHECK(count == num_orgs - 1);
+  }
+}
+
+TEST_CASE("EvalMancala_RandomOrgSchedule", "[evaluate/games]"){
+  MancalaSetup setup("random_org", 0);
+  for (size_t num_orgs : {2, 6, 7, 11}) {
+    setup.eval.BuildSchedule(num_orgs);
+    const emp::vector<size_t> match_counts = setup.CheckRounds(num_orgs);
+    // Every organism faces at least num_opponents (3) others, even with an odd count.
+    for (size_t count : match_counts) CHECK(count >= 3);
+    const size_t extra_matches = (num_orgs & 1) ? 3 : 0;
+    CHECK(setup.eval.GetSchedule().size() == 3 * (num_orgs / 2) + extra_matches);
+  }
+}
+
+TEST_CASE("EvalMancala_ThreadCountIndependence", "[evaluate/games]"){
+  for (const char * opponent_type : {"round_robin", "random_org"}) {
+    MancalaSetup setup(opponent_type, 9);
+    const emp::vector<double> one_thread = setup.Evaluate(1, 5);
+    CHECK(setup.Evaluate(4, 5) == one_thread);
+    CHECK(setup.Evaluate(16, 5) == one_thread);
+
+    // Organisms did actually play.
+    double total_score = 0.0;
+    for (auto org_ptr : setup.orgs) total_score += org_ptr->GetTrait<double>("scoreA");
+    CHECK(total_score > 0.0);
   }
 }
@@ -888,3 +888,27 @@ TEST_CASE("EvalPathFollow_PathFollowEvaluator", "[evaluate/games]"){
     }
   }
 }
+
+TEST_CASE("EvalPathFollow_VisitedTiles", "[evaluate/games]"){
+  mabe::VisitedTiles visited;
+  visited.Resize(25);
+  CHECK(visited.GetSize() == 25);
+  for(size_t i = 0; i < 25; ++i) CHECK(!visited[i]);
+  visited.Set(3);
+  visited.Set(24);
+  CHECK(visited[3]);
+  CHECK(visited[24]);
+  CHECK(!visited[4]);
+  visited.Set(3, false);
+  CHECK(!visited[3]);
+  // Clearing advances the epoch; all previous marks should be gone
+  visited.Clear();
+  CHECK(!visited[24]);
+  visited.Set(7);
+  CHECK(visited[7]);
+  // Growing keeps old marks and adds unvisited tiles
+  visited.Resize(121);
+  CHECK(visited.GetSize() == 121);
+  CHECK(visited[7]);
+  CHECK(!visited[120]);
+}
@@ -0,0 +1,95 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file EvalFunction.cpp
+ *  @brief Test file for EvalFunction.hpp
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// Empirical tools
+#include "emp/base/vector.hpp"
+// MABE
+#include "evaluate/math/EvalFunction.hpp"
+#include "core/OrganismManager.hpp"
+
+/// Organism that always calculates 3*input1 + 4*input2, either one test case at a time or
+/// (if BATCH is set) for all test cases at once.
+template <bool BATCH>
+class LinearOrg : public mabe::OrganismTemplate<LinearOrg<BATCH>> {
+public:
+  size_t num_outputs = 0;   ///< How many times has GenerateOutput() been called?
+  size_t num_batches = 0;   ///< How many times has GenerateOutputBatch() been called?
+
+  LinearOrg(mabe::OrganismManager<LinearOrg> & manager)
+    : mabe::OrganismTemplate<LinearOrg>(manager) { }
+
+  struct ManagerData : public mabe::Organism::ManagerData { };
+
+  size_t Mutate(emp::Random &) override { return 0; }
+
+  void GenerateOutput() override {
+    ++num_outputs;
+    const double result = 3.0 * this->template GetTrait<double>("input1")
+                        + 4.0 * this->template GetTrait<double>("input2");
+    this->template SetTrait<double>("output", result);
+  }
+
+  bool GenerateOutputBatch(std::span<const double> inputs, size_t num_inputs,
+                           std::span<double> outputs) override {
+    if constexpr (!BATCH) return false;
+    ++num_batches;
+    REQUIRE(num_inputs == 2);
+    const size_t num_tests = outputs.size();
+    for (size_t test_id = 0; test_id < num_tests; ++test_id) {
+      outputs[test_id] = 3.0 * inputs[test_id] + 4.0 * inputs[num_tests + test_id];
+    }
+    return true;
+  }
+};
+
+TEST_CASE("EvalFunction_BatchMatchesFallback", "[evaluate/math]"){
+  using case_org_t = LinearOrg<false>;
+  using batch_org_t = LinearOrg<true>;
+
+  mabe::MABE control(0, nullptr);
+  control.AddPopulation("test_pop");
+  mabe::EvalFunction eval(control);   // Target is input1 * 3 + 5*input2 by default.
+  mabe::OrganismManager<case_org_t> case_manager(control, "case_manager");
+  mabe::OrganismManager<batch_org_t> batch_manager(control, "batch_manager");
+
+  control.GetTraitManager().Unlock();
+  eval.SetupModule();
+  case_manager.AddSharedTrait<double>("output", "Output value", 0.0);
+  batch_manager.AddSharedTrait<double>("output", "Output value", 0.0);
+  control.GetTraitManager().Lock();
+  emp::DataMap data_map = control.GetOrganismDataMap();
+  control.GetTraitManager().RegisterAll(data_map);
+  data_map.LockLayout();
+  eval.SetupDataMap(data_map);
+
+  case_org_t case_org(case_manager);
+  case_org.SetDataMap(data_map);
+  batch_org_t batch_org(batch_manager);
+  batch_org.SetDataMap(data_map);
+
+  // Default tests are input1 = 0..99 with input2 = 100..1, so each error is exactly input2.
+  const double case_fitness = eval.EvaluateOrg(case_org);
+  const double batch_fitness = eval.EvaluateOrg(batch_org);
+  CHECK(case_org.num_outputs == 100);
+  CHECK(batch_org.num_batches == 1);
+  CHECK(batch_org.num_outputs == 0);
+  CHECK(case_fitness == 100.0 - 5050.0);
+  CHECK(batch_fitness == case_fitness);
+  CHECK(batch_org.GetTrait<double>("fitness") == case_org.GetTrait<double>("fitness"));
+
+  std::span<double> case_errors = case_org.GetTrait<double>(data_map.GetID("errors"), 100);
+  std::span<double> batch_errors = batch_org.GetTrait<double>(data_map.GetID("errors"), 100);
+  for (size_t test_id = 0; test_id < 100; ++test_id) {
+    CHECK(batch_errors[test_id] == case_errors[test_id]);
+    CHECK(case_errors[test_id] == 100.0 - test_id);
+  }
+}
@@ -4,7 +4,7 @@
  *  @date 2019-2021.
  *
  *  @file EvalDiagnostic.cpp 
- *  @brief Placeholder test file for EvalDiagnostic.hpp 
+ *  @brief Test file for EvalDiagnostic.hpp 
  */
 
 // CATCH
@@ -20,3 +20,24 @@ TEST_CASE("EvalDiagnostic_Placeholder", "[evaluate/static]"){
   {
   }
 }
+
+TEST_CASE("EvalDiagnostic_BatchKernels", "[evaluate/static]"){
+  { // FindMaxPos should match emp::FindMaxIndex, including on ties.
+    emp::vector<double> vals = {3.0, 7.0, 1.0, 7.0, 2.0};
+    CHECK(mabe::EvalDiagnostic::FindMaxPos(vals.data(), vals.size()) == 1);
+    CHECK(mabe::EvalDiagnostic::FindMaxPos(vals.data(), vals.size()) == emp::FindMaxIndex(vals));
+    CHECK(mabe::EvalDiagnostic::FindMaxPos(vals.data() + 2, 3) == 1);
+  }
+  { // FindDescentEnd should stop at the first value larger than its predecessor.
+    emp::vector<double> vals = {5.0, 4.0, 4.0, 2.0, 3.0, 1.0};
+    CHECK(mabe::EvalDiagnostic::FindDescentEnd(vals.data(), 0, vals.size()) == 4);
+    CHECK(mabe::EvalDiagnostic::FindDescentEnd(vals.data(), 4, vals.size()) == 6);
+    CHECK(mabe::EvalDiagnostic::FindDescentEnd(vals.data(), 5, vals.size()) == 6);
+  }
+  { // CopyActive should copy only the active range and zero the rest.
+    emp::vector<double> vals = {1.0, 2.0, 3.0, 4.0, 5.0};
+    emp::vector<double> scores(vals.size(), -1.0);
+    mabe::EvalDiagnostic::CopyActive(vals.data(), scores.data(), 1, 3, vals.size());
+    CHECK(scores == emp::vector<double>{0.0, 2.0, 3.0, 0.0, 0.0});
+  }
+}
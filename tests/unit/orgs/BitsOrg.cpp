@@ -1,10 +1,10 @@
 /**
  *  @note This file is part of MABE, https://github.com/mercere99/MABE2
  *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
- *  @date 2019-2021.
+ *  @date 2019-2024.
  *
  *  @file  BitsOrg.cpp
- *  @brief TODO. Currently this is a placeholder so codecov will see the untested source code
+ *  @brief Tests for BitsOrg.hpp
  */
 
 // CATCH
@@ -13,5 +13,39 @@
 // MABE
 #include "orgs/BitsOrg.hpp"
 
+TEST_CASE("BitsOrg_Mutate", "[orgs]"){
+  mabe::MABE control(0, nullptr);
+  control.GetRandom().ResetSeed(100);
+  mabe::OrganismManager<mabe::BitsOrg> manager(control, "bits_manager", "desc");
+  manager.GetManagedData().mut_prob = 0.2;
+  manager.GetManagedData().init_random = false;
 
-TEST_CASE("BitsOrg_Placeholder", "[core]"){ ; }
+  control.GetTraitManager().Unlock();
+  manager.SetupModule();
+  control.GetTraitManager().Lock();
+  emp::DataMap data_map = control.GetOrganismDataMap();
+  control.GetTraitManager().RegisterAll(data_map);
+  data_map.LockLayout();
+  manager.SetupDataMap(data_map);
+
+  mabe::BitsOrg org(manager);
+  org.SetDataMap(data_map);
+  org.Initialize(control.GetRandom());
+  const emp::BitVector & bits = org.GetTrait<emp::BitVector>("bits");
+  CHECK(bits.size() == 100);
+  CHECK(bits.CountOnes() == 0);
+
+  // Mutations must show up directly in the output trait; each site mutates at most once.
+  size_t total_muts = 0;
+  while (total_muts == 0) {
+    total_muts = org.Mutate(control.GetRandom());
+    CHECK(bits.CountOnes() == total_muts);
+  }
+  CHECK(org.ToString() == emp::MakeString(bits));
+
+  // Offspring get their own copy of the bits.
+  auto offspring = org.CloneOrganism();
+  offspring->Mutate(control.GetRandom());
+  CHECK(bits.CountOnes() == total_muts);
+  offspring.Delete();
+}
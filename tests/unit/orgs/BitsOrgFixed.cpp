@@ -0,0 +1,124 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  BitsOrgFixed.cpp
+ *  @brief Tests for BitsOrgFixed.hpp
+ */
+
+#include <bit>
+#include <sstream>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "orgs/BitsOrg.hpp"
+#include "orgs/BitsOrgFixed.hpp"
+#include "tools/NK.hpp"
+// Test helpers
+#include "../SetupHelpers.hpp"
+
+/// Build a manager and DataMap for 100-bit organisms.
+struct BitsOrgFixedSetup : public ManagerSetup<mabe::BitsOrgFixed<100>> {
+  BitsOrgFixedSetup(double mut_prob, bool init_random)
+    : ManagerSetup([mut_prob, init_random](auto & data){
+        data.mut_prob = mut_prob;
+        data.init_random = init_random;
+      }) { }
+
+  /// The bits trait as stored, without building it.
+  const emp::BitVector & StoredBits(mabe::Organism & org) {
+    return org.GetDataMap().Get<emp::BitVector>(data_map.GetID("bits"));
+  }
+};
+
+TEST_CASE("BitsOrgFixed_Mutate", "[orgs]"){
+  BitsOrgFixedSetup setup(0.2, false);
+  mabe::BitsOrgFixed<100> org(setup.manager);
+  org.SetDataMap(setup.data_map);
+  org.Initialize(setup.control.GetRandom());
+
+  // The bits trait is only built when read.
+  CHECK(setup.StoredBits(org).size() == 0);
+  CHECK(org.GetTrait<emp::BitVector>("bits").size() == 100);
+  CHECK(org.GetTrait<emp::BitVector>("bits").CountOnes() == 0);
+
+  // Each site mutates at most once, and mutations show up in the bits trait when it is read.
+  size_t total_muts = 0;
+  while (total_muts == 0) total_muts = org.Mutate(setup.control.GetRandom());
+  size_t num_ones = 0;
+  for (uint64_t word : org.GetBitWords().words) num_ones += (size_t) std::popcount(word);
+  CHECK(num_ones == total_muts);
+  CHECK(org.GetTrait<emp::BitVector>("bits").CountOnes() == total_muts);
+  CHECK(org.ToString() == emp::MakeString(org.GetTrait<emp::BitVector>("bits")));
+
+  // Copies (e.g., offspring) keep the bits, and rebuild the trait only if it is out of date.
+  mabe::BitsOrgFixed<100> copy_org(org);
+  copy_org.Mutate(setup.control.GetRandom());
+  mabe::BitsOrgFixed<100> child(copy_org);
+  CHECK(child.GetTrait<emp::BitVector>("bits") == copy_org.GetTrait<emp::BitVector>("bits"));
+}
+
+TEST_CASE("BitsOrgFixed_GetBitWords", "[orgs]"){
+  BitsOrgFixedSetup setup(0.0, true);
+  mabe::BitsOrgFixed<100> org(setup.manager);
+  org.SetDataMap(setup.data_map);
+  org.Initialize(setup.control.GetRandom());
+
+  const mabe::BitWords bit_words = org.GetBitWords();
+  REQUIRE(bit_words.words.size() == 2);
+  CHECK(bit_words.num_bits == 100);
+  CHECK(bit_words.trait_id == setup.data_map.GetID("bits"));
+  CHECK((bit_words.words[1] >> 36) == 0);   // Unused bits stay clear.
+
+  // Bit 0 is the low bit of the first word.
+  const emp::BitVector & bits = org.GetTrait<emp::BitVector>("bits");
+  for (size_t pos = 0; pos < 100; ++pos) {
+    CHECK(bits.Get(pos) == (bool) ((bit_words.words[pos / 64] >> (pos % 64)) & 1));
+  }
+}
+
+TEST_CASE("BitsOrgFixed_NK", "[orgs]"){
+  // Scoring the packed words must match scoring the bits trait.
+  BitsOrgFixedSetup setup(0.0, true);
+  mabe::NKLandscape landscape(100, 3, setup.control.GetRandom());
+  for (size_t i = 0; i < 20; ++i) {
+    mabe::BitsOrgFixed<100> org(setup.manager);
+    org.SetDataMap(setup.data_map);
+    org.Initialize(setup.control.GetRandom());
+    const emp::BitVector & bits = org.GetTrait<emp::BitVector>("bits");
+    CHECK(landscape.GetFitness(org.GetBitWords().words) == Approx(landscape.GetFitness(bits)));
+  }
+}
+
+TEST_CASE("BitsOrgFixed_GenomeIO", "[orgs]"){
+  BitsOrgFixedSetup setup(0.0, true);
+  mabe::BitsOrgFixed<100> org(setup.manager), loaded(setup.manager);
+  org.SetDataMap(setup.data_map);
+  loaded.SetDataMap(setup.data_map);
+  org.Initialize(setup.control.GetRandom());
+
+  std::stringstream ss;
+  CHECK(org.WriteGenome(ss));
+  const std::string genome = ss.str();
+  CHECK(genome.size() == sizeof(uint64_t) + 13);
+  CHECK(loaded.ReadGenome(ss));
+  CHECK(loaded.GetBitWords().words[0] == org.GetBitWords().words[0]);
+  CHECK(loaded.GetBitWords().words[1] == org.GetBitWords().words[1]);
+  CHECK(loaded.GetTrait<emp::BitVector>("bits") == org.GetTrait<emp::BitVector>("bits"));
+
+  // The format matches BitsOrg, so the same genome loads into a BitsOrg.
+  ManagerSetup<mabe::BitsOrg> bits_setup;
+  mabe::BitsOrg bits_org(bits_setup.manager);
+  bits_org.SetDataMap(bits_setup.data_map);
+  std::stringstream bits_ss(genome);
+  CHECK(bits_org.ReadGenome(bits_ss));
+  CHECK(bits_org.GetTrait<emp::BitVector>("bits") == org.GetTrait<emp::BitVector>("bits"));
+
+  // ...and back again.
+  std::stringstream back_ss;
+  CHECK(bits_org.WriteGenome(back_ss));
+  CHECK(back_ss.str() == genome);
+}
@@ -0,0 +1,248 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  SimpleProgramOrg.cpp
+ *  @brief Tests for SimpleProgramOrg.hpp, plus a (hidden) instruction-rate benchmark.
+ *
+ *  The benchmark compares instructions per second against AvidaGPOrg and VirtualCPUOrg; it only
+ *  runs when requested (e.g., "make bench-SimpleProgramOrg", which builds with optimizations).
+ */
+
+#include <array>
+#include <chrono>
+#include <iostream>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// MABE
+#include "orgs/AvidaGPOrg.hpp"
+#include "orgs/SimpleProgramOrg.hpp"
+#include "orgs/VirtualCPUOrg.hpp"
+#include "orgs/instructions/VirtualCPU_Inst_IO.hpp"
+#include "orgs/instructions/VirtualCPU_Inst_Nop.hpp"
+// Test helpers
+#include "../SetupHelpers.hpp"
+
+/// Give tests direct control over the program and CPU.
+class ProgramTester : public mabe::SimpleProgramOrg {
+public:
+  using mabe::SimpleProgramOrg::SimpleProgramOrg;
+  using mabe::SimpleProgramOrg::Inst;
+  using mabe::SimpleProgramOrg::GetCPUState;
+  using mabe::SimpleProgramOrg::Process;
+  using line_t = std::array<unsigned char, INST_BYTES>;
+
+  /// Load a program; any remaining positions are filled with BREAK (which halts the program).
+  void SetProgram(const emp::vector<line_t> & program) {
+    REQUIRE(program.size() <= GENOME_SIZE);
+    for (size_t pos = 0; pos < GENOME_SIZE; ++pos) {
+      const line_t line = (pos < program.size()) ? program[pos]
+                                                 : line_t{ (unsigned char) Inst::BREAK, 0, 0, 0 };
+      std::copy(line.begin(), line.end(), genome.begin() + pos * INST_BYTES);
+    }
+    PreprocessScopes();
+  }
+
+  /// Run the current program from scratch; return how many instructions were executed.
+  size_t Run(size_t num_steps) {
+    CPUState & cpu = GetCPUState();
+    cpu.Reset();
+    return Process(cpu, num_steps);
+  }
+};
+
+/// Build a manager and DataMap for SimpleProgramOrg.
+struct ProgramSetup : public ManagerSetup<mabe::SimpleProgramOrg> {
+  ProgramSetup() : ManagerSetup([](auto & data){ data.init_random = false; }) { }
+
+  /// Run an organism on the given inputs and return its first output value.
+  double RunOutput(ProgramTester & org, const emp::vector<double> & inputs) {
+    org.SetTrait<emp::vector<double>>("input", inputs);
+    org.GenerateOutput();
+    const emp::vector<double> & outputs = org.GetTrait<emp::vector<double>>("output");
+    REQUIRE(outputs.size() == 16);
+    return outputs[0];
+  }
+};
+
+// Registers A-J are arguments 0-9; argument 12 reads input memory and 14 writes output memory.
+// Constant arguments 5-8 are 1.0, 2.0, 3.0, and 4.0.
+using Inst = ProgramTester::Inst;
+constexpr unsigned char A = 0, B = 1, IN = 12, OUT = 14;
+constexpr auto Op = [](Inst inst) { return (unsigned char) inst; };
+
+TEST_CASE("SimpleProgramOrg_Setup", "[orgs]"){
+  ProgramSetup setup;
+  // Trait IDs are resolved before any organism runs.
+  CHECK(setup.manager.GetManagedData().input_id == setup.data_map.GetID("input"));
+  CHECK(setup.manager.GetManagedData().output_id == setup.data_map.GetID("output"));
+
+  // Randomized and mutated genomes only ever hold valid instructions.
+  setup.manager.GetManagedData().mut_prob = 0.5;
+  mabe::SimpleProgramOrg org(setup.manager);
+  org.SetDataMap(setup.data_map);
+  org.Randomize(setup.control.GetRandom());
+  CHECK(org.ToString().find("Unknown") == std::string::npos);
+  const std::string orig_genome = org.ToString();
+  CHECK(org.Mutate(setup.control.GetRandom()) > 0);
+  CHECK(org.ToString() != orig_genome);
+  CHECK(org.ToString().find("Unknown") == std::string::npos);
+}
+
+TEST_CASE("SimpleProgramOrg_Math", "[orgs]"){
+  ProgramSetup setup;
+  ProgramTester org(setup.manager);
+  org.SetDataMap(setup.data_map);
+
+  org.SetProgram({ {Op(Inst::GET_CONST), A, 7, 0},       // A = 3
+                   {Op(Inst::MULT_CONST), A, 6, 0},      // A *= 2
+                   {Op(Inst::COPY), A, OUT, 0} });       // Output A
+  CHECK(setup.RunOutput(org, {}) == 6.0);
+  CHECK(org.Run(100) == 4);                              // Three instructions, then BREAK.
+
+  // Double the first input.
+  org.SetProgram({ {Op(Inst::COPY), IN, B, 0},
+                   {Op(Inst::ADD), B, B, OUT} });
+  CHECK(setup.RunOutput(org, {5.0}) == 10.0);
+  CHECK(setup.RunOutput(org, {-1.5}) == -3.0);
+}
+
+TEST_CASE("SimpleProgramOrg_Scopes", "[orgs]"){
+  ProgramSetup setup;
+  ProgramTester org(setup.manager);
+  org.SetDataMap(setup.data_map);
+
+  // COUNTDOWN repeats its scope (closed by SET_SCOPE) until the counter reaches zero.
+  org.SetProgram({ {Op(Inst::GET_CONST), B, 8, 0},       // B = 4
+                   {Op(Inst::COUNTDOWN), 1, B, 0},
+                   {Op(Inst::ADD_CONST), A, 5, 0},       //   A += 1
+                   {Op(Inst::SET_SCOPE), 1, 0, 0},
+                   {Op(Inst::COPY), A, OUT, 0} });
+  CHECK(setup.RunOutput(org, {}) == 4.0);
+
+  // IF skips its scope when its test is zero...
+  org.SetProgram({ {Op(Inst::GET_CONST), A, 5, 0},       // A = 1
+                   {Op(Inst::IF), 1, B, 0},              // B is 0
+                   {Op(Inst::GET_CONST), A, 15, 0},      //   A = 512
+                   {Op(Inst::SET_SCOPE), 1, 0, 0},
+                   {Op(Inst::COPY), A, OUT, 0} });
+  CHECK(setup.RunOutput(org, {}) == 1.0);
+
+  // ...and runs it otherwise.
+  org.SetProgram({ {Op(Inst::GET_CONST), B, 5, 0},       // B = 1
+                   {Op(Inst::IF), 1, B, 0},
+                   {Op(Inst::GET_CONST), A, 15, 0},      //   A = 512
+                   {Op(Inst::SET_SCOPE), 1, 0, 0},
+                   {Op(Inst::COPY), A, OUT, 0} });
+  CHECK(setup.RunOutput(org, {}) == 512.0);
+
+  // BREAK leaves the innermost loop (skipping any IF), or halts outside of one.
+  org.SetProgram({ {Op(Inst::GET_CONST), B, 5, 0},       // B = 1
+                   {Op(Inst::WHILE), 1, B, 0},           // Would loop forever...
+                   {Op(Inst::ADD_CONST), A, 6, 0},       //   A += 2
+                   {Op(Inst::IF), 2, B, 0},
+                   {Op(Inst::BREAK), 0, 0, 0},           //     ...but leaves the loop here.
+                   {Op(Inst::SET_SCOPE), 1, 0, 0},
+                   {Op(Inst::COPY), A, OUT, 0} });
+  CHECK(setup.RunOutput(org, {}) == 2.0);
+  CHECK(org.Run(1000) == 8);
+}
+
+// Benchmark: how many instructions per second does each program-based organism execute?
+
+/// Expose the AvidaGP hardware so that it can be run directly.
+class AvidaGPTester : public mabe::AvidaGPOrg {
+public:
+  using mabe::AvidaGPOrg::AvidaGPOrg;
+  using mabe::AvidaGPOrg::hardware;
+};
+
+/// Time RUN_FUN (which should execute about num_insts instructions and return how many it did).
+template <typename RUN_FUN>
+void ReportInstRate(const std::string & org_type, size_t num_insts, RUN_FUN && run_fun) {
+  const auto start_time = std::chrono::steady_clock::now();
+  const size_t insts_run = run_fun(num_insts);
+  const std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start_time;
+  std::cout << org_type << ": " << insts_run << " instructions in " << secs.count()
+            << " seconds (" << (insts_run / secs.count()) << " instructions/sec)" << std::endl;
+  CHECK(insts_run >= num_insts);
+}
+
+TEST_CASE("SimpleProgramOrg_Benchmark", "[.benchmark]"){
+  constexpr size_t NUM_INSTS = 10000000;
+  constexpr size_t NUM_GENOMES = 100;
+
+  { // SimpleProgramOrg: random programs, restarted whenever one halts.
+    ProgramSetup setup;
+    emp::vector<emp::Ptr<ProgramTester>> orgs;
+    for (size_t i = 0; i < NUM_GENOMES; ++i) {
+      orgs.push_back(emp::NewPtr<ProgramTester>(setup.manager));
+      orgs.back()->Randomize(setup.control.GetRandom());
+    }
+    ReportInstRate("SimpleProgramOrg", NUM_INSTS, [&orgs](size_t num_insts){
+      size_t total = 0;
+      for (size_t i = 0; total < num_insts; i = (i + 1) % orgs.size()) {
+        total += orgs[i]->Run(num_insts / orgs.size());
+      }
+      return total;
+    });
+    for (auto org_ptr : orgs) org_ptr.Delete();
+  }
+
+  { // AvidaGPOrg: random 64-instruction genomes.
+    mabe::MABE control(0, nullptr);
+    control.GetRandom().ResetSeed(100);
+    mabe::OrganismManager<mabe::AvidaGPOrg> manager(control, "avida_manager", "desc");
+    emp::vector<emp::Ptr<AvidaGPTester>> orgs;
+    for (size_t i = 0; i < NUM_GENOMES; ++i) {
+      orgs.push_back(emp::NewPtr<AvidaGPTester>(manager));
+      orgs.back()->hardware.PushDefaultInst(64);
+      orgs.back()->Randomize(control.GetRandom());
+    }
+    ReportInstRate("AvidaGPOrg", NUM_INSTS, [&orgs](size_t num_insts){
+      const size_t insts_per_org = num_insts / orgs.size();
+      for (auto org_ptr : orgs) {
+        org_ptr->hardware.ResetHardware();
+        org_ptr->hardware.Process(insts_per_org);
+      }
+      return insts_per_org * orgs.size();
+    });
+    for (auto org_ptr : orgs) org_ptr.Delete();
+  }
+
+  { // VirtualCPUOrg: random 100-instruction genomes from the test instruction set.
+    mabe::MABE control(0, nullptr);
+    control.GetRandom().ResetSeed(100);
+    control.AddPopulation("test_pop", 0);
+    mabe::OrganismManager<mabe::VirtualCPUOrg> manager(control, "vcpu_manager", "desc");
+    emplode::Symbol_Scope root_scope("root_scope", "desc", nullptr);
+    mabe::VirtualCPU_Inst_Nop& nop_inst_module =
+        GetConfiguredRef<mabe::VirtualCPU_Inst_Nop>(
+          control, "VirtualCPU_Inst_Nop", "insts_nop", root_scope);
+    mabe::VirtualCPU_Inst_IO& io_inst_module =
+        GetConfiguredRef<mabe::VirtualCPU_Inst_IO>(
+            control, "VirtualCPU_Inst_IO", "insts_io", root_scope);
+    manager.GetManagedData().inst_set_input_filename = "inst_set_test.txt";
+    emp::DataMap data_map = SetupManager(control, manager, nop_inst_module, io_inst_module);
+
+    emp::vector<emp::Ptr<mabe::VirtualCPUOrg>> orgs;
+    for (size_t i = 0; i < NUM_GENOMES; ++i) {
+      orgs.push_back(emp::NewPtr<mabe::VirtualCPUOrg>(manager));
+      orgs.back()->SetupMutationDistribution();
+      orgs.back()->SetDataMap(data_map);
+      orgs.back()->Initialize(control.GetRandom());
+    }
+    ReportInstRate("VirtualCPUOrg", NUM_INSTS, [&orgs](size_t num_insts){
+      const size_t insts_per_org = num_insts / orgs.size();
+      for (auto org_ptr : orgs) {
+        org_ptr->ResetHardware();
+        for (size_t step = 0; step < insts_per_org; ++step) org_ptr->ProcessStep();
+      }
+      return insts_per_org * orgs.size();
+    });
+    for (auto org_ptr : orgs) org_ptr.Delete();
+  }
+}
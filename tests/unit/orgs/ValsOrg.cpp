@@ -1,10 +1,10 @@
 /**
  *  @note This file is part of MABE, https://github.com/mercere99/MABE2
  *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
- *  @date 2019-2021.
+ *  @date 2019-2024.
  *
  *  @file  ValsOrg.cpp
- *  @brief TODO. Currently this is a placeholder so codecov will see the untested source code
+ *  @brief Tests for ValsOrg.hpp
  */
 
 // CATCH
@@ -12,6 +12,129 @@
 #include "catch.hpp"
 // MABE
 #include "orgs/ValsOrg.hpp"
+// Test helpers
+#include "../SetupHelpers.hpp"
 
+/// Build a manager and DataMap for ValsOrg with a given mutation rate.
+struct ValsOrgSetup : public ManagerSetup<mabe::ValsOrg> {
+  ValsOrgSetup(double mut_prob)
+    : ManagerSetup([mut_prob](auto & data){
+        data.mut_prob = mut_prob;
+        data.init_random = false;
+      }) { }
 
-TEST_CASE("ValsOrg_Placeholder", "[core]"){ ; }
+  std::span<double> Vals(mabe::ValsOrg & org) {
+    return org.GetTrait<double>(data_map.GetID("vals"), 100);
+  }
+  double Total(mabe::ValsOrg & org) { return org.GetTrait<double>("total"); }
+};
+
+TEST_CASE("ValsOrg_Mutate", "[orgs]"){
+  ValsOrgSetup setup(0.05);
+  mabe::ValsOrg org(setup.manager);
+  org.SetDataMap(setup.data_map);
+  org.Initialize(setup.control.GetRandom());
+  CHECK(setup.Total(org) == 0.0);
+
+  // Mutations must show up directly in the genome trait, with the total kept up to date.
+  size_t total_muts = 0;
+  while (total_muts == 0) total_muts = org.Mutate(setup.control.GetRandom());
+  std::span<double> vals = setup.Vals(org);
+  size_t num_changed = 0;
+  double total = 0.0;
+  for (double val : vals) {
+    num_changed += (val != 0.0);
+    total += val;
+    CHECK(val >= 0.0);     // Values below zero rebound back into range.
+    CHECK(val <= 100.0);
+  }
+  CHECK(num_changed == total_muts);
+  CHECK(setup.Total(org) == Approx(total));
+}
+
+TEST_CASE("ValsOrg_ApplyBounds", "[orgs]"){
+  using data_t = mabe::ValsOrg::ManagerData;
+  const emp::vector<mabe::ValsOrg::BoundType> policies = {
+    mabe::ValsOrg::LIMIT_NONE, mabe::ValsOrg::LIMIT_CLAMP,
+    mabe::ValsOrg::LIMIT_WRAP, mabe::ValsOrg::LIMIT_REBOUND
+  };
+  const emp::vector<double> test_vals = {-250.0, -30.0, -0.5, 0.0, 50.0, 100.0, 100.5, 130.0, 350.0};
+
+  // The single-value version (used for sparse mutations) and the span version (used for dense
+  // mutations) must agree for every combination of policies.
+  for (auto upper : policies) {
+    for (auto lower : policies) {
+      data_t data;
+      data.upper_bound = upper;
+      data.lower_bound = lower;
+      emp::vector<double> span_vals = test_vals;
+      data.ApplyBounds(std::span<double>(span_vals.data(), span_vals.size()));
+      for (size_t i = 0; i < test_vals.size(); ++i) {
+        double value = test_vals[i];
+        data.ApplyBounds(value);
+        CHECK(value == span_vals[i]);
+        if (test_vals[i] >= 0.0 && test_vals[i] <= 100.0) CHECK(value == test_vals[i]);
+      }
+    }
+  }
+
+  // Spot check each policy.
+  data_t data;
+  double value = 103.0;
+  data.upper_bound = mabe::ValsOrg::LIMIT_CLAMP;   data.ApplyBounds(value); CHECK(value == 100.0);
+  value = 103.0;
+  data.upper_bound = mabe::ValsOrg::LIMIT_WRAP;    data.ApplyBounds(value); CHECK(value == 3.0);
+  value = 103.0;
+  data.upper_bound = mabe::ValsOrg::LIMIT_REBOUND; data.ApplyBounds(value); CHECK(value == 97.0);
+
+  // Rebounding far past the top must still be brought back up by the lower limit.
+  value = 250.0;
+  data.ApplyBounds(value);
+  CHECK(value == 50.0);
+}
+
+TEST_CASE("ValsOrg_MutateDenseAndSparse", "[orgs]"){
+  // Mutation rates on either side of the dense threshold must keep values in range and keep
+  // the total trait up to date.
+  for (double mut_prob : {0.05, 0.5}) {
+    ValsOrgSetup setup(mut_prob);
+    mabe::ValsOrg org(setup.manager);
+    org.SetDataMap(setup.data_map);
+    org.Initialize(setup.control.GetRandom());
+    size_t total_muts = 0;
+    for (size_t i = 0; i < 50; ++i) total_muts += org.Mutate(setup.control.GetRandom());
+    CHECK(total_muts > 0);
+
+    double total = 0.0;
+    for (double val : setup.Vals(org)) {
+      CHECK(val >= 0.0);
+      CHECK(val <= 100.0);
+      total += val;
+    }
+    CHECK(setup.Total(org) == Approx(total));
+  }
+}
+
+TEST_CASE("ValsOrg_MutateBoundsOnlyMutatedSites", "[orgs]"){
+  // Both mutation paths bound only the sites they change; other values are left as they are,
+  // even if they are out of range.
+  for (double mut_prob : {0.05, 0.5}) {
+    ValsOrgSetup setup(mut_prob);
+    mabe::ValsOrg org(setup.manager);
+    org.SetDataMap(setup.data_map);
+    org.Initialize(setup.control.GetRandom());
+    std::span<double> vals = setup.Vals(org);
+    for (double & val : vals) val = 100.5;  // Just out of range.
+
+    const size_t num_muts = org.Mutate(setup.control.GetRandom());
+    size_t num_in_range = 0;
+    for (double val : vals) {
+      if (val != 100.5) {
+        CHECK(val >= 0.0);
+        CHECK(val <= 100.0);
+        ++num_in_range;
+      }
+    }
+    CHECK(num_in_range == num_muts);
+  }
+}
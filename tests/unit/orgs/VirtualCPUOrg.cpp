@@ -11,9 +11,15 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 // MABE
+#include "core/DeferredActions.hpp"
 #include "orgs/VirtualCPUOrg.hpp"
 #include "orgs/instructions/VirtualCPU_Inst_Nop.hpp"
 #include "orgs/instructions/VirtualCPU_Inst_IO.hpp"
+#include "orgs/instructions/VirtualCPU_Inst_Math.hpp"
+#include "orgs/instructions/VirtualCPU_Inst_Replication.hpp"
+#include "select/SchedulerProbabilistic.hpp"
+// Test helpers
+#include "../SetupHelpers.hpp"
 
 //
 // TODO
@@ -32,17 +38,6 @@
 //    [ ] Insertion
 //    [ ] Deletion
 
-template<typename T>
-T& GetConfiguredRef(
-    mabe::MABE& control, 
-    const std::string& type_name, 
-    const std::string& var_name, 
-    emplode::Symbol_Scope& scope){
-  emplode::Symbol_Object& symbol_obj = 
-      control.GetConfigScript().GetSymbolTable().MakeObjSymbol(type_name, var_name, scope);
-  return *dynamic_cast<T*>(symbol_obj.GetObjectPtr().Raw());
-}
-
 TEST_CASE("VirtualCPUOrg_Main", "[orgs]"){
   // Initialize the instruction library, which only needs done once
   mabe::MABE control(0, nullptr);
@@ -391,3 +386,311 @@ TEST_CASE("VirtualCPUOrg_Main", "[orgs]"){
   }
   */
 }
+
+/// Expose the search cache so that tests can drive it with a known search function.
+class SearchCacheOrg : public mabe::VirtualCPUOrg {
+public:
+  using mabe::VirtualCPUOrg::VirtualCPUOrg;
+  using mabe::VirtualCPUOrg::CachedSearch;
+  using mabe::VirtualCPUOrg::GetSearchType;
+};
+
+TEST_CASE("VirtualCPUOrg_SearchCache", "[orgs]"){
+  mabe::MABE control(0, nullptr);
+  control.GetRandom().ResetSeed(110);
+  control.AddPopulation("test_pop", 0);
+  mabe::OrganismManager<mabe::VirtualCPUOrg> manager(control, "name", "desc");
+  emplode::Symbol_Scope root_scope("root_scope", "desc", nullptr);
+  mabe::VirtualCPU_Inst_Nop& nop_inst_module = 
+      GetConfiguredRef<mabe::VirtualCPU_Inst_Nop>(
+        control, "VirtualCPU_Inst_Nop", "insts_nop", root_scope); 
+  mabe::VirtualCPU_Inst_IO& io_inst_module = 
+      GetConfiguredRef<mabe::VirtualCPU_Inst_IO>(
+          control, "VirtualCPU_Inst_IO", "insts_io", root_scope); 
+  SearchCacheOrg org(manager);
+  org.SharedData().inst_set_input_filename = "inst_set_test.txt";
+  org.SharedData().init_random = false;
+  org.SharedData().initial_genome_filename = "org_nops.org";
+  control.GetTraitManager().Unlock();
+  nop_inst_module.SetupModule();
+  io_inst_module.SetupModule();
+  org.SetupModule();
+  control.GetTraitManager().Lock();
+  emp::DataMap data_map = control.GetOrganismDataMap();
+  control.GetTraitManager().RegisterAll(data_map);
+  data_map.LockLayout();          
+  org.SetupMutationDistribution();
+  org.SetDataMap(data_map);
+  org.Initialize(control.GetRandom());
+  REQUIRE(org.GetGenomeSize() == 50);
+
+  // Give every instruction a known nop sequence: only the search at 10 has nops (10-12).
+  for (auto & inst : org.genome_working) inst.nop_vec.resize(0);
+  org.genome_working[10].nop_vec.push_back(0);
+  org.genome_working[10].nop_vec.push_back(1);
+  org.inst_ptr = 10;
+
+  size_t num_searches = 0;
+  auto Search = [&org, &num_searches](bool reverse, size_t found_pos){
+    return org.CachedSearch(true, reverse, SearchCacheOrg::GetSearchType(false, true, reverse),
+      [&num_searches, found_pos](){ ++num_searches; return found_pos; });
+  };
+
+  { // Forward search from 10 that matches at 20 depends on positions 10 through 20.
+    CHECK(Search(false, 20) == 20);
+    CHECK(Search(false, 20) == 20);
+    CHECK(num_searches == 1);
+    org.InstCopied(0, 30);   // Past the match.
+    org.InstCopied(0, 5);    // Before the search.
+    CHECK(Search(false, 20) == 20);
+    CHECK(num_searches == 1);
+    org.InstCopied(0, 15);   // Between the search and the match.
+    CHECK(Search(false, 20) == 20);
+    CHECK(num_searches == 2);
+    org.InstCopied(0, 20);   // On the match itself.
+    CHECK(Search(false, 20) == 20);
+    CHECK(num_searches == 3);
+  }
+  { // Reverse search from 10 that matches at 5 depends on 5 through 10, plus the nops to 12.
+    num_searches = 0;
+    CHECK(Search(true, 5) == 5);
+    org.InstCopied(0, 4);
+    org.InstCopied(0, 13);
+    CHECK(Search(true, 5) == 5);
+    CHECK(num_searches == 1);
+    org.InstCopied(0, 12);   // Changes the nops being searched for.
+    CHECK(Search(true, 5) == 5);
+    CHECK(num_searches == 2);
+    // Forward and reverse results are cached separately.
+    CHECK(Search(false, 20) == 20);
+    CHECK(Search(true, 5) == 5);
+    CHECK(num_searches == 3);
+  }
+  { // A search that wraps around only depends on positions it scanned.
+    num_searches = 0;
+    org.inst_ptr = 45;
+    org.genome_working[45].nop_vec.push_back(2);
+    CHECK(Search(false, 3) == 3);   // Depends on 45 through 49 and 0 through 3.
+    org.InstCopied(0, 20);
+    CHECK(Search(false, 3) == 3);
+    CHECK(num_searches == 1);
+    org.InstCopied(0, 2);
+    CHECK(Search(false, 3) == 3);
+    CHECK(num_searches == 2);
+  }
+  { // A failed search (result is the search itself) depends on the whole genome.
+    num_searches = 0;
+    org.inst_ptr = 10;
+    CHECK(Search(false, 10) == 10);
+    CHECK(Search(false, 10) == 10);
+    CHECK(num_searches == 1);
+    org.InstCopied(0, 40);
+    CHECK(Search(false, 10) == 10);
+    CHECK(num_searches == 2);
+  }
+  { // Resizing the working genome clears all results.
+    num_searches = 0;
+    CHECK(Search(true, 5) == 5);    // Still cached from above.
+    CHECK(num_searches == 0);
+    org.genome_working.resize(60, org.genome_working[0]);
+    org.WorkingGenomeResized();
+    CHECK(Search(true, 5) == 5);
+    CHECK(num_searches == 1);
+  }
+}
+
+/// A VirtualCPUOrg manager with nop and IO instructions, and an organism whose genome is 50
+/// nops (from org_nops.org).  Mutations are turned off.
+struct NopOrgSetup {
+  mabe::MABE control{0, nullptr};
+  mabe::OrganismManager<mabe::VirtualCPUOrg> manager{control, "name", "desc"};
+  emplode::Symbol_Scope root_scope{"root_scope", "desc", nullptr};
+  emp::DataMap data_map;
+  emp::Ptr<mabe::VirtualCPUOrg> org_ptr;
+
+  NopOrgSetup(bool fast_inst_dispatch=true) {
+    control.AddPopulation("test_pop", 0);
+    mabe::VirtualCPU_Inst_Nop& nop_inst_module = 
+        GetConfiguredRef<mabe::VirtualCPU_Inst_Nop>(
+          control, "VirtualCPU_Inst_Nop", "insts_nop", root_scope); 
+    mabe::VirtualCPU_Inst_IO& io_inst_module = 
+        GetConfiguredRef<mabe::VirtualCPU_Inst_IO>(
+            control, "VirtualCPU_Inst_IO", "insts_io", root_scope); 
+    auto & data = manager.GetManagedData();
+    data.inst_set_input_filename = "inst_set_test.txt";
+    data.init_random = false;
+    data.initial_genome_filename = "org_nops.org";
+    data.fast_inst_dispatch = fast_inst_dispatch;
+    data.point_mut_prob = 0.0;
+    data.insertion_mut_prob = 0.0;
+    data.deletion_mut_prob = 0.0;
+    data_map = SetupManager(control, manager, nop_inst_module, io_inst_module);
+    org_ptr = emp::NewPtr<mabe::VirtualCPUOrg>(manager);
+    org_ptr->SetDataMap(data_map);
+    org_ptr->Initialize(control.GetRandom());
+  }
+  ~NopOrgSetup() { org_ptr.Delete(); }
+};
+
+/// Run a genome of nops for the given number of steps; return the organism's instruction
+/// pointer, the number of instructions executed, and the number of fast dispatch entries.
+emp::vector<size_t> RunNops(bool fast_inst_dispatch, size_t num_steps) {
+  NopOrgSetup setup(fast_inst_dispatch);
+  mabe::VirtualCPUOrg & org = *setup.org_ptr;
+  const size_t start_executed = org.num_insts_executed;
+  for (size_t step = 0; step < num_steps; ++step) org.ProcessStep();
+  size_t num_fast = 0;
+  for (const auto & entry : org.SharedData().fast_inst_table) num_fast += (entry.fun != nullptr);
+  return { org.inst_ptr, org.num_insts_executed - start_executed, num_fast };
+}
+
+TEST_CASE("VirtualCPUOrg_FastDispatch", "[orgs]"){
+  // All four instructions (three nops and IO) come from built-in modules.
+  const emp::vector<size_t> fast = RunNops(true, 73);
+  const emp::vector<size_t> slow = RunNops(false, 73);
+  CHECK(fast[2] == 4);
+  CHECK(slow[2] == 0);
+  // Both paths step through the genome identically.
+  CHECK(fast[0] == 73 % 50);
+  CHECK(fast[1] == 73);
+  CHECK(fast == emp::vector<size_t>{slow[0], slow[1], 4});
+}
+
+TEST_CASE("VirtualCPUOrg_OffspringGenome", "[orgs]"){
+  NopOrgSetup setup;
+  mabe::VirtualCPUOrg & parent = *setup.org_ptr;
+  REQUIRE(parent.GetGenomeSize() == 50);
+
+  // Divide off a shorter genome that differs from the parent's.
+  mabe::VirtualCPUOrg::genome_t & parent_buffer =
+      parent.SharedData().offspring_genome_trait(parent);
+  parent_buffer = parent.genome;
+  parent_buffer.resize(20, parent.GetDefaultInst());
+  parent_buffer[1] = parent_buffer[0];
+  emp::vector<size_t> divided;
+  for (size_t i = 0; i < parent_buffer.size(); ++i) divided.push_back(parent_buffer[i].idx);
+  REQUIRE(parent.genome[1].idx != divided[1]);
+
+  emp::Ptr<mabe::Organism> child_ptr = parent.MakeOffspringOrganism(setup.control.GetRandom());
+  auto & child = dynamic_cast<mabe::VirtualCPUOrg &>(*child_ptr);
+
+  // The child gets the divided genome...
+  REQUIRE(child.GetGenomeSize() == 20);
+  for (size_t i = 0; i < divided.size(); ++i) CHECK(child.genome[i].idx == divided[i]);
+  // ...the parent's buffer is unchanged...
+  REQUIRE(parent_buffer.size() == 20);
+  for (size_t i = 0; i < divided.size(); ++i) CHECK(parent_buffer[i].idx == divided[i]);
+  CHECK(parent.GetGenomeSize() == 50);
+  // ...and the child's own buffer starts empty.
+  CHECK(child.SharedData().offspring_genome_trait(child).size() == 0);
+
+  child_ptr.Delete();
+}
+
+TEST_CASE("VirtualCPUOrg_InstLibPerManager", "[orgs]"){
+  // Two managers take their instructions from the action maps of different populations.
+  mabe::MABE control(0, nullptr);
+  control.AddPopulation("nop_pop", 0);
+  control.AddPopulation("math_pop", 0);
+  emplode::Symbol_Scope root_scope("root_scope", "desc", nullptr);
+  mabe::VirtualCPU_Inst_Nop& nop_inst_module = 
+      GetConfiguredRef<mabe::VirtualCPU_Inst_Nop>(
+        control, "VirtualCPU_Inst_Nop", "insts_nop", root_scope); 
+  mabe::VirtualCPU_Inst_Math& math_inst_module = 
+      GetConfiguredRef<mabe::VirtualCPU_Inst_Math>(
+        control, "VirtualCPU_Inst_Math", "insts_math", root_scope); 
+  nop_inst_module.AsScope().GetSymbol("target_pop")->SetString("nop_pop");
+  math_inst_module.AsScope().GetSymbol("target_pop")->SetString("math_pop");
+  nop_inst_module.SetupModule();
+  math_inst_module.SetupModule();
+
+  mabe::OrganismManager<mabe::VirtualCPUOrg> nop_manager(control, "nop_manager", "desc");
+  mabe::OrganismManager<mabe::VirtualCPUOrg> math_manager(control, "math_manager", "desc");
+  mabe::VirtualCPUOrg nop_org(nop_manager);
+  mabe::VirtualCPUOrg math_org(math_manager);
+  nop_org.SharedData().inst_pop_id = control.GetPopID("nop_pop");
+  nop_org.SharedData().inst_set_input_filename = "inst_set_nops.txt";
+  math_org.SharedData().inst_pop_id = control.GetPopID("math_pop");
+  math_org.SharedData().inst_set_input_filename = "inst_set_math.txt";
+  // Each instruction set file only names instructions from its own population, so building
+  // either library from the wrong action map would fail.
+  nop_org.SetupInstLib();
+  math_org.SetupInstLib();
+
+  const auto LibNames = [](const mabe::VirtualCPUOrg & org){
+    emp::vector<emp::String> names;
+    for (size_t i = 0; i < org.GetInstLib().GetSize(); ++i) {
+      names.push_back(org.GetInstLib().GetName(i));
+    }
+    return names;
+  };
+  CHECK(LibNames(nop_org) == emp::vector<emp::String>{"NopA", "NopB", "NopC"});
+  CHECK(LibNames(math_org) == emp::vector<emp::String>{"Inc", "Dec", "Add", "Nand"});
+  CHECK(&nop_org.GetInstLib() != &math_org.GetInstLib());
+
+  // Organisms of each manager share only their own manager's library.
+  mabe::VirtualCPUOrg other_math_org(math_manager);
+  CHECK(&other_math_org.GetInstLib() == &math_org.GetInstLib());
+}
+
+/// Have a parent (with a known offspring merit and instruction count) reproduce with Repro,
+/// either right away or deferred as in parallel mode; return the offspring's merit.
+double ReproOffspringMerit(bool deferred) {
+  mabe::MABE control(0, nullptr);
+  control.GetRandom().ResetSeed(100);
+  emplode::Symbol_Scope root_scope("root_scope", "desc", nullptr);
+  GetConfiguredRef<mabe::VirtualCPU_Inst_Nop>(control, "VirtualCPU_Inst_Nop", "insts_nop",
+                                              root_scope);
+  auto & repl_inst_module = GetConfiguredRef<mabe::VirtualCPU_Inst_Replication>(
+      control, "VirtualCPU_Inst_Replication", "insts_repl", root_scope);
+  repl_inst_module.AsScope().GetSymbol("req_count_inst_executed")->SetValue(0);
+  repl_inst_module.AsScope().GetSymbol("pos_trait")->SetString("position");
+  GetConfiguredRef<mabe::SchedulerProbabilistic>(  // Owns the reset_self trait.
+      control, "SchedulerProbabilistic", "scheduler", root_scope);
+  auto & manager =
+      control.AddModule<mabe::OrganismManager<mabe::VirtualCPUOrg>>("vcpu_org", "desc");
+  auto & data = manager.GetManagedData();
+  data.inst_set_input_filename = "inst_set_repro.txt";
+  data.init_random = false;
+  data.initial_genome_filename = "org_nops.org";
+  data.point_mut_prob = 0.0;
+  data.insertion_mut_prob = 0.0;
+  data.deletion_mut_prob = 0.0;
+  data.copy_influences_merit = false;
+  mabe::Population & pop = control.AddPopulation("main_pop");
+  REQUIRE(control.Setup());
+
+  control.Inject(pop, "vcpu_org", 1);
+  auto & parent = dynamic_cast<mabe::VirtualCPUOrg &>(pop[0]);
+  REQUIRE(parent.GetGenomeSize() == 50);
+  data.position_trait(parent) = mabe::OrgPosition(pop, 0);
+  data.offspring_merit_trait(parent) = 7.0;
+  parent.num_insts_executed = 30;
+
+  if (deferred) {
+    mabe::DeferredActions actions;
+    actions.Start(1);
+    actions.SetOrgPos(0);
+    repl_inst_module.Inst_Repro(parent, parent.genome[0]);
+    actions.Stop();
+    CHECK(pop.GetNumOrgs() == 1);                           // Birth is deferred...
+    CHECK(data.offspring_merit_trait(parent) == 0.0);       // ...but the parent has reset.
+    for (auto & action : actions.GetActions()) action.fun(parent);
+  }
+  else repl_inst_module.Inst_Repro(parent, parent.genome[0]);
+
+  REQUIRE(pop.GetNumOrgs() == 2);
+  for (size_t pos = 0; pos < pop.GetSize(); ++pos) {
+    if (pop.IsEmpty(pos) || &pop[pos] == &parent) continue;
+    auto & offspring = dynamic_cast<mabe::VirtualCPUOrg &>(pop[pos]);
+    return data.merit_trait(offspring);
+  }
+  return -1.0;
+}
+
+TEST_CASE("VirtualCPUOrg_OffspringMerit", "[orgs]"){
+  // Offspring merit comes from the parent's state at divide time: min(50, 30) / 100 + 7.
+  const double batch_merit = ReproOffspringMerit(false);
+  CHECK(batch_merit == Approx(7.3));
+  CHECK(ReproOffspringMerit(true) == Approx(batch_merit));
+}
@@ -0,0 +1,182 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file  GridPlacement.cpp
+ *  @brief Tests for GridPlacement.hpp
+ */
+
+#include <algorithm>
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// Empirical tools
+#include "emp/base/vector.hpp"
+// MABE
+#include "placement/GridPlacement.hpp"
+// Test helpers
+#include "../SetupHelpers.hpp"
+
+/// Build a grid with the given shape and return the number of neighbors of every cell.
+struct GridSetup {
+  mabe::MABE control{0, nullptr};
+  emplode::Symbol_Scope root_scope{"root_scope", "desc", nullptr};
+  mabe::Population & pop;
+  mabe::GridPlacement & grid;
+
+  GridSetup(size_t width, size_t height, size_t depth, bool toroidal,
+            const emp::String & neighborhood)
+    : pop(control.AddPopulation("test_pop"))
+    , grid(GetConfiguredRef<mabe::GridPlacement>(control, "GridPlacement", "grid", root_scope))
+  {
+    grid.AsScope().GetSymbol("width")->SetValue((double) width);
+    grid.AsScope().GetSymbol("height")->SetValue((double) height);
+    grid.AsScope().GetSymbol("depth")->SetValue((double) depth);
+    grid.AsScope().GetSymbol("toroidal")->SetValue(toroidal ? 1.0 : 0.0);
+    grid.AsScope().GetSymbol("neighborhood")->SetString(neighborhood);
+    grid.SetupModule();
+  }
+
+  emp::vector<size_t> NeighborCounts() {
+    emp::vector<size_t> counts(pop.GetSize());
+    for (size_t cell = 0; cell < pop.GetSize(); ++cell) counts[cell] = grid.GetNumNeighbors(cell);
+    return counts;
+  }
+
+  /// Neighbors must be distinct, not include the cell itself, and be mutual.
+  void CheckNeighbors() {
+    for (size_t cell = 0; cell < pop.GetSize(); ++cell) {
+      auto neighbors = grid.GetNeighbors(cell);
+      emp::vector<uint32_t> sorted(neighbors.begin(), neighbors.end());
+      std::sort(sorted.begin(), sorted.end());
+      CHECK(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+      for (uint32_t neighbor : neighbors) {
+        REQUIRE(neighbor < pop.GetSize());
+        CHECK(neighbor != cell);
+        auto back = grid.GetNeighbors(neighbor);
+        CHECK(std::find(back.begin(), back.end(), cell) != back.end());
+      }
+    }
+  }
+};
+
+TEST_CASE("GridPlacement_Moore", "[placement]"){
+  {
+    GridSetup setup(5, 4, 1, true, "moore");
+    CHECK(setup.pop.GetSize() == 20);   // Sized during setup.
+    for (size_t count : setup.NeighborCounts()) CHECK(count == 8);
+    setup.CheckNeighbors();
+  }
+  {
+    // Bounded: corners have 3 neighbors, other edges 5, and the interior 8.
+    GridSetup setup(4, 3, 1, false, "moore");
+    CHECK(setup.NeighborCounts() == emp::vector<size_t>{3, 5, 5, 3,
+                                                        5, 8, 8, 5,
+                                                        3, 5, 5, 3});
+    setup.CheckNeighbors();
+    // Cell (1,1) is surrounded by all cells of the first three columns except itself.
+    auto neighbors = setup.grid.GetNeighbors(5);
+    emp::vector<uint32_t> sorted(neighbors.begin(), neighbors.end());
+    std::sort(sorted.begin(), sorted.end());
+    CHECK(sorted == emp::vector<uint32_t>{0, 1, 2, 4, 6, 8, 9, 10});
+  }
+  {
+    GridSetup setup(3, 3, 3, true, "moore");
+    for (size_t count : setup.NeighborCounts()) CHECK(count == 26);
+    setup.CheckNeighbors();
+  }
+  {
+    GridSetup setup(3, 3, 3, false, "moore");
+    const emp::vector<size_t> counts = setup.NeighborCounts();
+    CHECK(counts[0] == 7);    // Corner
+    CHECK(counts[1] == 11);   // Edge
+    CHECK(counts[4] == 17);   // Face
+    CHECK(counts[13] == 26);  // Center
+    setup.CheckNeighbors();
+  }
+}
+
+TEST_CASE("GridPlacement_VonNeumann", "[placement]"){
+  {
+    GridSetup setup(5, 4, 1, true, "von_neumann");
+    for (size_t count : setup.NeighborCounts()) CHECK(count == 4);
+    setup.CheckNeighbors();
+  }
+  {
+    GridSetup setup(4, 3, 1, false, "von_neumann");
+    CHECK(setup.NeighborCounts() == emp::vector<size_t>{2, 3, 3, 2,
+                                                        3, 4, 4, 3,
+                                                        2, 3, 3, 2});
+    setup.CheckNeighbors();
+  }
+  {
+    GridSetup setup(3, 3, 3, true, "von_neumann");
+    for (size_t count : setup.NeighborCounts()) CHECK(count == 6);
+    setup.CheckNeighbors();
+  }
+  {
+    GridSetup setup(3, 3, 3, false, "von_neumann");
+    const emp::vector<size_t> counts = setup.NeighborCounts();
+    CHECK(counts[0] == 3);    // Corner
+    CHECK(counts[13] == 6);   // Center
+    setup.CheckNeighbors();
+  }
+}
+
+TEST_CASE("GridPlacement_Narrow", "[placement]"){
+  // Wrapping around a 1- or 2-wide grid reaches the same cells more than once; each neighbor
+  // must be counted only once (and a cell is never its own neighbor).
+  {
+    GridSetup setup(1, 5, 1, true, "moore");
+    for (size_t count : setup.NeighborCounts()) CHECK(count == 2);
+    setup.CheckNeighbors();
+  }
+  {
+    GridSetup setup(1, 5, 1, false, "moore");
+    CHECK(setup.NeighborCounts() == emp::vector<size_t>{1, 2, 2, 2, 1});
+    setup.CheckNeighbors();
+  }
+  {
+    GridSetup setup(1, 5, 1, true, "von_neumann");
+    for (size_t count : setup.NeighborCounts()) CHECK(count == 2);
+    setup.CheckNeighbors();
+  }
+  {
+    GridSetup setup(2, 5, 1, true, "moore");
+    for (size_t count : setup.NeighborCounts()) CHECK(count == 5);
+    setup.CheckNeighbors();
+  }
+  {
+    GridSetup setup(2, 5, 1, true, "von_neumann");
+    for (size_t count : setup.NeighborCounts()) CHECK(count == 3);
+    setup.CheckNeighbors();
+  }
+  {
+    GridSetup setup(2, 2, 1, true, "moore");
+    for (size_t count : setup.NeighborCounts()) CHECK(count == 3);
+    setup.CheckNeighbors();
+  }
+  {
+    GridSetup setup(2, 2, 1, false, "von_neumann");
+    for (size_t count : setup.NeighborCounts()) CHECK(count == 2);
+    setup.CheckNeighbors();
+  }
+  {
+    GridSetup setup(1, 1, 1, true, "moore");
+    CHECK(setup.NeighborCounts() == emp::vector<size_t>{0});
+  }
+}
+
+TEST_CASE("GridPlacement_FindNeighbor", "[placement]"){
+  GridSetup setup(6, 6, 1, false, "von_neumann");
+  for (size_t cell : {0, 7, 20, 35}) {
+    auto neighbors = setup.grid.GetNeighbors(cell);
+    for (size_t i = 0; i < 20; ++i) {
+      mabe::OrgPosition pos = setup.pop.FindNeighbor(mabe::OrgPosition(setup.pop, cell));
+      REQUIRE(pos.IsValid());
+      CHECK(std::find(neighbors.begin(), neighbors.end(), pos.Pos()) != neighbors.end());
+    }
+  }
+}
@@ -1,17 +1,129 @@
 /**
  *  @note This file is part of MABE, https://github.com/mercere99/MABE2
  *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
- *  @date 2019-2021.
+ *  @date 2019-2024.
  *
  *  @file  MaxSizePlacement.cpp
- *  @brief TODO. Currently this is a placeholder so codecov will see the untested source code
+ *  @brief Tests for MaxSizePlacement.hpp
  */
 
 // CATCH
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
+// Empirical tools
+#include "emp/base/vector.hpp"
 // MABE
 #include "placement/MaxSizePlacement.hpp"
+// Test helpers
+#include "../SetupHelpers.hpp"
 
+/// Two (initially empty) populations, with the target ones managed by MaxSizePlacement.
+struct PlacementSetup {
+  mabe::MABE control{0, nullptr};
+  emplode::Symbol_Scope root_scope{"root_scope", "desc", nullptr};
+  mabe::Population & pop_a;
+  mabe::Population & pop_b;
+  mabe::MaxSizePlacement & placement;
 
-TEST_CASE("MaxSizePlacement_Placeholder", "[core]"){ ; }
+  PlacementSetup(size_t max_pop_size, const emp::String & target)
+    : pop_a(control.AddPopulation("pop_a"))
+    , pop_b(control.AddPopulation("pop_b"))
+    , placement(GetConfiguredRef<mabe::MaxSizePlacement>(
+        control, "MaxSizePlacement", "placement", root_scope))
+  {
+    control.GetRandom().ResetSeed(100);
+    placement.AsScope().GetSymbol("max_pop_size")->SetValue((double) max_pop_size);
+    placement.AsScope().GetSymbol("target")->SetString(target);
+    REQUIRE(control.Setup());
+  }
+
+  /// Place a birth with no parent in the population and return its position.
+  size_t Birth(mabe::Population & pop) {
+    mabe::OrgPosition pos = placement.PlaceBirth(mabe::OrgPosition(), pop);
+    REQUIRE(pos.IsValid());
+    return pos.Pos();
+  }
+};
+
+TEST_CASE("MaxSizePlacement_TargetSize", "[placement]"){
+  {
+    PlacementSetup setup(5, "pop_a");
+    mabe::Population & pop = setup.pop_a;
+
+    // Births add positions until the population reaches its maximum size...
+    setup.control.ResizePop(pop, 3);
+    CHECK(setup.Birth(pop) == 3);
+    CHECK(setup.Birth(pop) == 4);
+    CHECK(pop.GetSize() == 5);
+
+    // ...then replace existing organisms.
+    CHECK(setup.Birth(pop) < 5);
+    CHECK(pop.GetSize() == 5);
+    CHECK(setup.placement.PlaceInject(pop).Pos() < 5);
+    CHECK(pop.GetSize() == 5);
+
+    // Shrinking the population leaves room to grow again.
+    setup.control.ResizePop(pop, 2);
+    CHECK(setup.Birth(pop) == 2);
+    setup.control.PushEmpty(pop);
+    CHECK(pop.GetSize() == 4);
+    CHECK(setup.placement.PlaceInject(pop).Pos() == 4);
+    CHECK(setup.Birth(pop) < 5);
+    CHECK(pop.GetSize() == 5);
+
+    // Populations that aren't managed get no positions.
+    CHECK(!setup.placement.PlaceBirth(mabe::OrgPosition(), setup.pop_b).IsValid());
+    CHECK(!setup.placement.PlaceInject(setup.pop_b).IsValid());
+  }
+  {
+    // The maximum size applies to all managed populations together.
+    PlacementSetup setup(5, "pop_a,pop_b");
+    setup.control.ResizePop(setup.pop_a, 2);
+    setup.control.ResizePop(setup.pop_b, 2);
+    CHECK(setup.Birth(setup.pop_b) == 2);
+    CHECK(setup.Birth(setup.pop_a) < 2);
+    CHECK(setup.pop_a.GetSize() == 2);
+
+    setup.control.ResizePop(setup.pop_b, 0);
+    CHECK(setup.Birth(setup.pop_a) == 2);
+    CHECK(setup.Birth(setup.pop_a) == 3);
+    CHECK(setup.Birth(setup.pop_a) == 4);
+    CHECK(setup.Birth(setup.pop_a) < 5);
+    CHECK(setup.pop_a.GetSize() == 5);
+  }
+}
+
+TEST_CASE("MaxSizePlacement_ReplaceOther", "[placement]"){
+  {
+    // Once full, a birth never replaces its own parent.
+    PlacementSetup setup(4, "pop_a");
+    setup.control.ResizePop(setup.pop_a, 4);
+    for (size_t parent = 0; parent < 4; ++parent) {
+      emp::vector<size_t> hits(4, 0);
+      for (size_t i = 0; i < 200; ++i) {
+        mabe::OrgPosition pos =
+          setup.placement.PlaceBirth(mabe::OrgPosition(setup.pop_a, parent), setup.pop_a);
+        REQUIRE(pos.IsValid());
+        REQUIRE(pos.Pos() < 4);
+        hits[pos.Pos()]++;
+      }
+      for (size_t pos = 0; pos < 4; ++pos) {
+        if (pos == parent) CHECK(hits[pos] == 0);
+        else CHECK(hits[pos] > 0);
+      }
+    }
+
+    // A parent in another population doesn't rule out any position.
+    emp::vector<size_t> hits(4, 0);
+    for (size_t i = 0; i < 200; ++i) {
+      hits[setup.placement.PlaceBirth(mabe::OrgPosition(setup.pop_b, 0), setup.pop_a).Pos()]++;
+    }
+    for (size_t count : hits) CHECK(count > 0);
+  }
+  {
+    // With a single position, there is nowhere else to go.
+    PlacementSetup setup(1, "pop_a");
+    setup.control.ResizePop(setup.pop_a, 1);
+    CHECK(setup.placement.PlaceBirth(mabe::OrgPosition(setup.pop_a, 0), setup.pop_a).Pos() == 0);
+  }
+}
@@ -0,0 +1,250 @@
+/**
+ *  @note This file is part of MABE, https://github.com/mercere99/MABE2
+ *  @copyright Copyright (C) Michigan State University, MIT Software license; see doc/LICENSE.md
+ *  @date 2024.
+ *
+ *  @file SchedulerProbabilistic.cpp
+ *  @brief Tests for SchedulerProbabilistic.hpp
+ */
+
+// CATCH
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+// Empirical tools
+#include "emp/base/vector.hpp"
+// MABE
+#include "core/DeferredActions.hpp"
+#include "core/OrganismManager.hpp"
+#include "select/SchedulerProbabilistic.hpp"
+// Test helpers
+#include "../SetupHelpers.hpp"
+
+/// Organism whose steps add a random amount to its merit and periodically ask to reproduce.
+class StepOrg : public mabe::OrganismTemplate<StepOrg> {
+public:
+  size_t num_steps = 0;
+
+  StepOrg(mabe::OrganismManager<StepOrg> & manager)
+    : mabe::OrganismTemplate<StepOrg>(manager) { }
+
+  struct ManagerData : public mabe::Organism::ManagerData {
+    emp::Ptr<mabe::MABE> control = nullptr;
+  };
+
+  size_t Mutate(emp::Random &) override { return 0; }
+  void Initialize(emp::Random &) override { }
+
+  void SetupModule() override {
+    GetManager().AddSharedTrait<double>("merit", "Merit for scheduling", 0.0);
+  }
+
+  /// Replicate the organism (which must be in the first population).
+  static void Replicate(mabe::MABE & control, mabe::Organism & parent) {
+    mabe::Population & pop = control.GetPopulation(0);
+    for (size_t pos = 0; pos < pop.GetSize(); ++pos) {
+      if (&pop[pos] == &parent) {
+        control.Replicate(mabe::OrgPosition(pop, pos), pop);
+        return;
+      }
+    }
+  }
+
+  bool ProcessStep() override {
+    mabe::MABE & control = *SharedData().control;
+    GetTrait<double>("merit") += mabe::DeferredActions::GetRandom(control.GetRandom()).GetDouble();
+    if (++num_steps % 8 == 0) {
+      emp::Ptr<mabe::DeferredActions> deferred = mabe::DeferredActions::GetActive();
+      if (deferred) deferred->Add([&control](mabe::Organism & parent){ Replicate(control, parent); });
+      else Replicate(control, *this);
+    }
+    return true;
+  }
+};
+
+/// Organism that counts its steps and gains a fixed amount of merit with each one.
+class CountOrg : public mabe::OrganismTemplate<CountOrg> {
+public:
+  size_t num_steps = 0;
+
+  CountOrg(mabe::OrganismManager<CountOrg> & manager)
+    : mabe::OrganismTemplate<CountOrg>(manager) { }
+
+  struct ManagerData : public mabe::Organism::ManagerData {
+    emp::vector<double> init_merits;  ///< Merits given to new organisms, in turn.
+    size_t num_made = 0;              ///< Organisms initialized so far.
+    double step_merit = 0.0;          ///< Merit gained with each step.
+  };
+
+  size_t Mutate(emp::Random &) override { return 0; }
+
+  void Initialize(emp::Random &) override {
+    auto & data = SharedData();
+    if (data.init_merits.size() == 0) return;
+    GetTrait<double>("merit") = data.init_merits[data.num_made++ % data.init_merits.size()];
+  }
+
+  void SetupModule() override {
+    GetManager().AddSharedTrait<double>("merit", "Merit for scheduling", 0.0);
+  }
+
+  bool ProcessStep() override {
+    ++num_steps;
+    GetTrait<double>("merit") += SharedData().step_merit;
+    return true;
+  }
+};
+
+/// A scheduler running a single population of CountOrgs.  Adjust the configuration, then
+/// call Start() to run setup and inject the organisms.
+struct CountSetup {
+  mabe::MABE control{0, nullptr};
+  emplode::Symbol_Scope root_scope{"root_scope", "desc", nullptr};
+  mabe::SchedulerProbabilistic & scheduler;
+  mabe::OrganismManager<CountOrg> & manager;
+  mabe::Population & pop;
+
+  CountSetup(const emp::String & mode)
+    : scheduler(GetConfiguredRef<mabe::SchedulerProbabilistic>(
+        control, "SchedulerProbabilistic", "scheduler", root_scope))
+    , manager(control.AddModule<mabe::OrganismManager<CountOrg>>("count_org", "desc"))
+    , pop(control.AddPopulation("main_pop"))
+  {
+    control.GetRandom().ResetSeed(100);
+    scheduler.AsScope().GetSymbol("mode")->SetString(mode);
+  }
+
+  void Set(const emp::String & var_name, double value) {
+    scheduler.AsScope().GetSymbol(var_name)->SetValue(value);
+  }
+
+  void Start(size_t num_orgs) {
+    REQUIRE(control.Setup());
+    control.Inject(pop, "count_org", num_orgs);
+  }
+
+  double Weight(size_t pos) const { return scheduler.GetWeightMap().GetWeight(pos); }
+  double TotalWeight() const { return scheduler.GetWeightMap().GetWeight(); }
+  size_t NumSteps(size_t pos) { return dynamic_cast<CountOrg &>(pop[pos]).num_steps; }
+  double Merit(size_t pos) { return pop[pos].GetTrait<double>("merit"); }
+};
+
+/// Run a population of StepOrgs under the scheduler in parallel mode; return the steps and
+/// merit of every organism at the end.
+emp::vector<double> RunParallel(size_t num_threads, size_t batch_block) {
+  mabe::MABE control(0, nullptr);
+  control.GetRandom().ResetSeed(100);
+  emplode::Symbol_Scope root_scope("root_scope", "desc", nullptr);
+  auto & scheduler = GetConfiguredRef<mabe::SchedulerProbabilistic>(
+      control, "SchedulerProbabilistic", "scheduler", root_scope);
+  scheduler.AsScope().GetSymbol("mode")->SetString("parallel");
+  scheduler.AsScope().GetSymbol("num_threads")->SetValue((double) num_threads);
+  scheduler.AsScope().GetSymbol("batch_block")->SetValue((double) batch_block);
+  scheduler.AsScope().GetSymbol("avg_updates")->SetValue(5);
+  auto & manager = control.AddModule<mabe::OrganismManager<StepOrg>>("step_org", "desc");
+  manager.GetManagedData().control = &control;
+  mabe::Population & pop = control.AddPopulation("main_pop");
+  REQUIRE(control.Setup());
+
+  control.Inject(pop, "step_org", 10);
+  for (size_t round = 0; round < 4; ++round) scheduler.Schedule();
+
+  emp::vector<double> results;
+  for (size_t pos = 0; pos < pop.GetSize(); ++pos) {
+    if (pop.IsEmpty(pos)) { results.push_back(-1.0); continue; }
+    auto & org = dynamic_cast<StepOrg &>(pop[pos]);
+    results.push_back((double) org.num_steps);
+    results.push_back(org.GetTrait<double>("merit"));
+  }
+  return results;
+}
+
+TEST_CASE("SchedulerProbabilistic_ParallelThreadCount", "[select]"){
+  for (size_t batch_block : {1, 4, 16}) {
+    const emp::vector<double> one_thread = RunParallel(1, batch_block);
+    CHECK(one_thread.size() > 20);   // Organisms reproduced.
+    CHECK(RunParallel(2, batch_block) == one_thread);
+    CHECK(RunParallel(3, batch_block) == one_thread);
+    CHECK(RunParallel(8, batch_block) == one_thread);
+  }
+}
+
+TEST_CASE("SchedulerProbabilistic_Weights", "[select]"){
+  CountSetup setup("single");
+  setup.Set("avg_updates", 5);
+  setup.manager.GetManagedData().init_merits = {0.0, 1.0, 2.0, 3.0};
+  setup.Start(4);
+  REQUIRE(setup.scheduler.GetWeightMap().GetSize() == 4);
+  for (size_t pos = 0; pos < 4; ++pos) CHECK(setup.Weight(pos) == 1.0 + pos);
+
+  // Merit gained while running is picked up after each step.
+  setup.manager.GetManagedData().step_merit = 0.5;
+  setup.scheduler.Schedule();
+  for (size_t pos = 0; pos < 4; ++pos) {
+    CHECK(setup.Merit(pos) == 0.5 * setup.NumSteps(pos) + pos);
+    CHECK(setup.Weight(pos) == 1.0 + setup.Merit(pos));
+  }
+  const double weight0 = setup.Weight(0);
+  const double weight1 = setup.Weight(1);
+  const double weight3 = setup.Weight(3);
+
+  // A dead organism is no longer scheduled.
+  setup.control.ClearOrgAt(mabe::OrgPosition(setup.pop, 2));
+  CHECK(setup.Weight(2) == 0.0);
+  CHECK(setup.TotalWeight() == Approx(weight0 + weight1 + weight3));
+
+  // Weights move with their organisms, including into empty positions.
+  setup.control.SwapOrgs(mabe::OrgPosition(setup.pop, 1), mabe::OrgPosition(setup.pop, 3));
+  CHECK(setup.Weight(1) == weight3);
+  CHECK(setup.Weight(3) == weight1);
+  setup.control.SwapOrgs(mabe::OrgPosition(setup.pop, 0), mabe::OrgPosition(setup.pop, 2));
+  CHECK(setup.Weight(0) == 0.0);
+  CHECK(setup.Weight(2) == weight0);
+  CHECK(setup.TotalWeight() == Approx(weight0 + weight1 + weight3));
+
+  // New positions start with no weight; removed positions take theirs with them.
+  setup.control.PushEmpty(setup.pop);
+  REQUIRE(setup.scheduler.GetWeightMap().GetSize() == 5);
+  CHECK(setup.Weight(4) == 0.0);
+  setup.control.ResizePop(setup.pop, 7);
+  REQUIRE(setup.scheduler.GetWeightMap().GetSize() == 7);
+  CHECK(setup.Weight(5) == 0.0);
+  CHECK(setup.Weight(6) == 0.0);
+  CHECK(setup.TotalWeight() == Approx(weight0 + weight1 + weight3));
+  setup.control.ResizePop(setup.pop, 2);
+  REQUIRE(setup.scheduler.GetWeightMap().GetSize() == 2);
+  CHECK(setup.TotalWeight() == Approx(weight3));
+}
+
+TEST_CASE("SchedulerProbabilistic_Batch", "[select]"){
+  {
+    // Each round runs exactly ceil(N * avg_updates) steps.
+    CountSetup setup("batch");
+    setup.Set("avg_updates", 2.5);
+    setup.Set("batch_block", 3);
+    setup.manager.GetManagedData().init_merits = {0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    setup.Start(7);
+    for (size_t round = 1; round <= 3; ++round) {
+      setup.scheduler.Schedule();
+      size_t total_steps = 0;
+      for (size_t pos = 0; pos < 7; ++pos) total_steps += setup.NumSteps(pos);
+      CHECK(total_steps == 18 * round);
+    }
+  }
+  {
+    // Steps only go to positions with weight, in proportion to that weight.
+    CountSetup setup("batch");
+    setup.Set("avg_updates", 1000);
+    setup.Set("base_value", 0);
+    setup.manager.GetManagedData().init_merits = {0.0, 1.0, 0.0, 2.0, 0.0, 3.0, 0.0, 4.0};
+    setup.Start(8);
+    setup.scheduler.Schedule();
+    size_t total_steps = 0;
+    for (size_t pos = 0; pos < 8; ++pos) {
+      const size_t num_steps = setup.NumSteps(pos);
+      total_steps += num_steps;
+      if (setup.Merit(pos) == 0.0) CHECK(num_steps == 0);
+      else CHECK(num_steps / 8000.0 == Approx(setup.Merit(pos) / 10.0).margin(0.02));
+    }
+    CHECK(total_steps == 8000);
+  }
+}